@@ -28,6 +28,7 @@
 #include "avida/systematics/Group.h"
 
 class cAvidaContext;
+class cTestCPU;
 class cWorld;
 
 
@@ -51,6 +52,7 @@ namespace Avida {
     
     class GenomeTestMetrics : public GroupData
     {
+      friend class GenomeTestQueue;
     public:
       static const Apto::String ObjectKey;
       
@@ -65,7 +67,7 @@ namespace Avida {
       Apto::Array<int> m_task_counts;
       
       
-      LIB_EXPORT GenomeTestMetrics(cWorld* world, cAvidaContext& ctx, GroupPtr bg);
+      LIB_EXPORT GenomeTestMetrics(cAvidaContext& ctx, cTestCPU* testcpu, const Genome& genome);
       
     public:
       LIB_EXPORT ~GenomeTestMetrics();
@@ -0,0 +1,109 @@
+/*
+ *  private/systematics/GenomeTestQueue.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaSystematicsGenomeTestQueue_h
+#define AvidaSystematicsGenomeTestQueue_h
+
+#include "apto/platform.h"
+#include "apto/rng.h"
+#include "avida/core/Genome.h"
+#include "avida/systematics/Listener.h"
+#include "avida/private/systematics/GenomeTestMetrics.h"
+
+class cAvidaContext;
+class cTestCPU;
+class cWorld;
+
+
+namespace Avida {
+  namespace Systematics {
+    
+    // GenomeTestQueue
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Listens to the genotype arbiter and evaluates each genotype that becomes a threshold genotype on a pool of worker
+    // threads, each with its own test CPU.  Results are attached to their genotypes on the simulation thread, either
+    // when the queue is next notified or when GenomeTestMetrics::GetMetrics() claims them.  Every group touched here
+    // (and every attach) stays on the simulation thread; workers only see the copied genome, and read a snapshot of the
+    // world's stats in place of the live ones.  Every evaluation, on a worker or not, runs on its own context seeded
+    // from the queue's generator in the order genotypes were submitted, never on the world's context.
+    
+    class GenomeTestQueue : public Listener
+    {
+    private:
+      class Worker;
+      
+      struct Job
+      {
+        GroupPtr group;
+        Genome genome;
+        int seed;
+        int update;                   // Update at submission, as seen by the test CPU
+        bool started;
+        GenomeTestMetrics* result;    // Set by the worker that ran the job
+        
+        Job(GroupPtr g, const Genome& in_genome, int in_seed, int in_update)
+          : group(g), genome(in_genome), seed(in_seed), update(in_update), started(false), result(NULL) { ; }
+      };
+      
+      cWorld* m_world;
+      Apto::RNG::AvidaRNG m_seed_rng;         // Draws a seed per job, in threshold order
+      
+      Apto::Mutex m_mutex;
+      Apto::ConditionVariable m_job_cond;     // Jobs are waiting, or the queue is stopping
+      Apto::ConditionVariable m_done_cond;    // A job has finished
+      Apto::Map<GroupID, Job*> m_jobs;        // Every job not yet attached to its genotype
+      Apto::Array<GroupID> m_waiting;         // Genotypes waiting for a worker, in threshold order
+      int m_next_waiting;
+      Apto::Array<GroupID> m_finished;        // Genotypes evaluated but not yet attached
+      bool m_stopping;
+      
+      Apto::Array<Worker*> m_workers;
+      
+      
+      GenomeTestQueue(); // @not_implemented
+      GenomeTestQueue(const GenomeTestQueue&); // @not_implemented
+      GenomeTestQueue& operator=(const GenomeTestQueue&); // @not_implemented
+      
+    public:
+      LIB_EXPORT GenomeTestQueue(cWorld* world, int num_workers);
+      LIB_EXPORT ~GenomeTestQueue();
+      
+      // Listener
+      LIB_EXPORT void Notify(GroupPtr g, EventType t, UnitPtr u);
+      
+      // Attach the metrics of every finished evaluation to its genotype
+      LIB_EXPORT void Collect();
+      
+      // Metrics for a genotype, waiting on its worker if it is running.  A genotype that no worker has started is dropped
+      // from the queue and evaluated here with the seed it was queued with; one that was never queued draws its seed now.
+      LIB_EXPORT GenomeTestMetricsPtr Claim(GroupPtr g);
+      
+    private:
+      static GenomeTestMetrics* evaluate(cAvidaContext& ctx, cTestCPU* testcpu, const Genome& genome);
+      GenomeTestMetrics* evaluate(int seed, const Genome& genome);
+      Job* nextJob();
+    };
+    
+  };
+};
+
+#endif
@@ -26,6 +26,7 @@
 #define InstructionSequence_h
 
 #include <cassert>
+#include <stdint.h>
 
 #include "apto/platform.h"
 #include "avida/core/GeneticRepresentation.h"
@@ -100,6 +101,8 @@ namespace Avida {
     LIB_EXPORT virtual void Insert(int pos, const Instruction& inst);
     LIB_EXPORT virtual void Insert(int pos, const InstructionSequence& genome);
     LIB_EXPORT virtual void Remove(int pos, int num_sites = 1);
+    LIB_EXPORT virtual void InsertSorted(const Apto::Array<int>& positions, const Apto::Array<Instruction>& insts);
+    LIB_EXPORT virtual void RemoveSorted(const Apto::Array<int>& positions);
     LIB_EXPORT virtual void Replace(int pos, int num_sites, const InstructionSequence& seq);
     LIB_EXPORT virtual void Replace(const InstructionSequence& g, int begin, int end);
     LIB_EXPORT virtual void Rotate(int n);
@@ -110,7 +113,7 @@ namespace Avida {
 
     // Operators
     LIB_EXPORT virtual void operator=(const InstructionSequence& other_seq);
-    LIB_EXPORT virtual bool operator<(const InstructionSequence& other_seq) const { return AsString() < other_seq.AsString(); }
+    LIB_EXPORT virtual bool operator<(const InstructionSequence& other_seq) const;
 
     
     // Utility Methods
@@ -130,6 +133,14 @@ namespace Avida {
     LIB_EXPORT static InstructionSequence Join(const InstructionSequence& lhs, const InstructionSequence& rhs);
 
     
+    // Fast Comparison Methods
+    LIB_EXPORT uint64_t Hash() const;
+    LIB_EXPORT static int CommonPrefixLength(const InstructionSequence& seq1, const InstructionSequence& seq2);
+    LIB_EXPORT static int CommonSuffixLength(const InstructionSequence& seq1, const InstructionSequence& seq2);
+    LIB_EXPORT static int CountMismatches(const InstructionSequence& seq1, int start1,
+                                          const InstructionSequence& seq2, int start2, int length);
+    
+    
     // Genetic Distance Methods
     static int FindOverlap(const InstructionSequence& seq1, const InstructionSequence& seq2, int offset = 0);
     static int FindHammingDistance(const InstructionSequence& seq1, const InstructionSequence& seq2, int offset = 0);
@@ -139,6 +150,8 @@ namespace Avida {
     
     
   protected:
+    LIB_EXPORT inline const unsigned char* rawSites() const { return reinterpret_cast<const unsigned char*>(&m_seq[0]); }
+    
     LIB_EXPORT virtual void adjustCapacity(int new_size);
     LIB_EXPORT virtual void prepareInsert(int pos, int num_sites);
   };
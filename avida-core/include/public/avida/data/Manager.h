@@ -43,6 +43,80 @@ namespace Avida {
       typedef Apto::Set<Apto::String, Apto::DefaultHashBTree, Apto::Multi> ArgMultiSet;
       typedef Apto::SmartPtr<ArgMultiSet> ArgMultiSetPtr;
       
+      // Requested data ids are interned as compact integer handles when a recorder attaches.  Argumented ids are split
+      // into raw id and argument at that time, and the provider that serves each handle is recorded with it.  The
+      // handles are rebuilt from the remaining recorders whenever one detaches.
+      typedef int DataHandle;
+      
+      struct HandleEntry
+      {
+        DataID data_id;
+        ProviderPtr provider;
+        ArgumentedProviderPtr arg_provider;
+        DataID raw_id;
+        Argument argument;
+      };
+      
+      // The index is never modified once published; interning new ids replaces it with an extended copy, so that a
+      // notification pass can keep reading the index it started with while other recorders attach or detach.
+      // Each recorder's handles are listed in the order of its RequestedData(), for indexed notification.
+      struct HandleIndex
+      {
+        Apto::Map<DataID, DataHandle> handles;
+        Apto::Array<HandleEntry> entries;
+        Apto::Map<RecorderPtr, int> recorder_slots;
+        Apto::Array<Apto::Array<DataHandle> > recorder_handles;
+      };
+      typedef Apto::SmartPtr<HandleIndex, Apto::ThreadSafeRefCount> HandleIndexPtr;
+      
+      // Values of the interned ids for one update.  Each value is only computed the first time it is asked for, and then
+      // kept for every other recorder.  Before the table is handed to the notification thread, the values its recorders
+      // need are captured and the table is sealed; a sealed table only serves values already captured.
+      class ValueTable
+      {
+      private:
+        const Manager* m_manager;
+        HandleIndexPtr m_index;
+        mutable Apto::Array<PackagePtr> m_values;
+        mutable Apto::Array<bool> m_captured;
+        bool m_sealed;
+        
+        void capture(DataHandle handle) const;
+        
+      public:
+        ValueTable(const Manager* manager, HandleIndexPtr index);
+        
+        PackagePtr GetValue(const DataID& data_id) const;
+        PackagePtr GetSnapshotValue(const DataID& data_id) const;
+        
+        inline PackagePtr GetHandleValue(DataHandle handle) const
+        {
+          if (handle < 0) return PackagePtr();
+          if (!m_captured[handle] && !m_sealed) capture(handle);
+          return m_values[handle];
+        }
+        const Apto::Array<DataHandle>* RecorderHandles(RecorderPtr recorder) const;
+        
+        void CaptureRecorderValues(RecorderPtr recorder);
+        void Seal() { m_sealed = true; }
+      };
+      typedef Apto::SmartPtr<ValueTable, Apto::ThreadSafeRefCount> ValueTablePtr;
+      
+      // One recorder's view of a value table, indexed by position in its requested data
+      class IndexedValues
+      {
+      private:
+        const ValueTable& m_table;
+        const Apto::Array<DataHandle>& m_handles;
+        
+      public:
+        IndexedValues(const ValueTable& table, const Apto::Array<DataHandle>& handles) : m_table(table), m_handles(handles) { ; }
+        
+        PackagePtr GetValue(int idx) const { return m_table.GetHandleValue(m_handles[idx]); }
+      };
+      
+      class NotificationThread;
+      
     private:
       World* m_world;
       
@@ -61,8 +135,18 @@ namespace Avida {
       Apto::Map<DataID, ArgumentedProviderPtr> m_active_arg_provider_map;
       Apto::Map<DataID, ArgMultiSetPtr> m_active_args;
       
-      mutable Apto::Mutex m_current_value_mutex;
-      mutable Apto::Map<DataID, PackagePtr> m_current_values;
+      HandleIndexPtr m_handle_index;
+      
+      // Recorders that support it are notified on a background thread.  The simulation hands over one update's value
+      // table at a time, so it only waits if the thread is still busy with the update before last.
+      NotificationThread* m_notify_thread;
+      Apto::Mutex m_notify_mutex;
+      Apto::ConditionVariable m_notify_cond;
+      ValueTablePtr m_notify_pending;
+      Update m_notify_pending_update;
+      Apto::Array<RecorderPtr> m_notify_pending_recorders;
+      bool m_notify_busy;
+      bool m_notify_stop;
       
       static bool s_registered_with_facet_factory;
       
@@ -79,6 +163,14 @@ namespace Avida {
       LIB_EXPORT bool AttachRecorder(RecorderPtr recorder, bool concurrent_update = false);
       LIB_EXPORT bool DetachRecorder(RecorderPtr recorder);
       
+      LIB_EXPORT void SetConcurrentNotification(bool enabled);
+      LIB_EXPORT bool IsConcurrentNotification() const { return (m_notify_thread != NULL); }
+      LIB_EXPORT void FlushNotifications();  // Must not be called from within a recorder's NotifyData
+      
+      // Drops every reference held to active providers, so that a world can destroy the objects providing its data
+      // (and the storage they were allocated from) before the manager itself goes away
+      LIB_EXPORT void ReleaseProviders();
+      
       LIB_EXPORT bool Register(const DataID& data_id, ProviderActivateFunctor functor);
       LIB_EXPORT bool Register(const DataID& data_id, ArgumentedProviderActivateFunctor functor);
       
@@ -95,6 +187,12 @@ namespace Avida {
       
     public:
       LIB_LOCAL PackagePtr GetCurrentValue(const DataID& data_id) const;
+      
+    private:
+      LIB_LOCAL void internRequestedData(HandleIndex& index, RecorderPtr recorder);
+      LIB_LOCAL static void notifyRecorder(RecorderPtr recorder, Update update, const ValueTable& values,
+                                           DataRetrievalFunctor retrieve_data);
+      LIB_LOCAL void stopNotificationThread();
     };
     
   };
@@ -44,6 +44,14 @@ namespace Avida {
       LIB_EXPORT virtual ConstDataSetPtr RequestedData() const = 0;
       
       LIB_EXPORT virtual void NotifyData(Update current_update, DataRetrievalFunctor retrieve_data) = 0; 
+      
+      // Recorders that return true may be notified on a data manager thread, concurrently with the next update
+      LIB_EXPORT virtual bool SupportsConcurrentNotification() const;
+      
+      // Recorders that return true are notified through NotifyIndexedData instead of NotifyData.  Values are retrieved
+      // by the position of their data id in RequestedData() iteration order, so no id needs to be looked up.
+      LIB_EXPORT virtual bool SupportsIndexedNotification() const;
+      LIB_EXPORT virtual void NotifyIndexedData(Update current_update, IndexedDataRetrievalFunctor retrieve_data);
     };
     
   };
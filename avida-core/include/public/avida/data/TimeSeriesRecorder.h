@@ -26,6 +26,7 @@
 #define AvidaDataTimeSeriesRecorder_h
 
 #include "apto/core/Array.h"
+#include "apto/core/Mutex.h"
 #include "avida/core/Types.h"
 #include "avida/data/Recorder.h"
 
@@ -38,12 +39,31 @@ namespace Avida {
     
     template <class T> class TimeSeriesRecorder : public Recorder
     {
+    public:
+      // Downsampled points beyond the retention horizon are replaced by one point per group, holding either the first
+      // value of the group or (for int and double series) its min, max or mean
+      enum RollupMode { ROLLUP_SAMPLE, ROLLUP_MIN, ROLLUP_MAX, ROLLUP_MEAN };
+      
     private:
+      static const int CHUNK_SHIFT = 10;
+      static const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+      static const int CHUNK_MASK = CHUNK_SIZE - 1;
+      
       DataID m_data_id;
       ConstDataSetPtr m_requested;
       
-      struct DataEntry;
-      Apto::Array<DataEntry, Apto::Smart> m_data;
+      // Points are stored columnar (update column, value column) in fixed size chunks, so growth never copies history.
+      // NotifyData may run on the data manager's notification thread, so the points are only touched under m_mutex.
+      struct Chunk;
+      typedef Apto::SmartPtr<Chunk> ChunkPtr;
+      mutable Apto::Mutex m_mutex;
+      Apto::Array<ChunkPtr> m_chunks;
+      int m_num_points;
+      
+      Update m_retain_horizon;  // Points older than this many updates are downsampled (-1 = keep everything)
+      int m_retain_every;
+      RollupMode m_rollup;
+      int m_thinned_points;     // Points [0, m_thinned_points) have already been downsampled
       
     public:
       LIB_EXPORT TimeSeriesRecorder(const DataID& data_id);
@@ -52,32 +72,64 @@ namespace Avida {
       // Data::Recorder Interface
       LIB_EXPORT inline ConstDataSetPtr RequestedData() const { return m_requested; }
       LIB_EXPORT void NotifyData(Update current_update, DataRetrievalFunctor retrieve_data);
+      LIB_EXPORT inline bool SupportsConcurrentNotification() const { return true; }
+      LIB_EXPORT inline bool SupportsIndexedNotification() const { return true; }
+      LIB_EXPORT void NotifyIndexedData(Update current_update, IndexedDataRetrievalFunctor retrieve_data);
+      
+      // Retention - downsampling runs under the same lock as the readers, but it moves and drops points, so point
+      // indices from an earlier call may no longer be valid.  Use CopyPoints() for a consistent view of the series.
+      LIB_EXPORT void SetRetention(Update horizon, int keep_every, RollupMode rollup = ROLLUP_SAMPLE);
       
       // Value Access
       LIB_EXPORT inline const DataID& RecordedDataID() const { return m_data_id; }
       
-      LIB_EXPORT inline int NumPoints() const { return m_data.GetSize(); }
-      LIB_EXPORT inline T DataPoint(int idx) const { return m_data[idx].data; }
-      LIB_EXPORT inline Update DataTime(int idx) const { return m_data[idx].update; }
+      LIB_EXPORT inline int NumPoints() const { Apto::MutexAutoLock lock(m_mutex); return m_num_points; }
+      LIB_EXPORT inline T DataPoint(int idx) const { Apto::MutexAutoLock lock(m_mutex); return pointValue(idx); }
+      LIB_EXPORT inline Update DataTime(int idx) const { Apto::MutexAutoLock lock(m_mutex); return pointTime(idx); }
+      LIB_EXPORT void CopyPoints(Apto::Array<Update>& updates, Apto::Array<T>& values) const;
+      
+      // Range Queries - point indices, found by binary search on the update column
+      LIB_EXPORT int FirstPointAtOrAfter(Update update) const;  // NumPoints() if there is none
+      LIB_EXPORT void PointRange(Update first, Update last, int& begin_idx, int& end_idx) const;  // [begin_idx, end_idx)
       
       LIB_EXPORT Apto::String AsString() const;
       
+      // Compact export: point count (int), the update column, then the value column.  Values are written in native
+      // byte order, strings (and packages, by string value) as a length (int) followed by their characters.
+      LIB_EXPORT void ExportBinary(Apto::Array<unsigned char, Apto::Smart>& buffer) const;
+      
     protected:
       LIB_EXPORT virtual bool shouldRecordValue(Update update) = 0;
       LIB_EXPORT virtual void didRecordValue() { ; }
       
       
     private:
-      struct DataEntry
+      struct Chunk
       {
-        T data;
-        Update update;
-        
-        LIB_LOCAL inline DataEntry() : update(-1) { ; }
-        LIB_LOCAL inline DataEntry(Update in_update, const T& in_data) : data(in_data), update(in_update) { ; }
+        Update updates[CHUNK_SIZE];
+        T values[CHUNK_SIZE];
       };
+      
+      LIB_LOCAL static T valueFromString(const Apto::String& str);
+      LIB_LOCAL static T valueFromPackage(PackagePtr value);
+      LIB_LOCAL static void appendValue(Apto::Array<unsigned char, Apto::Smart>& buffer, const T& value);
+      
+      // Callers of the following must hold m_mutex (or be constructing the recorder)
+      LIB_LOCAL void pushPoint(Update update, const T& value);
+      LIB_LOCAL inline void setPoint(int idx, Update update, const T& value);
+      LIB_LOCAL inline T pointValue(int idx) const { return m_chunks[idx >> CHUNK_SHIFT]->values[idx & CHUNK_MASK]; }
+      LIB_LOCAL inline Update pointTime(int idx) const { return m_chunks[idx >> CHUNK_SHIFT]->updates[idx & CHUNK_MASK]; }
+      LIB_LOCAL int firstPointAtOrAfter(Update update) const;
+      LIB_LOCAL void applyRetention();
     };
     
+    template <class T> inline void TimeSeriesRecorder<T>::setPoint(int idx, Update update, const T& value)
+    {
+      Chunk& chunk = *m_chunks[idx >> CHUNK_SHIFT];
+      chunk.updates[idx & CHUNK_MASK] = update;
+      chunk.values[idx & CHUNK_MASK] = value;
+    }
+    
   };
 };
 
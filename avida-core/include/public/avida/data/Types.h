@@ -65,6 +65,7 @@ namespace Avida {
     typedef Apto::SmartPtr<const Package, Apto::InternalRCObject> ConstPackagePtr;
     
     typedef Apto::Functor<PackagePtr, Apto::TL::Create<const DataID&>, SmallObjectMalloc> DataRetrievalFunctor;
+    typedef Apto::Functor<PackagePtr, Apto::TL::Create<int>, SmallObjectMalloc> IndexedDataRetrievalFunctor;
     
     typedef Apto::SmartPtr<Manager, Apto::InternalRCObject> ManagerPtr;
   };
@@ -87,7 +87,7 @@ namespace Avida {
       LIB_EXPORT ClassificationInfo(World* in_world, const Systematics::RoleID& role, int total_colors, int threshold_colors = -1);
       LIB_EXPORT ~ClassificationInfo() { ; }
       
-      LIB_EXPORT void Update();      
+      LIB_EXPORT bool Update();  // Returns true if any group's color assignment changed
       
       LIB_EXPORT static MapColorPtr MapColorOf(Systematics::GroupPtr bg);
     };
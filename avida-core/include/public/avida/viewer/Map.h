@@ -88,6 +88,7 @@ namespace Avida {
       virtual Apto::String GetProperty(const Apto::String& property) const = 0;
       
       virtual void Update(cPopulation& pop) = 0;
+      virtual void UpdateCells(cPopulation& pop, const Apto::Array<int>& changed_cells) { (void)changed_cells; Update(pop); }
     };
     
     
@@ -97,16 +98,47 @@ namespace Avida {
     class Map
     {
     protected:
+      // Published copy of a mode's grid and scale, read by the UI while the mode itself is recomputed
+      class Snapshot : public DiscreteScale
+      {
+      public:
+        Apto::Array<int> grid;
+        Apto::Array<int> counts;
+        Apto::String label;
+        Apto::Array<Entry> entries;
+        int range;
+        bool categorical;
+        
+        Snapshot() : range(0), categorical(false) { ; }
+        
+        void Capture(const MapMode& mode);
+        
+        int GetScaleRange() const { return range; }
+        int GetNumLabeledEntries() const { return entries.GetSize(); }
+        Entry GetEntry(int index) const { return entries[index]; }
+        bool IsCategorical() const { return categorical; }
+      };
+      
+    protected:
+      cWorld* m_world;
       int m_width;
       int m_height;
       int m_num_viewer_colors;
       
+      cPopulation* m_idle_pop;   // Set while the driver is paused, allowing newly bound modes to be filled immediately
+      
       Apto::Array<MapMode*> m_view_modes;  // List of view modes...
+      Apto::Array<bool> m_mode_stale;      // Modes that missed cell changes while unbound and need a full update
       int m_color_mode;      // Current map color mode (index into m_view_modes, -1 = off)
       int m_symbol_mode;     // Current map symbol mode (index into m_view_modes, -1 = off)
       int m_tag_mode;        // Current map tag mode (index into m_view_modes, -1 = off)
       
-      Apto::RWLock m_rw_lock;
+      Snapshot m_colors;
+      Snapshot m_symbols;
+      Snapshot m_tags;
+      
+      Apto::Mutex m_update_mutex;  // Serializes mode recomputation with mode and property changes
+      Apto::RWLock m_rw_lock;      // Guards the published snapshots
       
       
     public:
@@ -123,21 +155,21 @@ namespace Avida {
       inline int GetTagMode() const { return m_tag_mode; }
       
       
-      inline const Apto::Array<int>& GetColors() const { return m_view_modes[m_color_mode]->GetGridValues(); }
-      inline const Apto::Array<int>& GetSymbols() const { return m_view_modes[m_symbol_mode]->GetGridValues(); }
-      inline const Apto::Array<int>& GetTags() const { return m_view_modes[m_tag_mode]->GetGridValues(); }
+      inline const Apto::Array<int>& GetColors() const { return m_colors.grid; }
+      inline const Apto::Array<int>& GetSymbols() const { return m_symbols.grid; }
+      inline const Apto::Array<int>& GetTags() const { return m_tags.grid; }
       
-      inline const Apto::Array<int>& GetColorCounts() const { return m_view_modes[m_color_mode]->GetValueCounts(); }
-      inline const Apto::Array<int>& GetSymbolCounts() const { return m_view_modes[m_symbol_mode]->GetValueCounts(); }
-      inline const Apto::Array<int>& GetTagCounts() const { return m_view_modes[m_tag_mode]->GetValueCounts(); }
+      inline const Apto::Array<int>& GetColorCounts() const { return m_colors.counts; }
+      inline const Apto::Array<int>& GetSymbolCounts() const { return m_symbols.counts; }
+      inline const Apto::Array<int>& GetTagCounts() const { return m_tags.counts; }
       
-      inline const DiscreteScale& GetColorScale() const { return m_view_modes[m_color_mode]->GetScale(); }
-      inline const DiscreteScale& GetSymbolScale() const { return m_view_modes[m_symbol_mode]->GetScale(); }
-      inline const DiscreteScale& GetTagScale() const { return m_view_modes[m_tag_mode]->GetScale(); }
+      inline const DiscreteScale& GetColorScale() const { return m_colors; }
+      inline const DiscreteScale& GetSymbolScale() const { return m_symbols; }
+      inline const DiscreteScale& GetTagScale() const { return m_tags; }
       
-      inline const Apto::String& GetColorScaleLabel() const { return m_view_modes[m_color_mode]->GetScaleLabel(); }
-      inline const Apto::String& GetSymbolScaleLabel() const { return m_view_modes[m_symbol_mode]->GetScaleLabel(); }
-      inline const Apto::String& GetTagScaleLabel() const { return m_view_modes[m_tag_mode]->GetScaleLabel(); }
+      inline const Apto::String& GetColorScaleLabel() const { return m_colors.label; }
+      inline const Apto::String& GetSymbolScaleLabel() const { return m_symbols.label; }
+      inline const Apto::String& GetTagScaleLabel() const { return m_tags.label; }
       
       inline int GetNumModes() const { return m_view_modes.GetSize(); }
       inline const Apto::String& GetModeName(int idx) const { return m_view_modes[idx]->GetName(); }
@@ -155,10 +187,13 @@ namespace Avida {
       
       // Core Viewer Internal Methods
       void UpdateMaps(cPopulation& pop);
+      void BeginIdle(cPopulation& pop);
+      void EndIdle();
       
       
     protected:
-      void updateMap(cPopulation& pop, int map_id);
+      inline bool isBound(int mode) const { return mode == m_color_mode || mode == m_symbol_mode || mode == m_tag_mode; }
+      void publishMode(int mode);
     };
     
   };
@@ -27,11 +27,13 @@
 #include "avida/data/Manager.h"
 #include "avida/data/Package.h"
 #include "avida/data/Recorder.h"
+#include "avida/data/TimeSeriesRecorder.h"
 #include "avida/output/File.h"
 #include "avida/systematics/Arbiter.h"
 #include "avida/systematics/Group.h"
 #include "avida/systematics/Manager.h"
 
+#include "avida/private/systematics/GenomeTestMetrics.h"
 #include "avida/private/util/GenomeLoader.h"
 
 #include "apto/rng.h"
@@ -395,6 +397,12 @@ public:
     m_data = retrieve_data(m_data_id);
   }
   
+  bool SupportsIndexedNotification() const { return true; }
+  void NotifyIndexedData(Update, Data::IndexedDataRetrievalFunctor retrieve_data)
+  {
+    m_data = retrieve_data(0);
+  }
+  
   void Process(cAvidaContext&)
   {
     const cInstSet& is = m_world->GetHardwareManager().GetInstSet(m_inst_set);
@@ -415,6 +423,74 @@ public:
   }
 };
 
+class cActionPrintTimeSeries : public cAction, public Data::TimeSeriesRecorder<double>
+{
+private:
+  cString m_filename;
+  
+  static Data::DataID dataIDFromArgs(const cString& args)
+  {
+    cString largs(args);
+    largs.Trim();
+    return (const char*)largs.PopWord();
+  }
+  
+public:
+  cActionPrintTimeSeries(cWorld* world, const cString& args, Feedback& feedback)
+  : cAction(world, args), Data::TimeSeriesRecorder<double>(dataIDFromArgs(args)), m_filename("timeseries.dat")
+  {
+    cString largs(args);
+    largs.Trim();
+    largs.PopWord();  // data id, consumed by dataIDFromArgs
+    if (largs.GetSize()) m_filename = largs.PopWord();
+    
+    Update horizon = -1;
+    int keep_every = 1;
+    RollupMode rollup = ROLLUP_SAMPLE;
+    if (largs.GetSize()) horizon = largs.PopWord().AsInt();
+    if (largs.GetSize()) keep_every = largs.PopWord().AsInt();
+    if (largs.GetSize()) {
+      cString mode = largs.PopWord();
+      if (mode == "min") rollup = ROLLUP_MIN;
+      else if (mode == "max") rollup = ROLLUP_MAX;
+      else if (mode == "mean") rollup = ROLLUP_MEAN;
+      else if (mode != "sample") feedback.Warning("PrintTimeSeries: unknown rollup '%s', using sample", (const char*)mode);
+    }
+    if (horizon >= 0) SetRetention(horizon, keep_every, rollup);
+    
+    Data::RecorderPtr thisPtr(this);
+    this->AddReference();
+    if (!m_world->GetDataManager()->AttachRecorder(thisPtr)) {
+      feedback.Error("PrintTimeSeries: data '%s' is not available", (const char*)RecordedDataID());
+    }
+  }
+  
+  static const cString GetDescription()
+  {
+    return "Arguments: <string data_id> [string fname=\"timeseries.dat\"] [int horizon=-1] [int keep_every=1] [string rollup=sample|min|max|mean]";
+  }
+  
+  void Process(cAvidaContext&)
+  {
+    // Rewrites the whole series each time.  Points older than horizon updates are downsampled to one in keep_every.
+    Apto::Array<Update> updates;
+    Apto::Array<double> values;
+    CopyPoints(updates, values);
+    
+    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)m_filename);
+    df->WriteComment("Avida time series data");
+    df->WriteTimeStamp();
+    for (int i = 0; i < updates.GetSize(); i++) {
+      df->Write(updates[i], "Update");
+      df->Write(values[i], (const char*)RecordedDataID());
+      df->Endl();
+    }
+  }
+  
+protected:
+  bool shouldRecordValue(Update) { return true; }
+};
+
 class cActionPrintFromMessageInstructionData : public cAction, public Data::Recorder
 {
 private:
@@ -459,6 +535,12 @@ public:
     m_data = retrieve_data(m_data_id);
   }
   
+  bool SupportsIndexedNotification() const { return true; }
+  void NotifyIndexedData(Update, Data::IndexedDataRetrievalFunctor retrieve_data)
+  {
+    m_data = retrieve_data(0);
+  }
+  
   void Process(cAvidaContext&)
   {
     const cInstSet& is = m_world->GetHardwareManager().GetInstSet(m_inst_set);
@@ -709,6 +791,28 @@ public:
   }
 };
 
+class cActionPrintMemoryPoolData : public cAction
+{
+private:
+  cString m_filename;
+  
+public:
+  cActionPrintMemoryPoolData(cWorld* world, const cString& args, Feedback&)
+  : cAction(world, args)
+  {
+    cString largs(args);
+    largs.Trim();
+    m_filename = (largs.GetSize()) ? largs.PopWord() : "memory_pools.dat";
+  }
+  
+  static const cString GetDescription() { return "Arguments: [string fname=\"memory_pools.dat\"]"; }
+  
+  void Process(cAvidaContext&)
+  {
+    m_world->GetStats().PrintMemoryPoolData(m_filename);
+  }
+};
+
 class cActionPrintMaleInstructionData : public cAction
 {
 private:
@@ -3003,6 +3107,45 @@ public:
 };
 
 
+/*
+ Test CPU metrics of every living genotype, in genotype order.  The file carries no time stamp, so that runs made
+ with and without THRESHOLD_TEST_THREADS can be compared byte for byte.
+ */
+class cActionPrintGenotypeTestMetrics : public cAction
+{
+private:
+  cString m_filename;
+  
+public:
+  cActionPrintGenotypeTestMetrics(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("genotype_test_metrics.dat")
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_filename = largs.PopWord();
+  }
+  static const cString GetDescription() { return "Arguments: [string fname='genotype_test_metrics.dat']"; }
+  void Process(cAvidaContext& ctx)
+  {
+    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)m_filename);
+    df->WriteComment("Avida genotype test CPU metrics");
+    
+    Systematics::ManagerPtr classmgr = Systematics::Manager::Of(m_world->GetNewWorld());
+    Systematics::Arbiter::IteratorPtr it = classmgr->ArbiterForRole("genotype")->Begin();
+    while (it->Next()) {
+      Systematics::GroupPtr genotype = it->Get();
+      Systematics::GenomeTestMetricsPtr metrics = Systematics::GenomeTestMetrics::GetMetrics(m_world, ctx, genotype);
+      if (!metrics) continue;
+      
+      df->Write(genotype->ID(), "Genotype ID");
+      df->Write(metrics->GetFitness(), "Fitness");
+      df->Write(metrics->GetMerit(), "Merit");
+      df->Write(metrics->GetGestationTime(), "Gestation Time");
+      df->Write(metrics->GetTaskCounts(), "Task Counts", "");
+      df->Endl();
+    }
+  }
+};
+
+
 
 class cActionCalcConsensus : public cAction
 {
@@ -5317,6 +5460,7 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   action_lib->Register<cActionPrintTopPredatorFromSensorInstructionData>("PrintTopPredatorFromSensorInstructionData");
   action_lib->Register<cActionPrintGroupAttackData>("PrintGroupAttackData");
   action_lib->Register<cActionPrintKilledPreyFTData>("PrintKilledPreyFTData");
+  action_lib->Register<cActionPrintMemoryPoolData>("PrintMemoryPoolData");
   action_lib->Register<cActionPrintAttacks>("PrintAttacks");
   
   action_lib->Register<cActionPrintFromMessageInstructionData>("PrintFromMessageInstructionData");
@@ -5326,6 +5470,7 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   action_lib->Register<cActionPrintSenseData>("PrintSenseData");
   action_lib->Register<cActionPrintSenseExeData>("PrintSenseExeData");
   action_lib->Register<cActionPrintInstructionData>("PrintInstructionData");
+  action_lib->Register<cActionPrintTimeSeries>("PrintTimeSeries");
   action_lib->Register<cActionPrintInternalTasksData>("PrintInternalTasksData");
   action_lib->Register<cActionPrintInternalTasksQualData>("PrintInternalTasksQualData");
   action_lib->Register<cActionPrintSleepData>("PrintSleepData");
@@ -5470,6 +5615,7 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   action_lib->Register<cActionTestDominant>("TestDominant");
   action_lib->Register<cActionPrintTaskSnapshot>("PrintTaskSnapshot");
   action_lib->Register<cActionPrintViableTasksData>("PrintViableTasksData");
+  action_lib->Register<cActionPrintGenotypeTestMetrics>("PrintGenotypeTestMetrics");
   action_lib->Register<cActionPrintAveNumTasks>("PrintAveNumTasks");
   
   action_lib->Register<cActionPrintGenomicSiteEntropy>("PrintGenomicSiteEntropy");
@@ -31,6 +31,7 @@
 
 #include "avida/private/util/GenomeLoader.h"
 
+#include "apto/platform.h"
 #include "apto/rng.h"
 #include "apto/scheduler.h"
 
@@ -45,9 +46,12 @@
 #include "cAnalyzeGenotype.h"
 #include "cAnalyzeTreeStats_CumulativeStemminess.h"
 #include "cAnalyzeTreeStats_Gamma.h"
+#include "cBatchRecalculation.h"
 #include "cAvidaContext.h"
 #include "cCPUTestInfo.h"
 #include "cEnvironment.h"
+#include "cGenomeScan.h"
+#include "cGenotypeColumns.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cHardwareStatusPrinter.h"
@@ -57,6 +61,7 @@
 #include "cModularityAnalysis.h"
 #include "cPhenotype.h"
 #include "cPhenPlastGenotype.h"
+#include "cPhylogenyIndex.h"
 #include "cPlasticPhenotype.h"
 #include "cReaction.h"
 #include "cReactionProcess.h"
@@ -64,13 +69,14 @@
 #include "cResourceHistory.h"
 #include "cStringIterator.h"
 #include "cTestCPU.h"
+#include "cTwoSiteComplexity.h"
 #include "cUserFeedback.h"
 #include "cWorld.h"
 #include "tAnalyzeJob.h"
-#include "tAnalyzeJobBatch.h"
 #include "tDataCommandManager.h"
 #include "tDataEntry.h"
 #include "tDataEntryCommand.h"
+#include "tDataEntryFormatter.h"
 #include "tMatrix.h"
 
 #include <iomanip>
@@ -918,14 +924,26 @@ void cAnalyze::CommandFilter(cString cur_string)
   
   // Loop through the genotypes and remove the entries that don't match.
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * cur_genotype = NULL;
-  while ((cur_genotype = batch_it.Next()) != NULL) {
-    const cFlexVar value = stat_command->GetValue(cur_genotype);
-    int compare = 1 + CompareFlexStat(value, test_value);
-    
-    // Check if we should eliminate this genotype...
-    if (rel_ok[compare] == false) {
-      delete batch_it.Remove();
+  const int column = cGenotypeColumns::FindColumn(stat_name);
+  if (column != -1) {
+    // Column stats compare numerically, just as a cFlexVar does against the test string, in one pass over the column
+    cGenotypeColumns columns(batch[cur_batch].List());
+    Apto::Array<int> compare;
+    columns.Compare(column, test_value.AsDouble(), compare);
+    for (int row = 0; row < compare.GetSize(); row++) {
+      batch_it.Next();
+      if (rel_ok[1 + compare[row]] == false) delete batch_it.Remove();
+    }
+  } else {
+    cAnalyzeGenotype * cur_genotype = NULL;
+    while ((cur_genotype = batch_it.Next()) != NULL) {
+      const cFlexVar value = stat_command->GetValue(cur_genotype);
+      int compare = 1 + CompareFlexStat(value, test_value);
+      
+      // Check if we should eliminate this genotype...
+      if (rel_ok[compare] == false) {
+        delete batch_it.Remove();
+      }
     }
   }
   delete stat_command;
@@ -936,6 +954,59 @@ void cAnalyze::CommandFilter(cString cur_string)
   batch[cur_batch].SetAligned(false);
 }
 
+void cAnalyze::CommandSort(cString cur_string)
+{
+  // Arguments are: stat, and an optional direction (ascending or descending)
+  
+  const int num_args = cur_string.CountNumWords();
+  cString stat_name = cur_string.PopWord();
+  cString direction = cur_string.PopWord();
+  if (direction.GetSize() == 0) direction = "ascending";
+  
+  tDataEntryCommand<cAnalyzeGenotype>* stat_command = cAnalyzeGenotype::GetDataCommandManager().GetDataCommand(stat_name);
+  
+  bool error_found = false;
+  if (num_args < 1 || num_args > 2) {
+    cerr << "Error: Incorrect argument count." << endl;
+    error_found = true;
+  }
+  if (stat_command == NULL) {
+    cerr << "Error: Unknown stat '" << stat_name << "'" << endl;
+    error_found = true;
+  }
+  if (direction != "ascending" && direction != "descending") {
+    cerr << "Error: Unknown direction '" << direction << "'" << endl;
+    error_found = true;
+  }
+  
+  if (error_found == true) {
+    cerr << "Format: SORT [stat] [direction=ascending]" << endl;
+    cerr << "Example: SORT fitness descending" << endl;
+    if (exit_on_error) exit(1);
+    if (stat_command != NULL) delete stat_command;
+    return;
+  }
+  
+  if (m_world->GetVerbosity() >= VERBOSE_ON) {
+    cout << "Sorting batch " << cur_batch << " on " << stat_name << " (" << direction << ")" << endl;
+  }
+  
+  // Genotypes with equal values keep their current order
+  cGenotypeColumns columns(batch[cur_batch].List());
+  Apto::Array<int> order;
+  const int column = cGenotypeColumns::FindColumn(stat_name);
+  if (column != -1) columns.GetSortedOrder(column, (direction == "descending"), order);
+  else columns.GetSortedOrder(*stat_command, (direction == "descending"), order);
+  delete stat_command;
+  
+  tListPlus<cAnalyzeGenotype>& gen_list = batch[cur_batch].List();
+  while (gen_list.GetSize()) gen_list.Pop();
+  for (int i = 0; i < order.GetSize(); i++) gen_list.PushRear(columns.GetGenotype(order[i]));
+  
+  // A sorted batch is no longer in lineage order
+  batch[cur_batch].SetLineage(false);
+}
+
 void cAnalyze::FindGenotype(cString cur_string)
 {
   // If no arguments are passed in, just find max num_cpus.
@@ -1068,37 +1139,32 @@ void cAnalyze::FindLineage(cString cur_string)
     return;
   }
   
-  // Otherwise, trace back through the id numbers to mark all of those
+  // Otherwise, trace back through the parent links to mark all of those
   // in the ancestral lineage...
   
   // Construct a list of genotypes found...
   
+  const cPhylogenyIndex& phylogeny = batch[cur_batch].GetPhylogeny();
+  Apto::Array<bool> in_lineage(phylogeny.GetSize());
+  in_lineage.SetAll(false);
+  
   tListPlus<cAnalyzeGenotype> found_list;
   found_list.Push(found_gen);
-  int next_id = found_gen->GetParentID();
-  bool found = true;
-  while (found == true) {
-    found = false;
-    
-    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-    while ((found_gen = batch_it.Next()) != NULL) {
-      if (found_gen->GetID() == next_id) {
-        batch_it.Remove();
-        found_list.Push(found_gen);
-        next_id = found_gen->GetParentID();
-        found = true;
-        break;
-      }
-    }
+  for (int node = phylogeny.FindNode(found_gen->GetParentID()); node != -1 && !in_lineage[node]; node = phylogeny.GetParent(node)) {
+    in_lineage[node] = true;
+    found_list.Push(phylogeny.GetGenotype(node));
   }
   
   // We now have all of the genotypes in this lineage, delete everything
   // else.
   
-  const int total_removed = batch[cur_batch].List().GetSize();
-  while (batch[cur_batch].List().GetSize() > 0) {
-    delete batch[cur_batch].List().Pop();
+  int total_removed = 0;
+  for (int node = 0; node < phylogeny.GetSize(); node++) {
+    if (in_lineage[node]) continue;
+    delete phylogeny.GetGenotype(node);
+    total_removed++;
   }
+  batch[cur_batch].List().Clear();
   
   // And fill it back in with the good stuff.
   int total_kept = found_list.GetSize();
@@ -1294,38 +1360,41 @@ void cAnalyze::FindClade(cString cur_string)
     return;
   }
   
-  // Do this the brute force way... scan for one step at a time.
-  
   // Construct a list of genotypes found...
   
-  tListPlus<cAnalyzeGenotype> found_list; // Found and finished.
-  tListPlus<cAnalyzeGenotype> scan_list;  // Found, but need to scan for children.
+  const cPhylogenyIndex& phylogeny = batch[cur_batch].GetPhylogeny();
+  Apto::Array<bool> in_clade(phylogeny.GetSize());
+  in_clade.SetAll(false);
+  
+  tListPlus<cAnalyzeGenotype> found_list;                 // Found and finished.
+  Apto::Array<cAnalyzeGenotype*, Apto::Smart> scan_list;  // Found, but need to scan for children.
+  Apto::Array<int, Apto::Smart> children;
   scan_list.Push(found_gen);
   
   // Keep going as long as there is something in the scan list...
   while (scan_list.GetSize() > 0) {
     // Move the next genotype from the scan list to the found_list.
     found_gen = scan_list.Pop();
-    int parent_id = found_gen->GetID();
     found_list.Push(found_gen);
     
-    // Seach for all of the children of this genotype...
-    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-    while ((found_gen = batch_it.Next()) != NULL) {
-      // If we found a child, place it into the scan list.
-      if (found_gen->GetParentID() == parent_id) {
-        batch_it.Remove();
-        scan_list.Push(found_gen);
-      }
+    // Place all of the children of this genotype into the scan list.
+    phylogeny.GetChildrenOf(found_gen->GetID(), children);
+    for (int i = 0; i < children.GetSize(); i++) {
+      if (in_clade[children[i]]) continue;
+      in_clade[children[i]] = true;
+      scan_list.Push(phylogeny.GetGenotype(children[i]));
     }
   }
   
   // We now have all of the genotypes in this clade, delete everything else.
   
-  const int total_removed = batch[cur_batch].List().GetSize();
-  while (batch[cur_batch].List().GetSize() > 0) {
-    delete batch[cur_batch].List().Pop();
+  int total_removed = 0;
+  for (int node = 0; node < phylogeny.GetSize(); node++) {
+    if (in_clade[node]) continue;
+    delete phylogeny.GetGenotype(node);
+    total_removed++;
   }
+  batch[cur_batch].List().Clear();
   
   // And fill it back in with the good stuff.
   int total_kept = found_list.GetSize();
@@ -1354,53 +1423,26 @@ void cAnalyze::FindLastCommonAncestor(cString)
   cout << "Finding last common ancestor of batch " << cur_batch << endl;
   
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
-    cout << "  Connecting genotypes to parents. " << endl;
-  }
-  
-  // Connect each genotype to its parent.
-  tListIterator<cAnalyzeGenotype> child_it(batch[cur_batch].List());
-  cAnalyzeGenotype * on_child = NULL;
-  while ((on_child = child_it.Next()) != NULL) {
-    tListIterator<cAnalyzeGenotype> parent_it(batch[cur_batch].List());
-    cAnalyzeGenotype * on_parent = NULL;
-    while ((on_parent = parent_it.Next()) != NULL) {
-      if (on_child->GetParentID() == on_parent->GetID()) {
-        on_child->LinkParent(on_parent);
-        break;
-      }
-    }
-  }
-
-  if (m_world->GetVerbosity() >= VERBOSE_ON) {
-    cout << "  Finding earliest genotype. " << endl;
+    cout << "  Indexing genotype parents. " << endl;
   }
   
-  // Find the genotype without a parent (there should only be one)
-  tListIterator<cAnalyzeGenotype> first_lca_it(batch[cur_batch].List());
-  cAnalyzeGenotype * lca = NULL;
-  cAnalyzeGenotype * test_lca = NULL;
-  while ((test_lca = first_lca_it.Next()) != NULL) {
-    if (!test_lca->GetParent()) {
-      // It is an error to get two genotypes without a parent
-      if (lca != NULL) {
-        cout << "Error: More than one genotype does not have a parent. " << endl;
-        cout << "Genotype 1: " << test_lca->GetID() << endl;
-        cout << "Genotype 2: " << lca->GetID() << endl;
-        return;
-      }
-      lca = test_lca;
-    }
+  // There should be only one genotype without a parent
+  const cPhylogenyIndex& phylogeny = batch[cur_batch].GetPhylogeny();
+  if (phylogeny.GetRoots().GetSize() > 1) {
+    cout << "Error: More than one genotype does not have a parent. " << endl;
+    cout << "Genotype 1: " << phylogeny.GetGenotype(phylogeny.GetRoots()[1])->GetID() << endl;
+    cout << "Genotype 2: " << phylogeny.GetGenotype(phylogeny.GetRoots()[0])->GetID() << endl;
+    return;
   }
   
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
-    cout << "  Following children to last common ancestor. " << endl;
+    cout << "  Finding common ancestor of all leaves. " << endl;
   }
   
-  // Follow the children from this parent until we find a genotype with 
-  // more than one child. This is the last common ancestor.
-  while (lca->GetChildList().GetSize() == 1) {
-    lca = lca->GetChildList().Pop();
-  }
+  // The deepest genotype that every leaf descends from is the last common ancestor.
+  const int lca_node = phylogeny.FindLastCommonAncestor();
+  if (lca_node == -1) return;
+  cAnalyzeGenotype* lca = phylogeny.GetGenotype(lca_node);
   
   // Delete everything else.
   tListIterator<cAnalyzeGenotype> delete_batch_it(batch[cur_batch].List());
@@ -1996,6 +2038,22 @@ void cAnalyze::CommandDetail_Body(ostream& fp, int format_type,
                                   tListIterator< tDataEntryCommand<cAnalyzeGenotype> > & output_it,
                                   int time_step, int max_time)
 {
+  tDataEntryFormatter<cAnalyzeGenotype> formatter(output_it);
+  
+  // A plain text detail is formatted in blocks, spread across the analyze threads when the columns allow it
+  if (format_type == FILE_TYPE_TEXT && time_step <= 0 && m_world->GetVerbosity() < VERBOSE_DETAILS) {
+    Apto::Array<cAnalyzeGenotype*> genotypes(batch[cur_batch].List().GetSize());
+    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
+    for (int i = 0; i < genotypes.GetSize(); i++) genotypes[i] = batch_it.Next();
+    
+    int num_threads = m_world->GetConfig().MAX_CONCURRENCY.Get();
+    if (num_threads < 1 || num_threads > Apto::Platform::AvailableCPUs()) num_threads = Apto::Platform::AvailableCPUs();
+    formatter.Write(fp, genotypes, num_threads);
+    return;
+  }
+  
+  cOutputBuffer row;
+  
   // Loop through all of the genotypes in this batch...
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
   cAnalyzeGenotype * cur_genotype = batch_it.Next();
@@ -2018,10 +2076,10 @@ void cAnalyze::CommandDetail_Body(ostream& fp, int format_type,
       fp << cur_time << " ";
     }
     
-    tDataEntryCommand<cAnalyzeGenotype> * data_command = NULL;
-    while ((data_command = output_it.Next()) != NULL) {
-      cFlexVar cur_value = data_command->GetValue(cur_genotype);
-      if (format_type == FILE_TYPE_HTML) {
+    if (format_type == FILE_TYPE_HTML) {
+      tDataEntryCommand<cAnalyzeGenotype> * data_command = NULL;
+      while ((data_command = output_it.Next()) != NULL) {
+        cFlexVar cur_value = data_command->GetValue(cur_genotype);
         int compare = 0;
         if (prev_genotype) {
           cFlexVar prev_value = data_command->GetValue(prev_genotype);
@@ -2030,12 +2088,12 @@ void cAnalyze::CommandDetail_Body(ostream& fp, int format_type,
         }
         HTMLPrintStat(cur_value, fp, compare, data_command->GetHtmlCellFlags(), data_command->GetNull());
       }
-      else {  // if (format_type == FILE_TYPE_TEXT) {
-        fp << data_command->GetValue(cur_genotype) << " ";
-      }
-      }
-    if (format_type == FILE_TYPE_HTML) fp << "</tr>";
-    fp << endl;
+      fp << "</tr>" << endl;
+    }
+    else {  // if (format_type == FILE_TYPE_TEXT) {
+      formatter.AppendRow(row, cur_genotype);
+      row.Write(fp);
+    }
     
     cur_time += time_step;
     if (time_step > 0) {
@@ -4509,20 +4567,13 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
     const int max_line = genotype->GetLength();
     
     const Genome& base_genome = genotype->GetGenome();
-    ConstInstructionSequencePtr base_seq_p;
-    ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
-    base_seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& base_seq = *base_seq_p;
+    const int null_op = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst().GetOp();
     
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& mod_seq = *mod_seq_p;
+    // Test the removal of each line of code (replacing it with "NULL") as its own job.
+    cGenomeScan ko_scan(m_world, base_genome);
+    for (int line_num = 0; line_num < max_line; line_num++) ko_scan.AddVariant(line_num, null_op);
+    ko_scan.Run(m_jobqueue, m_ctx);
     
-    Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
-    
-    // Loop through all the lines of code, testing the removal of each.
     // -2=lethal, -1=detrimental, 0=neutral, 1=beneficial
     int dead_count = 0;
     int neg_count = 0;
@@ -4530,13 +4581,7 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
     int pos_count = 0;
     Apto::Array<int> ko_effect(max_line);
     for (int line_num = 0; line_num < max_line; line_num++) {
-      // Save a copy of the current instruction and replace it with "NULL"
-      int cur_inst = base_seq[line_num].GetOp();
-      mod_seq[line_num] = null_inst;
-      cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-      ko_genotype.Recalculate(m_ctx);
-      
-      double ko_fitness = ko_genotype.GetFitness();
+      double ko_fitness = ko_scan.GetFitness(line_num);
       if (ko_fitness == 0.0) {
         dead_count++;
         ko_effect[line_num] = -2;
@@ -4552,45 +4597,46 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
       } else {
         cerr << "ERROR: illegal state in AnalyzeKnockouts()" << endl;
       }
-      
-      // Reset the mod_genome back to the original sequence.
-      mod_seq[line_num].SetOp(cur_inst);
     }
     
     Apto::Array<int> ko_pair_effect(ko_effect);
     if (max_knockouts > 1) {
-      for (int line1 = 0; line1 < max_line; line1++) {
-      	for (int line2 = line1+1; line2 < max_line; line2++) {
-          int cur_inst1 = base_seq[line1].GetOp();
-          int cur_inst2 = base_seq[line2].GetOp();
-          mod_seq[line1] = null_inst;
-          mod_seq[line2] = null_inst;
-          cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-          ko_genotype.Recalculate(m_ctx);
-          
-          double ko_fitness = ko_genotype.GetFitness();
-          
-          // If both individual knockouts are both harmful, but in combination
-          // they are neutral or even beneficial, they should not count as 
-          // information.
-          if (ko_fitness >= base_fitness &&
-              ko_effect[line1] < 0 && ko_effect[line2] < 0) {
-            ko_pair_effect[line1] = 0;
-            ko_pair_effect[line2] = 0;
+      // Pairs are submitted a block of rows at a time, to keep the number of outstanding variants bounded, and applied
+      // in the same order as they would be tested one after another.
+      const int max_block_pairs = 4096;
+      int line1 = 0;
+      while (line1 < max_line) {
+        ko_scan.Clear();
+        const int first_line1 = line1;
+        while (line1 < max_line && ko_scan.GetSize() < max_block_pairs) {
+          for (int line2 = line1 + 1; line2 < max_line; line2++) ko_scan.AddVariant(line1, null_op, line2, null_op);
+          line1++;
+        }
+        ko_scan.Run(m_jobqueue, m_ctx);
+        
+        int pair_idx = 0;
+        for (int l1 = first_line1; l1 < line1; l1++) {
+          for (int l2 = l1 + 1; l2 < max_line; l2++) {
+            double ko_fitness = ko_scan.GetFitness(pair_idx++);
+            
+            // If both individual knockouts are both harmful, but in combination
+            // they are neutral or even beneficial, they should not count as 
+            // information.
+            if (ko_fitness >= base_fitness &&
+                ko_effect[l1] < 0 && ko_effect[l2] < 0) {
+              ko_pair_effect[l1] = 0;
+              ko_pair_effect[l2] = 0;
+            }
+            
+            // If the individual knockouts are both neutral (or beneficial?),
+            // but in combination they are harmful, they are likely redundant
+            // to each other.  For now, count them both as information.
+            if (ko_fitness < base_fitness &&
+                ko_effect[l1] >= 0 && ko_effect[l2] >= 0) {
+              ko_pair_effect[l1] = -1;
+              ko_pair_effect[l2] = -1;
+            }
           }
-          
-          // If the individual knockouts are both neutral (or beneficial?),
-          // but in combination they are harmful, they are likely redundant
-          // to each other.  For now, count them both as information.
-          if (ko_fitness < base_fitness &&
-              ko_effect[line1] >= 0 && ko_effect[line2] >= 0) {
-            ko_pair_effect[line1] = -1;
-            ko_pair_effect[line2] = -1;
-          }	
-          
-          // Reset the mod_genome back to the original sequence.
-          mod_seq[line1].SetOp(cur_inst1);
-          mod_seq[line2].SetOp(cur_inst2);
         }
       }
     }    
@@ -5931,12 +5977,6 @@ void cAnalyze::CommandMapTasks(cString cur_string)
     base_seq_p.DynamicCastFrom(rep_p);
     const InstructionSequence& base_seq = *base_seq_p;
     
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& mod_seq = *mod_seq_p;
-    
     // Keep track of the number of failues/successes for attributes...
     int * col_pass_count = new int[num_cols];
     int * col_fail_count = new int[num_cols];
@@ -5948,14 +5988,26 @@ void cAnalyze::CommandMapTasks(cString cur_string)
     cInstSet& is = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
     const Instruction null_inst = is.ActivateNullInst();
     
-    // Loop through all the lines of code, testing the removal of each.
+    // Test the removal of each line of code as its own job, keeping the knockouts to print their columns.
+    cGenomeScan ko_scan(m_world, base_genome, &test_info, true);
+    for (int line_num = 0; line_num < max_line; line_num++) ko_scan.AddVariant(line_num, null_inst.GetOp());
+    ko_scan.Run(m_jobqueue, m_ctx);
+    
+    // The knockouts also give the sites whose loss stops each task, which are kept for the modularity analyses
+    const int num_tasks = m_world->GetEnvironment().GetNumTasks();
+    Apto::Array<cBitArray> task_sites(num_tasks);
+    for (int i = 0; i < num_tasks; i++) task_sites[i].ResizeClear(max_line);
+    
     for (int line_num = 0; line_num < max_line; line_num++) {
       int cur_inst = base_seq[line_num].GetOp();
       char cur_symbol = base_seq[line_num].GetSymbol()[0]; // hack to work around multichar symbols
+      cAnalyzeGenotype& test_genotype = *ko_scan.GetGenotype(line_num);
       
-      mod_seq[line_num] = null_inst;
-      cAnalyzeGenotype test_genotype(m_world, mod_genome);
-      test_genotype.Recalculate(m_ctx, &test_info);
+      if (test_genotype.GetFitness() > 0.0) {
+        for (int i = 0; i < num_tasks; i++) {
+          if (genotype->GetTaskCount(i) && !test_genotype.GetTaskCount(i)) task_sites[i].Set(line_num, true);
+        }
+      }
       
       if (file_type == FILE_TYPE_HTML) fp << "<tr><td align=right>";
       fp << (line_num + 1) << " ";
@@ -5991,10 +6043,8 @@ void cAnalyze::CommandMapTasks(cString cur_string)
       }
       if (file_type == FILE_TYPE_HTML) fp << "</tr>";
       fp << endl;
-      
-      // Reset the mod_genome back to the original sequence.
-      mod_seq[line_num].SetOp(cur_inst);
     }
+    cModularityAnalysis::SetTaskSites(genotype, test_info, task_sites);
     
     
     // Construct the final line of the table with all totals...
@@ -6029,17 +6079,8 @@ void cAnalyze::CommandCalcFunctionalModularity(cString cur_string)
   cCPUTestInfo test_info;
   PopCommonCPUTestParameters(m_world, cur_string, test_info, m_resources, m_resource_time_spent_offset);
 
-  tList<cModularityAnalysis> mod_list;
-  tAnalyzeJobBatch<cModularityAnalysis> jobbatch(m_jobqueue);
-  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  for (cAnalyzeGenotype* cur_genotype = batch_it.Next(); cur_genotype; cur_genotype = batch_it.Next()) {
-    cModularityAnalysis* mod = new cModularityAnalysis(cur_genotype, test_info);
-    mod_list.Push(mod);
-    jobbatch.AddJob(mod, &cModularityAnalysis::CalcFunctionalModularity);
-  }
-  jobbatch.RunBatch();
-  cModularityAnalysis* mod = NULL;
-  while ((mod = mod_list.Pop())) delete mod;
+  cModularityAnalysis mod(m_world, test_info);
+  mod.Run(m_jobqueue, m_ctx, batch[cur_batch].List());
 }
 
 void cAnalyze::CommandAverageModularity(cString cur_string)
@@ -6181,54 +6222,35 @@ void cAnalyze::CommandAverageModularity(cString cur_string)
       const int max_line = genotype->GetLength();
       
       const Genome& base_genome = genotype->GetGenome();
-      ConstInstructionSequencePtr base_seq_p;
-      ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
-      base_seq_p.DynamicCastFrom(rep_p);
-      const InstructionSequence& base_seq = *base_seq_p;
-      
-      Genome mod_genome(base_genome);
-      InstructionSequencePtr mod_seq_p;
-      GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-      mod_seq_p.DynamicCastFrom(mod_rep_p);
-      InstructionSequence& mod_seq = *mod_seq_p;
       
       Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
       
-      // Create and initialize the modularity matrix
-      tMatrix<int> mod_matrix(num_cols, max_line);
-      mod_matrix.SetAll(0);
-      
-      // Create and initialize the task overalp matrix
-      tMatrix<int> task_overlap(num_cols, num_cols);
-      task_overlap.SetAll(0);
+      // Create the modularity matrix, one row of sites for each column
+      Apto::Array<cBitArray> mod_matrix(num_cols);
+      for (int i = 0; i < num_cols; i++) mod_matrix[i].ResizeClear(max_line);
       
       // Create an initialize the counters for modularity
       Apto::Array<int> num_task(max_line); // number of tasks instruction is used in
       Apto::Array<int> num_inst(num_cols); // number of instructions involved in a task
       Apto::Array<int> sum(num_cols); 	    // helps with StDev calculations
-      Apto::Array<int> sumsq(num_cols);    // helps with StDev calculations
       Apto::Array<int> inst_task(num_cols+1); // # of inst's involved in 0,1,2,3... tasks
       Apto::Array<int> task_length(num_cols);    // ditance between first and last inst involved in a task
       
       num_task.SetAll(0);
-      num_inst.SetAll(0);
-      sum.SetAll(0);
-      sumsq.SetAll(0);
       inst_task.SetAll(0);
-      task_length.SetAll(0);
       
       int total_task = 0;        // total number of tasks done
       int total_inst = 0;        // total number of instructions involved in tasks
       int total_all = 0;         // sum of mod_matrix
       double sum_task_overlap = 0;// task overlap for for this geneome
       
-      // Loop through all the lines of code, testing the removal of each.
+      // Test the removal of each line of code as its own job, keeping the knockouts to compare their columns.
+      cGenomeScan ko_scan(m_world, base_genome, NULL, true);
+      for (int line_num = 0; line_num < max_line; line_num++) ko_scan.AddVariant(line_num, null_inst.GetOp());
+      ko_scan.Run(m_jobqueue, m_ctx);
+      
       for (int line_num = 0; line_num < max_line; line_num++) {
-        int cur_inst = base_seq[line_num].GetOp();
-        
-        mod_seq[line_num] = null_inst;
-        cAnalyzeGenotype test_genotype(m_world, mod_genome);
-        test_genotype.Recalculate(m_ctx);
+        cAnalyzeGenotype& test_genotype = *ko_scan.GetGenotype(line_num);
         
         // Print the individual columns...
         output_it.Reset();
@@ -6246,22 +6268,19 @@ void cAnalyze::CommandAverageModularity(cString cur_string)
           
           // If knocking out an instruction stops the expression of a
           // particular task, mark that in the modularity matrix
-          // and add it to two counts
+          // and count it for the site
           // Only do the checking if the test_genotype replicate, i.e.
           // if it's fitness is not zeros
           
           if (compare < 0  && test_genotype.GetFitness() != 0) {
-            mod_matrix(cur_col,line_num) = 1;
-            num_inst[cur_col]++;
+            mod_matrix[cur_col].Set(line_num, true);
             num_task[line_num]++;
           }
           cur_col++;
         }
-        
-        // Reset the mod_genome back to the original sequence.
-        mod_seq[line_num].SetOp(cur_inst);
       } // end of genotype-phenotype mapping for a single organism
       
+      for (int i = 0; i < num_cols; i++) num_inst[i] = mod_matrix[i].CountBits();
       for (int i = 0; i < num_cols; i++) if (num_inst[i] != 0) total_task++;
       for (int i = 0; i < max_line; i++) if (num_task[i] != 0) total_inst++;
       for (int i = 0; i < num_cols; i++) total_all = total_all + num_inst[i];
@@ -6288,27 +6307,23 @@ void cAnalyze::CommandAverageModularity(cString cur_string)
       }	
       
       // calculate average task overlap
-      // first construct num_task x num_task matrix with number of sites overlapping
-      for (int i = 0; i < max_line; i++) {
+      // first count the sites each task shares with every other task
+      if (total_task > 1) {
+        Apto::Array<int> task_overlap(num_cols);
+        task_overlap.SetAll(0);
         for (int j = 0; j < num_cols; j++) {
-          for (int k = j; k < num_cols; k++) {
-            if (mod_matrix(j,i)>0 && mod_matrix(k,i)>0) {
-              task_overlap(j,k)++;
-              if (j!=k) task_overlap(k,j)++;
-            }               
+          if (num_inst[j] == 0) continue;
+          for (int k = j + 1; k < num_cols; k++) {
+            const int overlap = mod_matrix[j].CountBitsAND(mod_matrix[k]);
+            task_overlap[j] += overlap;
+            task_overlap[k] += overlap;
           }
         }
-      }
-      
-      // go though the task_overlap matrix, add and average everything up. 
-      if (total_task > 1) {
+        
+        // add and average everything up
         for (int i = 0; i < num_cols; i++) {
-          double overlap_per_task = 0;                 
-          for (int j = 0; j < num_cols; j++) {
-            if (i!=j) {overlap_per_task = overlap_per_task + task_overlap(i,j);}
-          }
-          if (task_overlap(i,i) !=0){
-            sum_task_overlap = sum_task_overlap + overlap_per_task / (task_overlap(i,i) * (total_task-1));   
+          if (num_inst[i] != 0) {
+            sum_task_overlap = sum_task_overlap + (double) task_overlap[i] / (num_inst[i] * (total_task-1));
           }
         }
       }
@@ -6317,53 +6332,23 @@ void cAnalyze::CommandAverageModularity(cString cur_string)
       if (total_task!=0) {
         av_task_overlap = av_task_overlap + num_cpus * (double) sum_task_overlap/total_task ;
       }
-      // calculate the first/last postion of a task, the task "spread"
-      // starting from the top look for the fist command that matters for a task
       
-      for (int i = 0; i < num_cols; i++) { 
-        int j = 0; 
-        while (j < max_line) {
-          if (mod_matrix(i,j) > 0 && task_length[i] == 0 ) {
-            task_length[i] = j;
-            break;
-          }
-          j++;
-        }
-      }
-      
-      // starting frm the bottom look for the last command that matters for a task
-      // and substract it from the first to get the task length
+      // calculate the first/last postion of a task, the task "spread", and the sum of its positions
       // add one in order to account for both the beginning and the end instruction
-      for (int i = 0; i < num_cols; i++) { 
-        int j = max_line - 1; 
-        while (j > -1) {
-          if (mod_matrix(i,j) > 0) {
-            task_length[i] = j - task_length[i] + 1;
-            break;
-          }
-          j--;
-        }
-      }
       // add the task lengths to the average for the batch
       // weigthed by the number of cpus for that genotype 
+      double temp = 0;
       for (int i = 0; i < num_cols; i++) { 
+        Apto::Array<int> sites = mod_matrix[i].GetOnes();
+        sum[i] = 0;
+        for (int j = 0; j < sites.GetSize(); j++) sum[i] = sum[i] + sites[j];
+        task_length[i] = (sites.GetSize() > 0) ? sites[sites.GetSize() - 1] - sites[0] + 1 : 0;
         av_task_length[i] = av_task_length[i] +  num_cpus * task_length[i];
-      }
-      
-      // calculate the Standard Deviation in the mean position of the task
-      for (int i = 0; i < num_cols; i++) { 
-        for (int j = 0; j < max_line; j++) { 
-          if (mod_matrix(i,j)>0) sum[i] = sum[i] + j;
-        }		
-      }
-      
-      double temp = 0;
-      for (int i = 0; i < num_cols; i++) {
+        
+        // calculate the Standard Deviation in the mean position of the task
         if (num_inst[i]>1) { 
           double av_sum = sum[i]/num_inst[i];
-          for (int j = 0; j < max_line; j++) {
-            if (mod_matrix(i,j)>0) temp = (av_sum - j)*(av_sum - j);
-          }
+          for (int j = 0; j < sites.GetSize(); j++) temp = (av_sum - sites[j])*(av_sum - sites[j]);
           std_task_position[i] = std_task_position[i] + sqrt(temp/(num_inst[i]-1))*num_cpus;
         } 
       } 
@@ -6428,36 +6413,23 @@ void cAnalyze::CommandAnalyzeModularity(cString cur_string)
   while ((genotype = batch_it.Next()) != NULL) {
     const int base_length = genotype->GetLength();
     const Genome& base_genome = genotype->GetGenome();
-    ConstInstructionSequencePtr base_seq_p;
-    ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
-    base_seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& base_seq = *base_seq_p;    
-    
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& seq = *mod_seq_p;    
     
     genotype->Recalculate(m_ctx);
     
     const Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
     
-    tMatrix<bool> task_matrix(num_traits, base_length);
-    Apto::Array<int> num_inst(num_traits);  // Number of instructions for each task
-    Apto::Array<int> num_task(base_length); // Number of traits at each locus
-    task_matrix.SetAll(false);
-    num_inst.SetAll(0);
-    num_task.SetAll(0);
+    // One row of sites for each trait
+    Apto::Array<cBitArray> task_matrix(num_traits);
+    for (int i = 0; i < num_traits; i++) task_matrix[i].ResizeClear(base_length);
+    
+    // Determine what happens to this genotype when each line is knocked out, each as its own job
+    cGenomeScan ko_scan(m_world, base_genome, NULL, true);
+    for (int line_num = 0; line_num < base_length; line_num++) ko_scan.AddVariant(line_num, null_inst.GetOp());
+    ko_scan.Run(m_jobqueue, m_ctx);
     
     // Loop through all lines in this genome
     for (int line_num = 0; line_num < base_length; line_num++) {
-      int cur_inst = base_seq[line_num].GetOp();
-      
-      // Determine what happens to this genotype when this line is knocked out
-      seq[line_num] = null_inst;
-      cAnalyzeGenotype test_genotype(m_world, mod_genome);
-      test_genotype.Recalculate(m_ctx);
+      cAnalyzeGenotype& test_genotype = *ko_scan.GetGenotype(line_num);
       
       // Loop through the individual traits
       output_it.Reset();
@@ -6473,18 +6445,10 @@ void cAnalyze::CommandAnalyzeModularity(cString cur_string)
         // the modularity matrix.  Only check if the test_genotype replicates,
         // i.e. if its fitness is not zeros
         if (compare < 0  && test_genotype.GetFitness() != 0) {
-          task_matrix(cur_trait, line_num) = true;
-          num_inst[cur_trait]++;
-          num_task[line_num]++;
-          // cout << line_num << " : true" << endl;
-        } else {
-          // cout << line_num << " : false" << endl;
+          task_matrix[cur_trait].Set(line_num, true);
         }
         cur_trait++;
       }
-      
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
     } // end of genotype-phenotype mapping for a single organism
     
     
@@ -6496,45 +6460,33 @@ void cAnalyze::CommandAnalyzeModularity(cString cur_string)
     int trait_count = 0; // Count active traits...
     int site_count = 0;  // Count total sites for all traits...
     for (int cur_trait = 0; cur_trait < num_traits; cur_trait++) {
-      //       cout << "Trait " << cur_trait << ", coded for by "
-      //         << num_inst[cur_trait] << " instructions." << endl;
-      
       // Ignore traits not coded for in this genome...
-      if (num_inst[cur_trait] == 0) continue;
+      Apto::Array<int> sites = task_matrix[cur_trait].GetOnes();
+      if (sites.GetSize() == 0) continue;
       
       // Keep track of how many traits we're examining...
       trait_count++;
+      site_count += sites.GetSize();
       
       double trait_dist = 0.0;  // Total distance between sites in this trait.
       int num_samples = 0;      // Count samples we take for this trait.
       
-      // Compare all pairs of positions.
-      for (int pos1 = 0; pos1 < base_length; pos1++) {
-        if (task_matrix(cur_trait, pos1) == false) continue;
-        site_count++;
-        for (int pos2 = pos1+1; pos2 < base_length; pos2++) {
-          if (task_matrix(cur_trait, pos2) == false) continue;
-          
-          // We'll only make it this far if both positions code for the trait.
+      // Compare all pairs of positions that code for the trait.
+      for (int i = 0; i < sites.GetSize(); i++) {
+        for (int j = i + 1; j < sites.GetSize(); j++) {
           num_samples++;
           
           // Calculate the distance...
-          int cur_dist = pos2 - pos1;
+          int cur_dist = sites[j] - sites[i];
           
           // Remember to consider that the genome is circular.
           if (2*cur_dist > base_length) cur_dist = base_length - cur_dist;
           
-          //        cout << "Pos " << pos1 << " and " << pos2 << "; distance="
-          //             << cur_dist << endl;
-          
           // And add it into the total for this trait.
           trait_dist += cur_dist;
         }
       }
       
-      // Assert that we found the correct number of samples.
-      //assert(num_samples = num_inst(cur_trait) * (num_inst(cur_trait)-1) / 2);
-      
       // Now that we have all of the distances for this trait, divide by the
       // number of samples and add it to the average.
       ave_dist += trait_dist / num_samples;
@@ -6654,13 +6606,16 @@ void cAnalyze::CommandAnalyzeRedundancyByInstFailure(cString cur_string)
           if (original_inst_set.GetProbFail(inst) > 0) modify_inst_set->SetProbFail(inst, fc);
         }
         
-        // Recalculate the requested number of times
+        // Recalculate the requested number of times, each replicate as its own job
+        cGenomeScan replicate_scan(m_world, genotype->GetGenome());
+        for (int i = 0; i < replicates; i++) replicate_scan.AddVariant();
+        replicate_scan.Run(m_jobqueue, m_ctx);
+        
         double chance = 0;
         double avg_fitness = 0;
         for (int i = 0; i < replicates; i++) {
-          genotype->Recalculate(m_ctx);
-          if (genotype->GetFitness() < baseline_fitness) chance++;
-          avg_fitness += genotype->GetFitness();
+          if (replicate_scan.GetFitness(i) < baseline_fitness) chance++;
+          avg_fitness += replicate_scan.GetFitness(i);
         }      
         
         if (mode == 0) {
@@ -6732,12 +6687,6 @@ void cAnalyze::CommandMapMutations(cString cur_string)
     base_seq_p.DynamicCastFrom(rep_p);
     const InstructionSequence& base_seq = *base_seq_p;
     
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& seq = *mod_seq_p;
-    
     const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
     const int num_insts = inst_set.GetSize();
     
@@ -6803,7 +6752,20 @@ void cAnalyze::CommandMapMutations(cString cur_string)
     
     cString color_string;  // For coloring cells...
     
-    // Loop through all the lines of code, testing all mutations...
+    // Test every mutation (and then the knockout) of every line as its own job.  Results are read back below in the
+    // same order.
+    cGenomeScan mut_scan(m_world, base_genome);
+    for (int line_num = 0; line_num < max_line; line_num++) {
+      const int cur_inst = base_seq[line_num].GetOp();
+      for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
+        if (mod_inst != cur_inst) mut_scan.AddVariant(line_num, mod_inst);
+      }
+      mut_scan.AddVariant(line_num, null_inst.GetOp());
+    }
+    mut_scan.Run(m_jobqueue, m_ctx);
+    int next_variant = 0;
+    
+    // Loop through all the lines of code, writing out all mutations...
     for (int line_num = 0; line_num < max_line; line_num++) {
       int cur_inst = base_seq[line_num].GetOp();
       char cur_symbol = base_seq[line_num].GetSymbol()[0]; // hack to work around multichar symbols
@@ -6828,10 +6790,7 @@ void cAnalyze::CommandMapMutations(cString cur_string)
           }
         }
         else {
-          seq[line_num].SetOp(mod_inst);
-          cAnalyzeGenotype test_genotype(m_world, mod_genome);
-          test_genotype.Recalculate(m_ctx);
-          const double test_fitness = test_genotype.GetFitness() / base_fitness;
+          const double test_fitness = mut_scan.GetFitness(next_variant++) / base_fitness;
           row_fitness += test_fitness;
           total_fitness += test_fitness;
           col_fitness[mod_inst] += test_fitness;
@@ -6864,10 +6823,7 @@ void cAnalyze::CommandMapMutations(cString cur_string)
       }
       
       // Column: Knockout
-      seq[line_num] = null_inst;
-      cAnalyzeGenotype test_genotype(m_world, mod_genome);
-      test_genotype.Recalculate(m_ctx);
-      const double test_fitness = test_genotype.GetFitness() / base_fitness;
+      const double test_fitness = mut_scan.GetFitness(next_variant++) / base_fitness;
       col_fitness[num_insts] += test_fitness;
       
       // Categorize this mutation if its in HTML mode (color only)...
@@ -6907,9 +6863,6 @@ void cAnalyze::CommandMapMutations(cString cur_string)
       // End this row...
       if (file_type == FILE_TYPE_HTML) fp << "</tr>";
       fp << endl;
-      
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
     }
     
     
@@ -9094,9 +9047,6 @@ void cAnalyze::AnalyzeComplexityTwoSites(cString cur_string)
     cout << "  - Convergence accuracy: " << converg_accuracy << endl;
   }
 
-  // test cpu
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(m_ctx);
-  
   // get current batch
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
   cAnalyzeGenotype * genotype = NULL;
@@ -9150,132 +9100,29 @@ void cAnalyze::AnalyzeComplexityTwoSites(cString cur_string)
     base_seq_p.DynamicCastFrom(rep_p);
     const InstructionSequence& base_seq = *base_seq_p;
     
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& seq = *mod_seq_p;
+    // Every site and every pair of sites is tested and solved as its own job
+    cTwoSiteComplexity complexity(m_world, base_genome, genotype->GetFitness(), mut_rate, converg_accuracy);
+    complexity.Run(m_jobqueue, m_ctx);
     
-    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
     /*
      * 
      *  ONE SITE CALCULATIONS
      * 
      */
-     
-    // single site entropies for use with
-    // two site calculations (below)
-    Apto::Array<double> entropy_ss_mers(max_line);
-    Apto::Array<double> entropy_ss_bits(max_line);
-    // used in single site calculations
-    Apto::Array<double> test_fitness(num_insts);
-    Apto::Array<double> prob(num_insts);
-    Apto::Array<double> prob_next(num_insts);
     
-    // run through lines in genome
     for (int line_num = 0; line_num < max_line; line_num++) {
-      // get the current instruction at this line/site
-      int cur_inst = base_seq[line_num].GetOp();
-      
-      // recalculate fitness of each mutant.
-      for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
-        seq[line_num].SetOp(mod_inst);
-        cAnalyzeGenotype test_genotype(m_world, mod_genome);
-        test_genotype.Recalculate(m_ctx);
-        test_fitness[mod_inst] = test_genotype.GetFitness();
-      }
-      
-      // Adjust fitness
-      // - set all fitness values greater than current instruction
-      // equal to current instruction fitness
-      // - make the rest of the fitness values relative to 
-      // the current instruction fitness
-      double cur_inst_fitness = test_fitness[cur_inst];
-      // test that current fitness greater than zero
-      // if NOT, all fitnesses will be set to zero
-      if (cur_inst_fitness > 0.0) {
-        for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
-          if (test_fitness[mod_inst] > cur_inst_fitness)
-            test_fitness[mod_inst] = cur_inst_fitness;
-          test_fitness[mod_inst] /= cur_inst_fitness;
-        }
-      } else {
+      const cTwoSiteComplexity::sSiteResult& site = complexity.GetSite(line_num);
+      if (!site.viable) {
         cout << "Fitness of this genotype is ZERO--no information." << endl;
         continue;
       }
-           
-      // initialize prob for
-      // mutation-selection balance
-      double fitness_total = 0.0;
-      for (int i = 0; i < num_insts; i ++ ) {
-        fitness_total += test_fitness[i];
-      }
-      for (int i = 0; i < num_insts; i ++ ) {
-        prob[i] = test_fitness[i]/fitness_total;
-        prob_next[i] = 0.0;
-      }
-      
-      double check_sum = 0.0;
-      while(1) {
-        check_sum = 0.0;
-        double delta_prob = 0.0;
-        //double delta_prob_ex = 0.0;
-        for (int mod_inst = 0; mod_inst < num_insts; mod_inst ++) {  
-          // calculate the average fitness
-          double w_avg = 0.0;
-          for (int i = 0; i < num_insts; i++) {
-            w_avg += prob[i]*test_fitness[i];
-          }
-          if (mut_rate != 0.0) {
-            // run mutation-selection equation
-            prob_next[mod_inst] = ((1.0-mut_rate)*test_fitness[mod_inst]*prob[mod_inst])/(w_avg);
-            prob_next[mod_inst] += mut_rate/((double)num_insts);
-          } else {
-            // run selection equation
-            prob_next[mod_inst] = (test_fitness[mod_inst]*prob[mod_inst])/(w_avg);
-          }
-          // increment change in probs
-          delta_prob += (prob_next[mod_inst]-prob[mod_inst])*(prob_next[mod_inst]-prob[mod_inst]);
-          //delta_prob_ex += (prob_next[mod_inst]-prob[mod_inst]);
-        }
-        // transfer t+1 to t for next iteration
-        for (int i = 0; i < num_insts; i++) {
-          prob[i]=prob_next[i];
-          check_sum += prob[i]; 
-        }
-        
-        // test for convergence
-        if (delta_prob < converg_accuracy)
-          break;
-      }
       
-      // Calculate complexity and entropy in bits and mers
-      double entropy_mers = 0;
-      double entropy_bits = 0;
-      for (int i = 0; i < num_insts; i ++) {
-        // watch for prob[i] == 0
-        // --> 0.0 log(0.0) = 0.0
-        if (prob[i] != 0.0) { 
-          entropy_mers += prob[i] * log((double) 1.0/prob[i]) / log ((double) num_insts);
-          entropy_bits += prob[i] * log((double) 1.0/prob[i]) / log ((double) 2.0);
-        }
-      }
-      double complexity_mers = 1 - entropy_mers;
-      double complexity_bits = (log ((double) num_insts) / log ((double) 2.0)) - entropy_bits;
-            
       // update entropy and complexity values
       // with this site's values
-      genome_ss_entropy_mers += entropy_mers;
-      genome_ss_entropy_bits += entropy_bits;
-      genome_ss_complexity_mers += complexity_mers;
-      genome_ss_complexity_bits += complexity_bits;
-      
-      // save entropy for this line/site number
-      entropy_ss_mers[line_num] = entropy_mers;
-      entropy_ss_bits[line_num] = entropy_bits;
-      
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
+      genome_ss_entropy_mers += site.entropy_mers;
+      genome_ss_entropy_bits += site.entropy_bits;
+      genome_ss_complexity_mers += site.complexity_mers;
+      genome_ss_complexity_bits += site.complexity_bits;
     }
     
     /*
@@ -9284,228 +9131,34 @@ void cAnalyze::AnalyzeComplexityTwoSites(cString cur_string)
      * 
      */
     
-    // Loop through all the lines of code, 
-    // testing all TWO SITE mutations...
-    tMatrix<double> test_fitness_2s(num_insts,num_insts);
-    Apto::Array<double> prob_1s_i(num_insts);
-    Apto::Array<double> prob_1s_j(num_insts);
-    tMatrix<double> prob_2s(num_insts,num_insts);
-    tMatrix<double> prob_next_2s(num_insts,num_insts);
-    
-    // run through lines in genome
-    // - only consider lin_num2 > lin_num1 so that we don't consider
+    // pairs only consider line_num2 > line_num1 so that we don't consider
     // Mut Info [1][45] and Mut Info [45][1]
-    for (int line_num1 = 0; line_num1 < max_line; line_num1++) {
-      for (int line_num2 = line_num1+1; line_num2 < max_line; line_num2++) {
-        // debug
-        //cout << "line #1, #2: " << line_num1 << ", " << line_num2 << endl; 
-        
-        // get current instructions at site 1 and site 2
-        int cur_inst1 = base_seq[line_num1].GetOp();
-        int cur_inst2 = base_seq[line_num2].GetOp();
+    for (int i = 0; i < complexity.GetNumPairs(); i++) {
+      if (genotype->GetFitness() <= 0.0) {
+        // current fitness is not greater than zero--skip
+        cout << "Fitness of this genotype is ZERO--no information." << endl;
+        continue;
+      }
       
-        // get current fitness
-        double cur_inst_fitness_2s = genotype->GetFitness();
-        
-        // initialize running fitness total
-        double fitness_total_2s = 0.0;
-        
-        // test that current fitness is greater than zero
-        if (cur_inst_fitness_2s > 0.0) {
-          // current fitness greater than zero
-          // run through all possible instructions
-          for (int mod_inst1 = 0; mod_inst1 < num_insts; mod_inst1++) {
-            for (int mod_inst2 = 0; mod_inst2 < num_insts; mod_inst2++) {
-              // modify mod_genome at two sites
-              seq[line_num1].SetOp(mod_inst1);
-              seq[line_num2].SetOp(mod_inst2);
-              // analyze mod_genome
-              cAnalyzeGenotype test_genotype(m_world, mod_genome);
-              test_genotype.Recalculate(m_ctx);
-              test_fitness_2s[mod_inst1][mod_inst2] = test_genotype.GetFitness();
-              
-              // if modified fitness is greater than current fitness
-              //  - set equal to current fitness
-              if (test_fitness_2s[mod_inst1][mod_inst2] > cur_inst_fitness_2s)
-                test_fitness_2s[mod_inst1][mod_inst2] = cur_inst_fitness_2s;
-              
-              // in all cases, scale fitness relative to current fitness
-              test_fitness_2s[mod_inst1][mod_inst2] /= cur_inst_fitness_2s;
-              
-              // update fitness total
-              fitness_total_2s += test_fitness_2s[mod_inst1][mod_inst2];
-            }
-          }
-        } else {
-          // current fitness is not greater than zero--skip
-          cout << "Fitness of this genotype is ZERO--no information." << endl;
-          continue;
-        }
-        
-        // initialize probabilities
-        for (int i = 0; i < num_insts; i++ ) {
-          // single site probabilities
-          // to be built from two site probabilities
-          prob_1s_i[i] = 0.0;
-          prob_1s_j[i] = 0.0;
-          for (int j = 0; j < num_insts; j++ ) {
-            // intitialize two site probability with
-            // relative fitness
-            prob_2s[i][j] = test_fitness_2s[i][j]/fitness_total_2s;
-            prob_next_2s[i][j] = 0.0;
-          }
-        }
+      const cTwoSiteComplexity::sPairResult& pair = complexity.GetPair(i);
       
-        double check_sum_2s = 0.0;
-        while(1) {
-          check_sum_2s = 0.0;
-          double delta_prob_2s = 0.0;
-          //double delta_prob_ex = 0.0;
-          for (int mod_inst1 = 0; mod_inst1 < num_insts; mod_inst1 ++) {
-            for (int mod_inst2 = 0; mod_inst2 < num_insts; mod_inst2 ++) {  
-              // calculate the average fitness
-              double w_avg_2s = 0.0;
-              for (int i = 0; i < num_insts; i++) {
-                for (int j = 0; j < num_insts; j++) {
-                  w_avg_2s += prob_2s[i][j]*test_fitness_2s[i][j];
-                }
-              }
-              if (mut_rate != 0.0) {
-                // run mutation-selection equation
-                // -term 1
-                prob_next_2s[mod_inst1][mod_inst2] = ((1.0-mut_rate)*(1.0-mut_rate)*test_fitness_2s[mod_inst1][mod_inst2]*prob_2s[mod_inst1][mod_inst2])/(w_avg_2s);
-                // -term 2
-                double sum_term2 = 0.0;
-                for (int i = 0; i < num_insts; i++) {
-                  sum_term2 += (test_fitness_2s[i][mod_inst2]*prob_2s[i][mod_inst2])/(w_avg_2s);
-                }
-                prob_next_2s[mod_inst1][mod_inst2] += (((mut_rate*(1.0-mut_rate))/((double)num_insts)))*sum_term2;
-                // -term 3
-                double sum_term3 = 0.0;
-                for (int j = 0; j < num_insts; j++) {
-                  sum_term3 += (test_fitness_2s[mod_inst1][j]*prob_2s[mod_inst1][j])/(w_avg_2s);
-                }
-                prob_next_2s[mod_inst1][mod_inst2] += (((mut_rate*(1.0-mut_rate))/((double)num_insts)))*sum_term3;
-                // -term 4
-                prob_next_2s[mod_inst1][mod_inst2] += (mut_rate/((double)num_insts))*(mut_rate/((double)num_insts));
-              } else {
-                // run selection equation
-                prob_next_2s[mod_inst1][mod_inst2] = (test_fitness_2s[mod_inst1][mod_inst2]*prob_2s[mod_inst1][mod_inst2])/(w_avg_2s);
-                                
-              }
-              // increment change in probs
-              delta_prob_2s += (prob_next_2s[mod_inst1][mod_inst2]-prob_2s[mod_inst1][mod_inst2])*(prob_next_2s[mod_inst1][mod_inst2]-prob_2s[mod_inst1][mod_inst2]);
-              //delta_prob_ex += (prob_next[mod_inst]-prob[mod_inst]);
-            }
-          }
-          // transfer probabilities at time t+1 
-          // to t for next iteration
-          for (int i = 0; i < num_insts; i++) {
-            for (int j = 0; j < num_insts; j++) {
-              prob_2s[i][j]=prob_next_2s[i][j];
-              check_sum_2s += prob_2s[i][j];
-            } 
-          }
-        
-          // test for convergence
-          if (delta_prob_2s < converg_accuracy)
-            break;
-        }
-
-        // get single site probabilites from 
-        // two site probabilities
-        // site i (first site)
-        double check_prob_sum_site_1 = 0.0;
-        double check_prob_sum_site_2 = 0.0;
-        for (int i = 0; i < num_insts; i++) {
-          for (int j = 0; j < num_insts; j++) {
-            prob_1s_i[i] += prob_2s[i][j];
-          }
-          check_prob_sum_site_1 += prob_1s_i[i]; 
-        }
-        // site j (second site)
-        for (int j = 0; j < num_insts; j++) {
-          for (int i = 0; i < num_insts; i++) {
-            prob_1s_j[j] += prob_2s[i][j];
-          }
-          check_prob_sum_site_2 += prob_1s_j[j];
-        }
-
-        // Calculate one site and two versions of 
-        // complexity and entropy in bits and mers
-        //-mers
-        double entropy_ss_site1_mers = 0.0;
-        double entropy_ss_site2_mers = 0.0;
-        double entropy_ds_mers = 0.0;
-        //-bits
-        double entropy_ss_site1_bits = 0.0;
-        double entropy_ss_site2_bits = 0.0;
-        double entropy_ds_bits = 0.0;
-        
-        // single site entropies
-        for (int i = 0; i < num_insts; i ++) {
-          // watch for zero probabilities
-          if (prob_1s_i[i] != 0.0) {
-            // mers
-            entropy_ss_site1_mers += prob_1s_i[i] * log((double) 1.0/prob_1s_i[i]) / log ((double) num_insts);
-            // bits
-            entropy_ss_site1_bits += prob_1s_i[i] * log((double) 1.0/prob_1s_i[i]) / log ((double) 2.0);
-          }
-          if (prob_1s_j[i] != 0.0) {
-            // mers
-            entropy_ss_site2_mers += prob_1s_j[i] * log((double) 1.0/prob_1s_j[i]) / log ((double) num_insts);
-            // bits
-            entropy_ss_site2_bits += prob_1s_j[i] * log((double) 1.0/prob_1s_j[i]) / log ((double) 2.0);
-          }
-        }
-        
-        // two site joint entropies
-        for (int i = 0; i < num_insts; i ++) {
-          for (int j = 0; j < num_insts; j ++) {
-            // watch for zero probabilities
-            if (prob_2s[i][j] != 0.0) {
-              // two site entropy in mers
-              entropy_ds_mers += prob_2s[i][j] * log((double) 1.0/prob_2s[i][j]) / log ((double) num_insts);
-              // two site entropy in bitss
-              entropy_ds_bits += prob_2s[i][j] * log((double) 1.0/prob_2s[i][j]) / log ((double) 2.0);
-            }
-          }
-        }
-        
-        // calculate the mutual information
-        // - add single site entropies
-        // - subtract two site joint entropy
-        // units: mers
-        double mutual_information_mers = entropy_ss_site1_mers + entropy_ss_site2_mers;
-        mutual_information_mers -= entropy_ds_mers;
-        
-        // units: bits
-        double mutual_information_bits = entropy_ss_site1_bits + entropy_ss_site2_bits;
-        mutual_information_bits -= entropy_ds_bits;
-        
-        // two site, only update mutatual informtion total
-        genome_ds_mut_info_mers += mutual_information_mers;
-        genome_ds_mut_info_bits += mutual_information_bits;
-        
-        // write output to file
-        fp_2s->Write(line_num1,                    "Site 1 in genome");
-        fp_2s->Write(line_num2,                    "Site 2 in genome");
-        fp_2s->Write(cur_inst1,                    "Current Instruction, Site 1");
-        fp_2s->Write(cur_inst2,                    "Current Instruction, Site 2");
-        fp_2s->Write(entropy_ss_mers[line_num1],   "Entropy (MERS), Site 1 -- single site mut-sel balance");
-        fp_2s->Write(entropy_ss_site1_mers,        "Entropy (MERS), Site 1 -- TWO site mut-sel balance");
-        fp_2s->Write(entropy_ss_mers[line_num2],   "Entropy (MERS), Site 2 -- single site mut-sel balance");
-        fp_2s->Write(entropy_ss_site2_mers,        "Entropy (MERS), Site 2 -- TWO site mut-sel balance");
-        fp_2s->Write(entropy_ds_mers,              "Joint Entropy (MERS), Site 1 & 2 -- TWO site mut-sel balance");
-        fp_2s->Write(mutual_information_mers,      "Mutual Information (MERS), Site 1 & 2 -- TWO site mut-sel balance");
-        fp_2s->Endl();
-                    
-        // Reset the mod_genome back to the original sequence.
-        seq[line_num1].SetOp(cur_inst1);
-        seq[line_num2].SetOp(cur_inst2);
-        
-      }// end line 2
-    }// end line 1
+      // two site, only update mutatual informtion total
+      genome_ds_mut_info_mers += pair.mut_info_mers;
+      genome_ds_mut_info_bits += pair.mut_info_bits;
+      
+      // write output to file
+      fp_2s->Write(pair.site1,                                          "Site 1 in genome");
+      fp_2s->Write(pair.site2,                                          "Site 2 in genome");
+      fp_2s->Write(base_seq[pair.site1].GetOp(),                        "Current Instruction, Site 1");
+      fp_2s->Write(base_seq[pair.site2].GetOp(),                        "Current Instruction, Site 2");
+      fp_2s->Write(complexity.GetSite(pair.site1).entropy_mers,         "Entropy (MERS), Site 1 -- single site mut-sel balance");
+      fp_2s->Write(pair.entropy_site1_mers,                             "Entropy (MERS), Site 1 -- TWO site mut-sel balance");
+      fp_2s->Write(complexity.GetSite(pair.site2).entropy_mers,         "Entropy (MERS), Site 2 -- single site mut-sel balance");
+      fp_2s->Write(pair.entropy_site2_mers,                             "Entropy (MERS), Site 2 -- TWO site mut-sel balance");
+      fp_2s->Write(pair.entropy_joint_mers,                             "Joint Entropy (MERS), Site 1 & 2 -- TWO site mut-sel balance");
+      fp_2s->Write(pair.mut_info_mers,                                  "Mutual Information (MERS), Site 1 & 2 -- TWO site mut-sel balance");
+      fp_2s->Endl();
+    }
     
     // calculate the two site complexity
     // (2 site complexity) = (1 site complexity) + (total 2 site mutual info)
@@ -9535,8 +9188,6 @@ void cAnalyze::AnalyzeComplexityTwoSites(cString cur_string)
     }
     if(genotype == NULL) { break; }
   }
-  
-  delete testcpu;
 }
 
 void cAnalyze::AnalyzePopComplexity(cString cur_string)
@@ -9982,19 +9633,10 @@ void cAnalyze::BatchRecalculate(cString cur_string)
     cerr << "warning: " << msg << endl;
   }
   
-  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * genotype = NULL;
-  cAnalyzeGenotype * last_genotype = NULL;
-  while ((genotype = batch_it.Next()) != NULL) {    
-    // If the previous genotype was the parent of this one, pass in a pointer
-    // to it for improved recalculate (such as distance to parent, etc.)
-    if (last_genotype != NULL && genotype->GetParentID() == last_genotype->GetID()) {
-      genotype->Recalculate(m_ctx, &test_info, last_genotype);
-    } else {
-      genotype->Recalculate(m_ctx, &test_info);
-    }
-    last_genotype = genotype;
-  }
+  // Where the previous genotype is the parent of the next one, it is used
+  // for improved recalculate (such as distance to parent, etc.)
+  cBatchRecalculation recalc(m_world, test_info);
+  recalc.Run(m_jobqueue, m_ctx, batch[cur_batch].List());
     
   return;
 }
@@ -10075,19 +9717,10 @@ void cAnalyze::BatchRecalculateWithArgs(cString cur_string)
     cerr << "warning: " << msg << endl;
   }
   
-  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * genotype = NULL;
-  cAnalyzeGenotype * last_genotype = NULL;
-  while ((genotype = batch_it.Next()) != NULL) {    
-    // If the previous genotype was the parent of this one, pass in a pointer
-    // to it for improved recalculate (such as distance to parent, etc.)
-    if (last_genotype != NULL && genotype->GetParentID() == last_genotype->GetID()) {
-      genotype->Recalculate(m_ctx, &test_info, last_genotype, num_trials);
-    } else {
-      genotype->Recalculate(m_ctx, &test_info, NULL, num_trials);
-    }
-    last_genotype = genotype;
-  }
+  // Where the previous genotype is the parent of the next one, it is used
+  // for improved recalculate (such as distance to parent, etc.)
+  cBatchRecalculation recalc(m_world, test_info, num_trials);
+  recalc.Run(m_jobqueue, m_ctx, batch[cur_batch].List());
   
   return;
 }
@@ -10888,6 +10521,7 @@ void cAnalyze::SetupCommandDefLibrary()
   
   // Reduction and sampling commands...
   AddLibraryDef("FILTER", &cAnalyze::CommandFilter);
+  AddLibraryDef("SORT", &cAnalyze::CommandSort);
   AddLibraryDef("FIND_GENOTYPE", &cAnalyze::FindGenotype);
   AddLibraryDef("FIND_ORGANISM", &cAnalyze::FindOrganism);
   AddLibraryDef("FIND_LINEAGE", &cAnalyze::FindLineage);
@@ -10928,6 +10562,7 @@ void cAnalyze::SetupCommandDefLibrary()
   AddLibraryDef("MAP_TASKS", &cAnalyze::CommandMapTasks);
   AddLibraryDef("AVERAGE_MODULARITY", &cAnalyze::CommandAverageModularity);
   AddLibraryDef("CALC_FUNCTIONAL_MODULARITY", &cAnalyze::CommandCalcFunctionalModularity);
+  AddLibraryDef("ANALYZE_MODULARITY", &cAnalyze::CommandAnalyzeModularity);
   AddLibraryDef("ANALYZE_REDUNDANCY_BY_INST_FAILURE", &cAnalyze::CommandAnalyzeRedundancyByInstFailure);
   AddLibraryDef("MAP_MUTATIONS", &cAnalyze::CommandMapMutations);
   AddLibraryDef("ANALYZE_COMPLEXITY", &cAnalyze::AnalyzeComplexity);
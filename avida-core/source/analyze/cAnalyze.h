@@ -213,6 +213,7 @@ private:
   
   // Reduction and Sampling
   void CommandFilter(cString cur_string);
+  void CommandSort(cString cur_string);
   void FindGenotype(cString cur_string);
   void FindOrganism(cString cur_string);
   void FindLineage(cString cur_string);
@@ -315,6 +315,18 @@ dcm->Add(KEYWORD, new tDataEntryOfType<cAnalyzeGenotype, TYPE>
   ADD_GDATA(cString (), "dom_sequence", "Dominant Genotype Sequence",      GetSequence,   SetNULL,       0, "(N/A)", "");
   
   
+  // Landscape and plasticity stats are calculated on first use through the world's default context, so they must not be
+  // read from more than one thread at a time
+  const char* recalculated_entries[] = {
+    "frac_dead", "frac_neg", "frac_neut", "frac_pos", "complexity", "land_fitness",
+    "num_phen", "num_trials", "phen_entropy", "phen_max_fitness", "phen_max_fit_freq", "phen_min_fitness",
+    "phen_min_freq", "phen_avg_fitness", "phen_likely_freq", "phen_likely_fitness", "prob_viable", "prob_task"
+  };
+  for (unsigned int i = 0; i < sizeof(recalculated_entries) / sizeof(recalculated_entries[0]); i++) {
+    dcm->SetConcurrent(recalculated_entries[i], false);
+  }
+  
+  
   return dcm;
 #undef ADD_GDATA
 }
@@ -557,7 +569,8 @@ void cAnalyzeGenotype::CalcLandscape(cAvidaContext& ctx)
 }
 
 
-void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info, cAnalyzeGenotype* parent_genotype, int num_trials)
+void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info, cAnalyzeGenotype* parent_genotype, int num_trials,
+                                   cTestCPU* testcpu)
 {  
   // Allocate our own test info if it wasn't provided
   cCPUTestInfo* local_test_info = NULL;
@@ -567,7 +580,7 @@ void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info,
   }
   
   // Handling recalculation here
-  cPhenPlastGenotype recalc_data(m_genome, num_trials, *test_info, m_world, ctx);
+  cPhenPlastGenotype recalc_data(m_genome, num_trials, *test_info, m_world, ctx, testcpu);
   
   // The most likely phenotype will be assigned to the phenotype stats
   const cPlasticPhenotype* likely_phenotype = recalc_data.GetMostLikelyPhenotype();
@@ -600,22 +613,7 @@ void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info,
   
   // Setup a new parent stats if we have a parent to work with.
   if (parent_genotype != NULL) {
-    fitness_ratio = GetFitness() / parent_genotype->GetFitness();
-    efficiency_ratio = GetEfficiency() / parent_genotype->GetEfficiency();
-    comp_merit_ratio = GetCompMerit() / parent_genotype->GetCompMerit();
-    ConstInstructionSequencePtr seq_p;
-    GeneticRepresentationPtr rep_p = m_genome.Representation();
-    seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& seq = *seq_p;
-    
-    const Genome& parent_genome = parent_genotype->GetGenome();
-    ConstInstructionSequencePtr parent_seq_p;
-    ConstGeneticRepresentationPtr parent_rep_p = parent_genome.Representation();
-    parent_seq_p.DynamicCastFrom(parent_rep_p);
-    const InstructionSequence& parent_seq = *parent_seq_p;
-    
-    parent_dist = cStringUtil::EditDistance((const char *)seq.AsString(), (const char *)parent_seq.AsString(), parent_muts);
-    
+    CalcParentStats(parent_genotype);
     ancestor_dist = parent_genotype->GetAncestorDist() + parent_dist;
   }
   
@@ -630,6 +628,55 @@ void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info,
 }
 
 
+void cAnalyzeGenotype::CopyRecalculation(const cAnalyzeGenotype& source)
+{
+  viable                = source.viable;
+  m_env_inputs          = source.m_env_inputs;
+  executed_flags        = source.executed_flags;
+  inst_executed_counts  = source.inst_executed_counts;
+  length                = source.length;
+  copy_length           = source.copy_length;
+  exe_length            = source.exe_length;
+  merit                 = source.merit;
+  gest_time             = source.gest_time;
+  fitness               = source.fitness;
+  errors                = source.errors;
+  div_type              = source.div_type;
+  mate_id               = source.mate_id;
+  task_counts           = source.task_counts;
+  task_qualities        = source.task_qualities;
+  internal_task_counts  = source.internal_task_counts;
+  internal_task_qualities = source.internal_task_qualities;
+  rbins_total           = source.rbins_total;
+  rbins_avail           = source.rbins_avail;
+  collect_spec_counts   = source.collect_spec_counts;
+  m_mating_type         = source.m_mating_type;
+  m_mate_preference     = source.m_mate_preference;
+  m_mating_display_a    = source.m_mating_display_a;
+  m_mating_display_b    = source.m_mating_display_b;
+}
+
+
+void cAnalyzeGenotype::CalcParentStats(const cAnalyzeGenotype* parent_genotype)
+{
+  fitness_ratio = GetFitness() / parent_genotype->GetFitness();
+  efficiency_ratio = GetEfficiency() / parent_genotype->GetEfficiency();
+  comp_merit_ratio = GetCompMerit() / parent_genotype->GetCompMerit();
+  ConstInstructionSequencePtr seq_p;
+  GeneticRepresentationPtr rep_p = m_genome.Representation();
+  seq_p.DynamicCastFrom(rep_p);
+  const InstructionSequence& seq = *seq_p;
+  
+  const Genome& parent_genome = parent_genotype->GetGenome();
+  ConstInstructionSequencePtr parent_seq_p;
+  ConstGeneticRepresentationPtr parent_rep_p = parent_genome.Representation();
+  parent_seq_p.DynamicCastFrom(parent_rep_p);
+  const InstructionSequence& parent_seq = *parent_seq_p;
+  
+  parent_dist = cStringUtil::EditDistance((const char *)seq.AsString(), (const char *)parent_seq.AsString(), parent_muts);
+}
+
+
 void cAnalyzeGenotype::PrintTasks(ofstream& fp, int min_task, int max_task)
 {
   if (max_task == -1) max_task = task_counts.GetSize();
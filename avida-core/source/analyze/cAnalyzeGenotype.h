@@ -231,7 +231,13 @@ public:
   
   void SetCPUTestInfo(cCPUTestInfo& in_cpu_test_info) { m_cpu_test_info = in_cpu_test_info; }
   
-  void Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info = NULL, cAnalyzeGenotype* parent_genotype = NULL, int num_trials = 1);
+  void Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info = NULL, cAnalyzeGenotype* parent_genotype = NULL, int num_trials = 1,
+                   cTestCPU* testcpu = NULL);
+  
+  // Takes the test CPU results of a previous Recalculate() of a genotype with an identical genome
+  void CopyRecalculation(const cAnalyzeGenotype& source);
+  // Parent relative stats (fitness ratios and distance to parent), but not the ancestor distance that depends on them
+  void CalcParentStats(const cAnalyzeGenotype* parent_genotype);
   void PrintTasks(std::ofstream& fp, int min_task = 0, int max_task = -1);
   void PrintTasksQuality(std::ofstream& fp, int min_task = 0, int max_task = -1);
   void PrintInternalTasks(std::ofstream& fp, int min_task = 0, int max_task = -1);
@@ -23,6 +23,7 @@
 #define cAnalyzeJob_h
 
 class cAvidaContext;
+class cTestCPU;
 
 class cAnalyzeJob
 {
@@ -37,6 +38,11 @@ public:
   int GetID() { return m_id; }
   
   virtual void Run(cAvidaContext& ctx) = 0;
+  
+  // Jobs that test genomes can return true here to be run by RunOnTestCPU() instead, with the test CPU owned by the
+  // executing worker.  That test CPU is reused for every such job the worker runs.
+  virtual bool UsesTestCPU() const { return false; }
+  virtual void RunOnTestCPU(cAvidaContext& ctx, cTestCPU*) { Run(ctx); }
 };
 
 #endif
@@ -27,6 +27,8 @@
 #include "avida/core/WorldDriver.h"
 
 #include "cAnalyzeJobWorker.h"
+#include "cHardwareManager.h"
+#include "cTestCPU.h"
 #include "cWorld.h"
 
 
@@ -39,12 +41,16 @@ using namespace Avida;
 
 cAnalyzeJobQueue::cAnalyzeJobQueue(cWorld* world)
 : m_world(world), m_last_jobid(0), m_jobs(0), m_pending(0), m_workers(Apto::Platform::AvailableCPUs())
+, m_testcpu(NULL)
 {
   const int max_workers = world->GetConfig().MAX_CONCURRENCY.Get();
   if (max_workers > 0 && max_workers < m_workers.GetSize()) m_workers.Resize(max_workers);
   
   m_job_seed_rng = new Apto::RNG::AvidaRNG(world->GetRandom().GetInt(world->GetRandom().MaxSeed()));
   
+  // Seeded from the configuration rather than the world's generator, so that it draws nothing from that stream
+  m_submit_seed_rng = new Apto::RNG::AvidaRNG(world->GetConfig().RANDOM_SEED.Get());
+  
   if (m_workers.GetSize() > 1) {
     for (int i = 0; i < m_workers.GetSize(); i++) {
       m_workers[i] = new cAnalyzeJobWorker(this);
@@ -79,6 +85,8 @@ cAnalyzeJobQueue::~cAnalyzeJobQueue()
   }
   
   delete m_job_seed_rng;
+  delete m_submit_seed_rng;
+  delete m_testcpu;
 }
 
 inline void cAnalyzeJobQueue::queueJob(cAnalyzeJob* job)
@@ -137,7 +145,12 @@ void cAnalyzeJobQueue::singleThreadedJobExecution(cAnalyzeJob* job)
 {
   Apto::RNG::AvidaRNG rng(GetSeedForJob(job->GetID()));
   cAvidaContext ctx(&m_world->GetDriver(), rng);
-  job->Run(ctx);
+  if (job->UsesTestCPU()) {
+    if (!m_testcpu) m_testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+    job->RunOnTestCPU(ctx, m_testcpu);
+  } else {
+    job->Run(ctx);
+  }
   delete job;
 }
 
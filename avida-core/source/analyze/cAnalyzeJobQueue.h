@@ -29,6 +29,7 @@
 #include "tList.h"
 
 class cAnalyzeJobWorker;
+class cTestCPU;
 class cWorld;
 
 #if APTO_PLATFORM(WINDOWS) && defined(AddJob)
@@ -48,6 +49,7 @@ private:
   tList<cAnalyzeJob> m_queue;
   int m_last_jobid;
   Apto::Random* m_job_seed_rng;
+  Apto::Random* m_submit_seed_rng;  // Seeds handed out as jobs are submitted, never drawn by the workers
   Apto::Mutex m_mutex;
   Apto::ConditionVariable m_cond;
   Apto::ConditionVariable m_term_cond;
@@ -56,6 +58,7 @@ private:
   volatile int m_pending;   // count of currently executing jobs
   
   Apto::Array<cAnalyzeJobWorker*> m_workers;
+  cTestCPU* m_testcpu;      // used by test jobs when there are no workers
 
 
   void singleThreadedJobExecution(cAnalyzeJob* job);
@@ -78,6 +81,7 @@ public:
   void Execute();
   
   int GetSeedForJob(int jobid) { Apto::MutexAutoLock lock(m_mutex); return m_job_seed_rng->GetInt(m_job_seed_rng->MaxSeed()); }
+  int GetSeedForSubmission() { Apto::MutexAutoLock lock(m_mutex); return m_submit_seed_rng->GetInt(m_submit_seed_rng->MaxSeed()); }
 };
 
 #endif
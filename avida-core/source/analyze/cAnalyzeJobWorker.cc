@@ -23,15 +23,23 @@
 
 #include "cAnalyzeJobQueue.h"
 #include "cAvidaContext.h"
+#include "cHardwareManager.h"
+#include "cTestCPU.h"
 #include "cWorld.h"
 
 
+OBJECT_POOL_THREAD_LOCAL bool cAnalyzeJobWorker::s_in_worker = false;
+
+
 void cAnalyzeJobWorker::Run()
 {
+  s_in_worker = true;
+  
   Apto::RNG::AvidaRNG rng;
   cAvidaContext ctx(&m_queue->m_world->GetDriver(), rng);
   ctx.SetAnalyzeMode();
   
+  cTestCPU* testcpu = NULL;  // created by the first job that needs one
   cAnalyzeJob* job = NULL;
   
   while (1) {
@@ -47,7 +55,12 @@ void cAnalyzeJobWorker::Run()
     if (job) {
       // Set RNG from the waiting pool and execute the job
       rng.ResetSeed(m_queue->GetSeedForJob(job->GetID()));
-      job->Run(ctx);
+      if (job->UsesTestCPU()) {
+        if (!testcpu) testcpu = m_queue->m_world->GetHardwareManager().CreateTestCPU(ctx);
+        job->RunOnTestCPU(ctx, testcpu);
+      } else {
+        job->Run(ctx);
+      }
       delete job;
       m_queue->m_mutex.Lock();
       int pending = --m_queue->m_pending;
@@ -62,4 +75,7 @@ void cAnalyzeJobWorker::Run()
       break;
     }
   }
+  
+  delete testcpu;
+  s_in_worker = false;
 }
@@ -24,6 +24,8 @@
 
 #include "apto/core/Thread.h"
 
+#include "cObjectPool.h"
+
 class cAnalyzeJobQueue;
 
 
@@ -32,10 +34,16 @@ class cAnalyzeJobWorker : public Apto::Thread
 private:
   cAnalyzeJobQueue* m_queue;
   
+  static OBJECT_POOL_THREAD_LOCAL bool s_in_worker;
+  
   void Run();
 
 public:
   cAnalyzeJobWorker(cAnalyzeJobQueue* queue) : m_queue(queue) { ; }  
+  
+  // True on an analyze worker thread, where the job queue already occupies the available CPUs and jobs should not
+  // start threads of their own
+  static bool InWorkerThread() { return s_in_worker; }
 };
 
 #endif
@@ -21,6 +21,7 @@
 #include "cAnalyzeTreeStats_CumulativeStemminess.h"
 
 #include "cAnalyzeGenotype.h"
+#include "cPhylogenyIndex.h"
 #include "cWorld.h"
 
 
@@ -93,17 +94,10 @@ void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGeno
     cout << "Scanning genotypes..." << endl;
   }
   Apto::Array<cAnalyzeGenotype *> gen_array(num_gens);
-  Apto::Map<int, int> id_hash;  // Store array pos for each id.
+  cPhylogenyIndex phylogeny(genotype_list);  // Nodes are array positions.
   Apto::Array<int> id_array(num_gens), pid_array(num_gens);
   Apto::Array<int> depth_array(num_gens), birth_array(num_gens);
 
-  array_pos = 0;
-  batch_it.Reset();
-  while ((genotype = batch_it.Next()) != NULL) {
-    id_hash.Set(genotype->GetID(), array_pos);
-    array_pos++;
-  }
-
   m_agl.Resize(num_gens);
   array_pos = 0;
   batch_it.Reset();
@@ -126,8 +120,6 @@ void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGeno
   Apto::Array<int> anc_branch_pos_array(num_gens);
   anc_branch_dist_array.SetAll(-1);
   anc_branch_pos_array.SetAll(-1);
-  bool found = true;
-  int loop_count = 0;
 
   /*
   Link each offspring to its parent. {{{4
@@ -140,8 +132,8 @@ void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGeno
     cAnalyzeGenotype * genotype = m_agl[pos].genotype;
     int parent_id = genotype->GetParentID();
     if (-1 != parent_id){
-      bool found_parent = id_hash.Get(parent_id, m_agl[pos].ppos);
-      if (found_parent){
+      m_agl[pos].ppos = phylogeny.GetParent(pos);
+      if (m_agl[pos].ppos != -1){
         int parent_position = m_agl[pos].ppos;
         m_agl[parent_position].offspring_positions.Push(pos);
         ///* XXX I think I'll be able to remove this. */
@@ -173,49 +165,22 @@ void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGeno
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
     cout << "Finding branch points..." << endl;
   }
-  found = true;
-  loop_count = 0;
-  while (found == true) {
-    if (false && m_world->GetVerbosity() >= VERBOSE_ON) {
-      cout << endl << "  wave " << loop_count << "...";
-    }
-    found = false;
-
-    int genotypes_already_set = 0;
-    int genotypes_identified_as_root = 0;
-    int genotypes_with_branching_parent = 0;
-    int genotypes_with_calced_parent = 0;
-    int genotypes_not_ready = 0;
-
-    for (int pos = 0; pos < num_gens; pos++) {
-      if (m_agl[pos].anc_branch_dist > -1){
-        genotypes_already_set++;
-        continue; // continue if its set.
-      }
-      found = true;
-      int parent_pos = m_agl[pos].ppos;
-      if (parent_pos == -1) {
-        genotypes_identified_as_root++;
-        m_agl[pos].anc_branch_dist = 0;  // Org is root.
-      } else if (m_agl[parent_pos].offspring_count > 1) {        // Parent is branch.
-        genotypes_with_branching_parent++;
-        m_agl[pos].anc_branch_dist = 1;
-        m_agl[pos].anc_branch_id = m_agl[parent_pos].id;
-        m_agl[pos].anc_branch_pos = parent_pos;
-      } else if (m_agl[parent_pos].anc_branch_dist > -1) {     // Parent calculated.
-        genotypes_with_calced_parent++;
-        m_agl[pos].anc_branch_dist = m_agl[parent_pos].anc_branch_dist + 1;
-        m_agl[pos].anc_branch_id = m_agl[parent_pos].anc_branch_id;
-        m_agl[pos].anc_branch_pos = m_agl[parent_pos].anc_branch_pos;
-      } else {
-        genotypes_not_ready++;
-        // Otherwise, we are not yet ready to calculate this entry.
-      }
-    }
-    if (false && m_world->GetVerbosity() >= VERBOSE_ON) {
-      cout << " (" << genotypes_already_set << "," << genotypes_identified_as_root << "," << genotypes_with_branching_parent << "," << genotypes_with_calced_parent << "," << genotypes_not_ready << ")" << endl;
+  // Visiting the genotypes in phylogeny preorder settles every parent before its offspring, so one pass suffices.
+  const Apto::Array<int>& preorder = phylogeny.GetPreorder();
+  for (int i = 0; i < preorder.GetSize(); i++) {
+    const int pos = preorder[i];
+    int parent_pos = m_agl[pos].ppos;
+    if (parent_pos == -1) {
+      m_agl[pos].anc_branch_dist = 0;  // Org is root.
+    } else if (m_agl[parent_pos].offspring_count > 1) {        // Parent is branch.
+      m_agl[pos].anc_branch_dist = 1;
+      m_agl[pos].anc_branch_id = m_agl[parent_pos].id;
+      m_agl[pos].anc_branch_pos = parent_pos;
+    } else {                                                   // Parent calculated.
+      m_agl[pos].anc_branch_dist = m_agl[parent_pos].anc_branch_dist + 1;
+      m_agl[pos].anc_branch_id = m_agl[parent_pos].anc_branch_id;
+      m_agl[pos].anc_branch_pos = m_agl[parent_pos].anc_branch_pos;
     }
-    loop_count++;
   }
 
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
@@ -0,0 +1,140 @@
+/*
+ *  cBatchRecalculation.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cBatchRecalculation.h"
+
+#include "cAnalyzeGenotype.h"
+#include "cAnalyzeJobQueue.h"
+#include "cHardwareManager.h"
+#include "cInstSet.h"
+#include "cWorld.h"
+#include "tAnalyzeTestJobBatch.h"
+
+
+// Parent stats are cheap next to a test CPU run, so they are handed out in blocks of genotypes
+static const int PARENT_STATS_BLOCK_SIZE = 64;
+
+
+cBatchRecalculation::cBatchRecalculation(cWorld* world, const cCPUTestInfo& test_info, int num_trials)
+  : m_world(world), m_test_info(test_info.GetGenerationTests()), m_num_trials(num_trials)
+{
+  m_test_info.CopySettings(test_info);
+}
+
+
+void cBatchRecalculation::Run(cAnalyzeJobQueue& queue, cAvidaContext& ctx, tList<cAnalyzeGenotype>& genotypes)
+{
+  m_genotypes.Resize(0);
+  m_source.Resize(0);
+  m_unique.Resize(0);
+  m_follows_parent.Resize(0);
+
+  // Collect the batch, matching each genotype to the first one with the same genome
+  Apto::Map<Apto::String, int> genome_index;
+  Apto::Map<Apto::String, bool> failing_sets;
+  const bool share_results = canShareResults();
+  tListIterator<cAnalyzeGenotype> batch_it(genotypes);
+  cAnalyzeGenotype* genotype = NULL;
+  cAnalyzeGenotype* last_genotype = NULL;
+  while ((genotype = batch_it.Next()) != NULL) {
+    const int idx = m_genotypes.GetSize();
+    m_genotypes.Push(genotype);
+    m_follows_parent.Push(last_genotype != NULL && genotype->GetParentID() == last_genotype->GetID());
+    last_genotype = genotype;
+
+    int source = idx;
+    bool share = false;
+    if (share_results) {
+      const Apto::String inst_set = genotype->GetGenome().Properties().Get("instset").StringValue();
+      bool can_fail = true;
+      if (!failing_sets.Get(inst_set, can_fail)) {
+        can_fail = hasFailingInsts(inst_set);
+        failing_sets.Set(inst_set, can_fail);
+      }
+      share = !can_fail;
+    }
+    if (share) {
+      Apto::String genome_str = genotype->GetGenome().AsString();
+      if (!genome_index.Get(genome_str, source)) {
+        source = idx;
+        genome_index.Set(genome_str, idx);
+      }
+    }
+    m_source.Push(source);
+    if (source == idx) m_unique.Push(idx);
+  }
+
+  // Run each distinct genome on a test CPU
+  tAnalyzeTestJobBatch<cBatchRecalculation> recalc_batch(m_world, queue);
+  for (int i = 0; i < m_unique.GetSize(); i++) recalc_batch.AddJob(this, &cBatchRecalculation::RecalculateGenotype, i);
+  recalc_batch.RunBatch();
+
+  for (int i = 0; i < m_genotypes.GetSize(); i++) {
+    if (m_source[i] != i) m_genotypes[i]->CopyRecalculation(*m_genotypes[m_source[i]]);
+  }
+
+  // Parent relative stats only read the (now complete) test CPU results of the parent
+  const int num_blocks = (m_genotypes.GetSize() + PARENT_STATS_BLOCK_SIZE - 1) / PARENT_STATS_BLOCK_SIZE;
+  tAnalyzeTestJobBatch<cBatchRecalculation> parent_batch(m_world, queue);
+  for (int i = 0; i < num_blocks; i++) parent_batch.AddJob(this, &cBatchRecalculation::CalcParentStatsBlock, i);
+  parent_batch.RunBatch();
+
+  // Ancestor distances accumulate down the lineage, so they must be done in order
+  for (int i = 1; i < m_genotypes.GetSize(); i++) {
+    if (m_follows_parent[i]) {
+      m_genotypes[i]->SetAncestorDist(m_genotypes[i - 1]->GetAncestorDist() + m_genotypes[i]->GetParentDist());
+    }
+  }
+}
+
+
+bool cBatchRecalculation::canShareResults() const
+{
+  return m_world->GetConfig().ANALYZE_SHARE_RECALC.Get() && m_num_trials == 1 && !m_test_info.GetUseRandomInputs() &&
+    m_world->GetConfig().AGE_DEVIATION.Get() <= 0;
+}
+
+
+bool cBatchRecalculation::hasFailingInsts(const Apto::String& inst_set) const
+{
+  const cInstSet& is = m_world->GetHardwareManager().GetInstSet(inst_set);
+  for (int i = 0; i < is.GetSize(); i++) if (is.GetProbFail(Instruction(i)) > 0.0) return true;
+  return false;
+}
+
+
+void cBatchRecalculation::RecalculateGenotype(cAvidaContext& ctx, cTestCPU* testcpu, int idx)
+{
+  cCPUTestInfo test_info(m_test_info.GetGenerationTests());
+  test_info.CopySettings(m_test_info);
+
+  m_genotypes[m_unique[idx]]->Recalculate(ctx, &test_info, NULL, m_num_trials, testcpu);
+}
+
+
+void cBatchRecalculation::CalcParentStatsBlock(cAvidaContext&, cTestCPU*, int block)
+{
+  const int start = Apto::Max(1, block * PARENT_STATS_BLOCK_SIZE);
+  const int stop = Apto::Min(m_genotypes.GetSize(), (block + 1) * PARENT_STATS_BLOCK_SIZE);
+  for (int i = start; i < stop; i++) {
+    if (m_follows_parent[i]) m_genotypes[i]->CalcParentStats(m_genotypes[i - 1]);
+  }
+}
@@ -0,0 +1,79 @@
+/*
+ *  cBatchRecalculation.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cBatchRecalculation_h
+#define cBatchRecalculation_h
+
+#include "apto/core.h"
+
+#include "cCPUTestInfo.h"
+#include "tList.h"
+
+class cAnalyzeGenotype;
+class cAnalyzeJobQueue;
+class cAvidaContext;
+class cTestCPU;
+class cWorld;
+
+
+// cBatchRecalculation - recalculates a batch (usually a lineage) of genotypes as analyze jobs (RECALCULATE, RECALC)
+//
+// Lineages repeat the same genome over many consecutive ancestors.  Whether a test run draws on the random number
+// generator cannot be told from the hardware, so by default every genotype is run on a test CPU.  When ANALYZE_SHARE_RECALC
+// states that the hardware is deterministic, a single trial is requested, and none of the known sources of randomness
+// are in use (random inputs, AGE_DEVIATION, instructions with a failure probability), each distinct genome is run only
+// once and its results are copied to every other genotype sharing it.
+// Parent relative stats are then calculated for every genotype whose predecessor in the batch is its parent, also in
+// parallel, and ancestor distances are accumulated in a final pass in batch order.  The results are the same as
+// recalculating each genotype in order with its parent.
+
+class cBatchRecalculation
+{
+private:
+  cWorld* m_world;
+  cCPUTestInfo m_test_info;     // settings only, copied for every job
+  int m_num_trials;
+
+  Apto::Array<cAnalyzeGenotype*> m_genotypes;   // in batch order
+  Apto::Array<int> m_source;                    // genotype whose recalculation each genotype takes
+  Apto::Array<int> m_unique;                    // genotypes that are actually recalculated
+  Apto::Array<bool> m_follows_parent;           // whether the preceding genotype is the parent
+
+
+  cBatchRecalculation(); // @not_implemented
+  cBatchRecalculation(const cBatchRecalculation&); // @not_implemented
+  cBatchRecalculation& operator=(const cBatchRecalculation&); // @not_implemented
+
+
+public:
+  cBatchRecalculation(cWorld* world, const cCPUTestInfo& test_info, int num_trials = 1);
+
+  void Run(cAnalyzeJobQueue& queue, cAvidaContext& ctx, tList<cAnalyzeGenotype>& genotypes);
+
+  void RecalculateGenotype(cAvidaContext& ctx, cTestCPU* testcpu, int idx);
+  void CalcParentStatsBlock(cAvidaContext& ctx, cTestCPU* testcpu, int block);
+
+private:
+  bool canShareResults() const;
+  bool hasFailingInsts(const Apto::String& inst_set) const;
+};
+
+#endif
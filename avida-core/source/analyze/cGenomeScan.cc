@@ -0,0 +1,106 @@
+/*
+ *  cGenomeScan.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGenomeScan.h"
+
+#include "avida/core/InstructionSequence.h"
+
+#include "cAnalyzeGenotype.h"
+#include "cAnalyzeJobQueue.h"
+#include "tAnalyzeTestJobBatch.h"
+
+
+cGenomeScan::cGenomeScan(cWorld* world, const Genome& base_genome, const cCPUTestInfo* test_info, bool keep_genotypes)
+  : m_world(world), m_base_genome(base_genome)
+  , m_test_info((test_info) ? test_info->GetGenerationTests() : nHardware::TEST_CPU_GENERATIONS)
+  , m_keep_genotypes(keep_genotypes)
+{
+  if (test_info) m_test_info.CopySettings(*test_info);
+}
+
+cGenomeScan::~cGenomeScan()
+{
+  Clear();
+}
+
+
+int cGenomeScan::addVariant(int site1, int inst1, int site2, int inst2)
+{
+  sVariant variant;
+  variant.site1 = site1;
+  variant.inst1 = inst1;
+  variant.site2 = site2;
+  variant.inst2 = inst2;
+  m_variants.Push(variant);
+  return m_variants.GetSize() - 1;
+}
+
+
+void cGenomeScan::Run(cAnalyzeJobQueue& queue, cAvidaContext& ctx)
+{
+  const int first = m_fitness.GetSize();
+  const int num_variants = m_variants.GetSize();
+  m_fitness.Resize(num_variants);
+  m_genotypes.Resize(num_variants);
+  for (int i = first; i < num_variants; i++) {
+    m_fitness[i] = 0.0;
+    m_genotypes[i] = NULL;
+  }
+
+  tAnalyzeTestJobBatch<cGenomeScan> jobbatch(m_world, queue);
+  for (int i = first; i < num_variants; i++) jobbatch.AddJob(this, &cGenomeScan::TestVariant, i);
+  jobbatch.RunBatch();
+}
+
+
+void cGenomeScan::Clear()
+{
+  for (int i = 0; i < m_genotypes.GetSize(); i++) delete m_genotypes[i];
+  m_variants.Resize(0);
+  m_fitness.Resize(0);
+  m_genotypes.Resize(0);
+}
+
+
+void cGenomeScan::TestVariant(cAvidaContext& ctx, cTestCPU* testcpu, int idx)
+{
+  const sVariant& variant = m_variants[idx];
+
+  m_mutex.Lock();
+  Genome genome(m_base_genome);
+  m_mutex.Unlock();
+
+  InstructionSequencePtr seq_p;
+  seq_p.DynamicCastFrom(genome.Representation());
+  InstructionSequence& seq = *seq_p;
+  if (variant.site1 >= 0) seq[variant.site1].SetOp(variant.inst1);
+  if (variant.site2 >= 0) seq[variant.site2].SetOp(variant.inst2);
+
+  cCPUTestInfo test_info(m_test_info.GetGenerationTests());
+  test_info.CopySettings(m_test_info);
+
+  cAnalyzeGenotype* genotype = new cAnalyzeGenotype(m_world, genome);
+  genotype->Recalculate(ctx, &test_info, NULL, 1, testcpu);
+
+  m_fitness[idx] = genotype->GetFitness();
+  if (m_keep_genotypes) m_genotypes[idx] = genotype;
+  else delete genotype;
+}
@@ -0,0 +1,101 @@
+/*
+ *  cGenomeScan.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cGenomeScan_h
+#define cGenomeScan_h
+
+#include "apto/core.h"
+#include "avida/core/Genome.h"
+
+#include "cCPUTestInfo.h"
+
+class cAnalyzeGenotype;
+class cAnalyzeJobQueue;
+class cAvidaContext;
+class cTestCPU;
+class cWorld;
+
+using namespace Avida;
+
+
+// cGenomeScan - recalculates variants of a base genome as independent analyze jobs
+//
+// A variant is the base genome with at most two sites replaced.  Each variant is recalculated by its own job, on the
+// test CPU of the worker running it, and its results are stored by variant index.  Results may therefore be read back
+// in the order the variants were added, and are the same whether the job queue has one worker or many.
+
+class cGenomeScan
+{
+private:
+  struct sVariant
+  {
+    int site1;
+    int inst1;
+    int site2;
+    int inst2;
+  };
+
+  cWorld* m_world;
+  Genome m_base_genome;
+  cCPUTestInfo m_test_info;     // settings only, copied for every job
+  bool m_keep_genotypes;
+
+  Apto::Array<sVariant> m_variants;
+  Apto::Array<double> m_fitness;
+  Apto::Array<cAnalyzeGenotype*> m_genotypes;
+
+  Apto::Mutex m_mutex;
+
+
+  cGenomeScan(); // @not_implemented
+  cGenomeScan(const cGenomeScan&); // @not_implemented
+  cGenomeScan& operator=(const cGenomeScan&); // @not_implemented
+
+
+public:
+  // With keep_genotypes, every recalculated variant is kept as a genotype for GetGenotype(); otherwise only its
+  // fitness is kept
+  cGenomeScan(cWorld* world, const Genome& base_genome, const cCPUTestInfo* test_info = NULL, bool keep_genotypes = false);
+  ~cGenomeScan();
+
+  // Each returns the index of the new variant
+  int AddVariant() { return addVariant(-1, 0, -1, 0); }
+  int AddVariant(int site, int inst) { return addVariant(site, inst, -1, 0); }
+  int AddVariant(int site1, int inst1, int site2, int inst2) { return addVariant(site1, inst1, site2, inst2); }
+
+  int GetSize() const { return m_variants.GetSize(); }
+
+  // Recalculates every variant, returning once all of them are done
+  void Run(cAnalyzeJobQueue& queue, cAvidaContext& ctx);
+
+  double GetFitness(int idx) const { return m_fitness[idx]; }
+  cAnalyzeGenotype* GetGenotype(int idx) const { return m_genotypes[idx]; }
+
+  // Drops all variants and their results
+  void Clear();
+
+  void TestVariant(cAvidaContext& ctx, cTestCPU* testcpu, int idx);
+
+private:
+  int addVariant(int site1, int inst1, int site2, int inst2);
+};
+
+#endif
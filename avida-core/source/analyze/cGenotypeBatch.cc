@@ -22,9 +22,11 @@
 #include "cGenotypeBatch.h"
 
 #include "cAnalyzeGenotype.h"
+#include "cPhylogenyIndex.h"
 
 
-cGenotypeBatch::cGenotypeBatch(const cGenotypeBatch& rhs) : m_list(rhs.m_list), m_name(rhs.m_name), m_is_lineage(rhs.m_is_lineage), m_is_aligned(rhs.m_is_aligned)
+cGenotypeBatch::cGenotypeBatch(const cGenotypeBatch& rhs)
+  : m_list(rhs.m_list), m_name(rhs.m_name), m_is_lineage(rhs.m_is_lineage), m_is_aligned(rhs.m_is_aligned), m_phylogeny(NULL)
 {
   if (rhs.m_lineage_head) {
     m_lineage_head = new cAnalyzeGenotype(*(rhs.m_lineage_head));
@@ -43,12 +45,15 @@ cGenotypeBatch::~cGenotypeBatch()
   
   delete m_lineage_head;
   delete m_clade_head;
+  delete m_phylogeny;
 }
 
 cGenotypeBatch& cGenotypeBatch::operator=(const cGenotypeBatch& rhs)
 {
   // check for self-assignment
   if (this == &rhs) return *this;
+  
+  invalidatePhylogeny();
 
   // shallow-copiable or have their own deep copy functionality
   m_list =       rhs.m_list;
@@ -71,6 +76,19 @@ cGenotypeBatch& cGenotypeBatch::operator=(const cGenotypeBatch& rhs)
 }
 
 
+const cPhylogenyIndex& cGenotypeBatch::GetPhylogeny() const
+{
+  if (!m_phylogeny) m_phylogeny = new cPhylogenyIndex(const_cast<tListPlus<cAnalyzeGenotype>&>(m_list));
+  return *m_phylogeny;
+}
+
+void cGenotypeBatch::invalidatePhylogeny()
+{
+  delete m_phylogeny;
+  m_phylogeny = NULL;
+}
+
+
 cAnalyzeGenotype* cGenotypeBatch::FindGenotypeNumCPUs() const
 {
   return new cAnalyzeGenotype(*(m_list.FindMax(&cAnalyzeGenotype::GetNumCPUs)));
@@ -182,41 +200,11 @@ cAnalyzeGenotype* cGenotypeBatch::FindLastCommonAncestor()
   // Assumes that the batch contains a population and all of its common ancestors
   // Finds the last common ancestor among all current organisms that are still alive,
   // i.e. have an update_died of -1.
+  const cPhylogenyIndex& phylogeny = GetPhylogeny();
+  const int lca = phylogeny.FindLastCommonAncestor();
+  if (lca == -1) return NULL;
   
-  // Connect each genotype to its parent.
-  tListIterator<cAnalyzeGenotype> it(m_list);
-  tListIterator<cAnalyzeGenotype> parent_it(m_list);
-  cAnalyzeGenotype* on_child = NULL;
-  while ((on_child = it.Next())) {
-    parent_it.Reset();
-    cAnalyzeGenotype* on_parent = NULL;
-    while ((on_parent = parent_it.Next())) {
-      if (on_child->GetParentID() == on_parent->GetID()) {
-        on_child->LinkParent(on_parent);
-        break;
-      }
-    }
-  }
-    
-  // Find the genotype without a parent (there should only be one)
-  it.Reset();
-  cAnalyzeGenotype* lca = NULL;
-  cAnalyzeGenotype* test_lca = NULL;
-  while ((test_lca = it.Next())) {
-    if (!test_lca->GetParent()) {
-      // It is an error to get two genotypes without a parent
-      if (lca) return NULL;
-      lca = test_lca;
-    }
-  }
-  
-  // Follow the children from this parent until we find a genotype with more than one child.
-  // This is the last common ancestor.
-  while (lca->GetChildList().GetSize() == 1) {
-    lca = lca->GetChildList().Pop();
-  }
-  
-  return new cAnalyzeGenotype(*lca);
+  return new cAnalyzeGenotype(*phylogeny.GetGenotype(lca));
 }
 
 
@@ -231,12 +219,14 @@ cGenotypeBatch* cGenotypeBatch::FindLineage(cAnalyzeGenotype* end_genotype) cons
 cGenotypeBatch* cGenotypeBatch::FindLineage(int end_genotype_id) const
 {
   cGenotypeBatch* batch = new cGenotypeBatch;
-  cAnalyzeGenotype* found_gen = FindGenotypeID(end_genotype_id);
+  const cPhylogenyIndex& phylogeny = GetPhylogeny();
   
-  while ((found_gen)) {
+  Apto::Array<int, Apto::Smart> lineage;
+  phylogeny.GetLineage(phylogeny.FindNode(end_genotype_id), lineage);
+  for (int i = 0; i < lineage.GetSize(); i++) {
+    cAnalyzeGenotype* found_gen = new cAnalyzeGenotype(*phylogeny.GetGenotype(lineage[i]));
     batch->m_list.Push(found_gen);
     batch->m_lineage_head = found_gen;
-    found_gen = FindGenotypeID(found_gen->GetParentID());
   }
     
   return batch;
@@ -355,27 +345,31 @@ cGenotypeBatch* cGenotypeBatch::FindClade(cAnalyzeGenotype* start_genotype) cons
 cGenotypeBatch* cGenotypeBatch::FindClade(int start_genotype_id) const
 {
   cGenotypeBatch* batch = new cGenotypeBatch;
-  tList<cAnalyzeGenotype> list(m_list);
-  Apto::Array<int, Apto::Smart> scan_list;
-  cAnalyzeGenotype* found_gen = FindGenotypeID(start_genotype_id);
- 
-  if ((found_gen)) {
-    batch->m_list.Push(found_gen);
-    batch->m_clade_head = found_gen;
-    scan_list.Push(found_gen->GetID());
-  }
+  const cPhylogenyIndex& phylogeny = GetPhylogeny();
+  const int head = phylogeny.FindNode(start_genotype_id);
+  if (head == -1) return batch;
+  
+  Apto::Array<bool> in_clade(phylogeny.GetSize());
+  in_clade.SetAll(false);
+  in_clade[head] = true;
+  
+  cAnalyzeGenotype* found_gen = new cAnalyzeGenotype(*phylogeny.GetGenotype(head));
+  batch->m_list.Push(found_gen);
+  batch->m_clade_head = found_gen;
   
+  Apto::Array<int, Apto::Smart> scan_list;
+  Apto::Array<int, Apto::Smart> children;
+  scan_list.Push(start_genotype_id);
   while (scan_list.GetSize()) {
-    int parent_id = scan_list.Pop();
+    phylogeny.GetChildrenOf(scan_list.Pop(), children);
     
-    // Seach for all of the offspring of this genotype...
-    tListIterator<cAnalyzeGenotype> it(list);
-    while ((found_gen = it.Next()) != NULL) {
-      if (found_gen->GetParentID() == parent_id) {
-        it.Remove();
-        scan_list.Push(found_gen->GetID());
-        batch->m_list.Push(new cAnalyzeGenotype(*found_gen));
-      }
+    // Collect all of the offspring of this genotype...
+    for (int i = 0; i < children.GetSize(); i++) {
+      if (in_clade[children[i]]) continue;
+      in_clade[children[i]] = true;
+      found_gen = phylogeny.GetGenotype(children[i]);
+      scan_list.Push(found_gen->GetID());
+      batch->m_list.Push(new cAnalyzeGenotype(*found_gen));
     }
   }
 
@@ -402,25 +396,41 @@ void cGenotypeBatch::RemoveClade(int start_genotype_id)
       }
     }
     while ((genotype = it.Next())) { it.Remove(); delete genotype; }
+    invalidatePhylogeny();
   } else {
-    Apto::Array<int, Apto::Smart> scan_list;
-    cAnalyzeGenotype* found_gen = PopGenotypeID(start_genotype_id);
+    const cPhylogenyIndex& phylogeny = GetPhylogeny();
+    const int head = phylogeny.FindNode(start_genotype_id);
     
-    if ((found_gen)) scan_list.Push(found_gen->GetID());
+    Apto::Array<bool> in_clade(phylogeny.GetSize());
+    in_clade.SetAll(false);
+    Apto::Array<int, Apto::Smart> scan_list;
+    Apto::Array<int, Apto::Smart> children;
+    if (head != -1) {
+      in_clade[head] = true;
+      scan_list.Push(start_genotype_id);
+    }
     
     while (scan_list.GetSize()) {
-      int parent_id = scan_list.Pop();
+      phylogeny.GetChildrenOf(scan_list.Pop(), children);
       
-      // Seach for all of the offspring of this genotype...
-      tListIterator<cAnalyzeGenotype> it(m_list);
-      while ((found_gen = it.Next()) != NULL) {
-        if (found_gen->GetParentID() == parent_id) {
-          it.Remove();
-          scan_list.Push(found_gen->GetID());
-          delete found_gen;
-        }
+      // Mark all of the offspring of this genotype...
+      for (int i = 0; i < children.GetSize(); i++) {
+        if (in_clade[children[i]]) continue;
+        in_clade[children[i]] = true;
+        scan_list.Push(phylogeny.GetGenotype(children[i])->GetID());
+      }
+    }
+    
+    // Nodes are numbered in list order, so the clade can be dropped in a single pass
+    tListIterator<cAnalyzeGenotype> it(m_list);
+    cAnalyzeGenotype* genotype = NULL;
+    for (int node = 0; (genotype = it.Next()); node++) {
+      if (in_clade[node]) {
+        it.Remove();
+        delete genotype;
       }
     }
+    clearFlags();
   }
 }
 
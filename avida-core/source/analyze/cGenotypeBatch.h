@@ -33,6 +33,7 @@
 // cGenotypeBatch      : Collection of cAnalyzeGenotypes
 
 class cAnalyzeGenotype;
+class cPhylogenyIndex;
 
 
 class cGenotypeBatch
@@ -44,15 +45,17 @@ private:
   cAnalyzeGenotype* m_clade_head;
   bool m_is_lineage;
   bool m_is_aligned;
+  mutable cPhylogenyIndex* m_phylogeny;  // Built on demand, dropped whenever the list may have changed
   
 public:
-  cGenotypeBatch() : m_name(""), m_lineage_head(NULL), m_clade_head(NULL), m_is_lineage(false), m_is_aligned(false) { ; }
+  cGenotypeBatch()
+    : m_name(""), m_lineage_head(NULL), m_clade_head(NULL), m_is_lineage(false), m_is_aligned(false), m_phylogeny(NULL) { ; }
   cGenotypeBatch(const cGenotypeBatch&);
   ~cGenotypeBatch();
 
   cGenotypeBatch& operator=(const cGenotypeBatch&);
 
-  tListPlus<cAnalyzeGenotype>& List() { return m_list; }
+  tListPlus<cAnalyzeGenotype>& List() { invalidatePhylogeny(); return m_list; }
   cString& Name() { return m_name; }
   const cString& GetName() const { return m_name; }
   
@@ -65,7 +68,10 @@ public:
   void SetLineage(bool _val = true) { m_is_lineage = _val; }
   void SetAligned(bool _val = true) { m_is_aligned = _val; }
   
-  void MergeWith(cGenotypeBatch* batch) { m_list.Append(batch->m_list); }
+  void MergeWith(cGenotypeBatch* batch) { invalidatePhylogeny(); m_list.Append(batch->m_list); }
+  
+  // Parent/child index over the current list.  The reference is only good until the list is next accessed mutably.
+  const cPhylogenyIndex& GetPhylogeny() const;
   
   cAnalyzeGenotype* FindGenotypeNumCPUs() const;
   cAnalyzeGenotype* PopGenotypeNumCPUs();
@@ -106,7 +112,12 @@ public:
 
   
 private:
-  inline void clearFlags() { m_lineage_head = NULL; m_is_lineage = false; m_clade_head = NULL; m_is_aligned = false; }
+  inline void clearFlags()
+  {
+    m_lineage_head = NULL; m_is_lineage = false; m_clade_head = NULL; m_is_aligned = false;
+    invalidatePhylogeny();
+  }
+  void invalidatePhylogeny();
 };
 
 
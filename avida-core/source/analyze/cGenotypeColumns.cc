@@ -0,0 +1,175 @@
+/*
+ *  cGenotypeColumns.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGenotypeColumns.h"
+
+#include "cAnalyzeGenotype.h"
+#include "tDataEntryCommand.h"
+
+#include <algorithm>
+
+
+struct sColumnKeyword
+{
+  const char* keyword;
+  int column;
+};
+
+// Aliases map to the same column as the getter they share
+static const sColumnKeyword s_column_keywords[] = {
+  { "id",               cGenotypeColumns::COL_ID },
+  { "dom_id",           cGenotypeColumns::COL_ID },
+  { "parent_id",        cGenotypeColumns::COL_PARENT_ID },
+  { "update_born",      cGenotypeColumns::COL_UPDATE_BORN },
+  { "gen_born",         cGenotypeColumns::COL_UPDATE_BORN },
+  { "depth",            cGenotypeColumns::COL_DEPTH },
+  { "dom_depth",        cGenotypeColumns::COL_DEPTH },
+  { "fitness",          cGenotypeColumns::COL_FITNESS },
+  { "merit",            cGenotypeColumns::COL_MERIT },
+  { "gest_time",        cGenotypeColumns::COL_GEST_TIME },
+  { "length",           cGenotypeColumns::COL_LENGTH },
+  { "num_cpus",         cGenotypeColumns::COL_NUM_CPUS },
+  { "num_units",        cGenotypeColumns::COL_NUM_CPUS },
+  { "dom_num_cpus",     cGenotypeColumns::COL_NUM_CPUS },
+  { "total_task_count", cGenotypeColumns::COL_TASK_COUNT }
+};
+
+
+// Orders rows on a column; NaN sorts before every other value, keeping the ordering strict
+class cColumnRowOrder
+{
+private:
+  const double* m_values;
+  bool m_descending;
+  
+  static inline bool lessThan(double a, double b) { return (a != a) ? (b == b) : (a < b); }
+  
+public:
+  cColumnRowOrder(const double* values, bool descending) : m_values(values), m_descending(descending) { ; }
+  
+  bool operator()(int a, int b) const
+  {
+    return (m_descending) ? lessThan(m_values[b], m_values[a]) : lessThan(m_values[a], m_values[b]);
+  }
+};
+
+class cFlexRowOrder
+{
+private:
+  const Apto::Array<cFlexVar>& m_values;
+  bool m_descending;
+  
+public:
+  cFlexRowOrder(const Apto::Array<cFlexVar>& values, bool descending) : m_values(values), m_descending(descending) { ; }
+  
+  bool operator()(int a, int b) const { return (m_descending) ? (m_values[b] < m_values[a]) : (m_values[a] < m_values[b]); }
+};
+
+
+cGenotypeColumns::cGenotypeColumns(tList<cAnalyzeGenotype>& genotype_list)
+  : m_columns(NUM_COLUMNS), m_loaded(NUM_COLUMNS)
+{
+  m_genotypes.Resize(genotype_list.GetSize());
+  tListIterator<cAnalyzeGenotype> list_it(genotype_list);
+  for (int row = 0; row < m_genotypes.GetSize(); row++) m_genotypes[row] = list_it.Next();
+  
+  m_loaded.SetAll(false);
+}
+
+
+int cGenotypeColumns::FindColumn(const cString& keyword)
+{
+  for (unsigned int i = 0; i < sizeof(s_column_keywords) / sizeof(s_column_keywords[0]); i++) {
+    if (keyword == s_column_keywords[i].keyword) return s_column_keywords[i].column;
+  }
+  return -1;
+}
+
+
+const Apto::Array<double>& cGenotypeColumns::GetColumn(int column) const
+{
+  if (!m_loaded[column]) loadColumn(column);
+  return m_columns[column];
+}
+
+
+void cGenotypeColumns::Compare(int column, double value, Apto::Array<int>& result) const
+{
+  const Apto::Array<double>& values = GetColumn(column);
+  const int num_rows = values.GetSize();
+  
+  result.Resize(num_rows);
+  for (int row = 0; row < num_rows; row++) {
+    result[row] = (values[row] == value) ? 0 : ((values[row] > value) ? 1 : -1);
+  }
+}
+
+
+void cGenotypeColumns::GetSortedOrder(int column, bool descending, Apto::Array<int>& order) const
+{
+  const Apto::Array<double>& values = GetColumn(column);
+  const int num_rows = values.GetSize();
+  
+  order.Resize(num_rows);
+  for (int row = 0; row < num_rows; row++) order[row] = row;
+  if (num_rows < 2) return;
+  
+  std::stable_sort(&order[0], &order[0] + num_rows, cColumnRowOrder(&values[0], descending));
+}
+
+void cGenotypeColumns::GetSortedOrder(const tDataEntryCommand<cAnalyzeGenotype>& stat, bool descending,
+                                      Apto::Array<int>& order) const
+{
+  const int num_rows = m_genotypes.GetSize();
+  Apto::Array<cFlexVar> values(num_rows);
+  for (int row = 0; row < num_rows; row++) values[row] = stat.GetValue(m_genotypes[row]);
+  
+  order.Resize(num_rows);
+  for (int row = 0; row < num_rows; row++) order[row] = row;
+  if (num_rows < 2) return;
+  
+  std::stable_sort(&order[0], &order[0] + num_rows, cFlexRowOrder(values, descending));
+}
+
+
+void cGenotypeColumns::loadColumn(int column) const
+{
+  Apto::Array<double>& values = m_columns[column];
+  const int num_rows = m_genotypes.GetSize();
+  values.Resize(num_rows);
+  
+  // One tight loop per column, rather than a switch per row
+  switch (column) {
+    case COL_ID:          for (int i = 0; i < num_rows; i++) values[i] = m_genotypes[i]->GetID(); break;
+    case COL_PARENT_ID:   for (int i = 0; i < num_rows; i++) values[i] = m_genotypes[i]->GetParentID(); break;
+    case COL_UPDATE_BORN: for (int i = 0; i < num_rows; i++) values[i] = m_genotypes[i]->GetUpdateBorn(); break;
+    case COL_DEPTH:       for (int i = 0; i < num_rows; i++) values[i] = m_genotypes[i]->GetDepth(); break;
+    case COL_FITNESS:     for (int i = 0; i < num_rows; i++) values[i] = m_genotypes[i]->GetFitness(); break;
+    case COL_MERIT:       for (int i = 0; i < num_rows; i++) values[i] = m_genotypes[i]->GetMerit(); break;
+    case COL_GEST_TIME:   for (int i = 0; i < num_rows; i++) values[i] = m_genotypes[i]->GetGestTime(); break;
+    case COL_LENGTH:      for (int i = 0; i < num_rows; i++) values[i] = m_genotypes[i]->GetLength(); break;
+    case COL_NUM_CPUS:    for (int i = 0; i < num_rows; i++) values[i] = m_genotypes[i]->GetNumCPUs(); break;
+    case COL_TASK_COUNT:  for (int i = 0; i < num_rows; i++) values[i] = m_genotypes[i]->GetTotalTaskCount(); break;
+    default: break;
+  }
+  
+  m_loaded[column] = true;
+}
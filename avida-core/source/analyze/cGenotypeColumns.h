@@ -0,0 +1,90 @@
+/*
+ *  cGenotypeColumns.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cGenotypeColumns_h
+#define cGenotypeColumns_h
+
+#include "apto/core.h"
+
+#include "cString.h"
+#include "tList.h"
+
+class cAnalyzeGenotype;
+template <class T> class tDataEntryCommand;
+
+
+// cGenotypeColumns - the common scalar stats of a list of cAnalyzeGenotypes, held as contiguous columns
+//
+// Rows are numbered in list order, and each row keeps its genotype for everything that is not in a column.  A column
+// is read out of the genotypes the first time it is used; the snapshot does not follow later changes to the list or to
+// the genotypes themselves.  Every column is held as doubles, which represent all of the integer stats exactly and are
+// what FILTER compares in anyway.
+
+class cGenotypeColumns
+{
+public:
+  enum eColumn {
+    COL_ID = 0,
+    COL_PARENT_ID,
+    COL_UPDATE_BORN,
+    COL_DEPTH,
+    COL_FITNESS,
+    COL_MERIT,
+    COL_GEST_TIME,
+    COL_LENGTH,
+    COL_NUM_CPUS,
+    COL_TASK_COUNT,
+    NUM_COLUMNS
+  };
+
+private:
+  Apto::Array<cAnalyzeGenotype*> m_genotypes;
+  mutable Apto::Array<Apto::Array<double> > m_columns;
+  mutable Apto::Array<bool> m_loaded;
+
+  cGenotypeColumns(const cGenotypeColumns&); // @not_implemented
+  cGenotypeColumns& operator=(const cGenotypeColumns&); // @not_implemented
+
+public:
+  cGenotypeColumns(tList<cAnalyzeGenotype>& genotype_list);
+
+  // Column holding a genotype data keyword, or -1 if the stat is not kept in a column
+  static int FindColumn(const cString& keyword);
+
+  inline int GetSize() const { return m_genotypes.GetSize(); }
+  inline cAnalyzeGenotype* GetGenotype(int row) const { return m_genotypes[row]; }
+
+  const Apto::Array<double>& GetColumn(int column) const;
+
+  // Sets each row's result to 1, 0 or -1 as its value is greater than, equal to, or otherwise compares to value
+  void Compare(int column, double value, Apto::Array<int>& result) const;
+
+  // Row order sorted on a column; rows with equal values keep their list order
+  void GetSortedOrder(int column, bool descending, Apto::Array<int>& order) const;
+  
+  // As above, for any stat, read through its data entry (and compared as cFlexVars) instead of a column
+  void GetSortedOrder(const tDataEntryCommand<cAnalyzeGenotype>& stat, bool descending, Apto::Array<int>& order) const;
+
+private:
+  void loadColumn(int column) const;
+};
+
+#endif
@@ -32,6 +32,7 @@ public:
 enum eGENOTYPE_DATA_IDS
 {
   GD_MD_ID = 1,
+  GD_TS_ID = 2,
   
   GD_DYNAMIC_ID_BASE
 };
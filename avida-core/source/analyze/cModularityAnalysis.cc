@@ -21,9 +21,20 @@
 
 #include "cModularityAnalysis.h"
 
+#include "avida/core/InstructionSequence.h"
+
 #include "cAnalyzeGenotype.h"
+#include "cAnalyzeJobQueue.h"
+#include "cBitArray.h"
+#include "cEnvironment.h"
+#include "cHardwareManager.h"
+#include "cInstSet.h"
 #include "cOrganism.h"
 #include "cPhenotype.h"
+#include "cResourceLib.h"
+#include "cTestCPU.h"
+#include "cWorld.h"
+#include "tAnalyzeTestJobBatch.h"
 #include "tDataCommandManager.h"
 #include "tDataEntry.h"
 
@@ -51,12 +62,32 @@ void cModularityAnalysis::Initialize()
   ADD_GDATA_IDX("ave_task_position", DescAveTaskPosition, GetAveTaskPositionFor, 4);  
 }
 
-void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx)
+cModularityAnalysis::cModularityAnalysis(cWorld* world, const cCPUTestInfo& test_info)
+  : m_world(world), m_test_info(test_info.GetGenerationTests())
+{
+  m_test_info.CopySettings(test_info);
+}
+
+
+void cModularityAnalysis::Run(cAnalyzeJobQueue& queue, cAvidaContext& ctx, tList<cAnalyzeGenotype>& genotypes)
 {
-  cTestCPU* testcpu = m_genotype->GetWorld()->GetHardwareManager().CreateTestCPU(ctx);
-  cCPUTestInfo test_info = m_test_info;
+  m_genotypes.Resize(0);
+  tListIterator<cAnalyzeGenotype> batch_it(genotypes);
+  for (cAnalyzeGenotype* genotype = batch_it.Next(); genotype; genotype = batch_it.Next()) m_genotypes.Push(genotype);
   
-  const Genome& base_genome = m_genotype->GetGenome();
+  tAnalyzeTestJobBatch<cModularityAnalysis> jobbatch(m_world, queue);
+  for (int i = 0; i < m_genotypes.GetSize(); i++) jobbatch.AddJob(this, &cModularityAnalysis::CalcFunctionalModularity, i);
+  jobbatch.RunBatch();
+}
+
+
+void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx, cTestCPU* testcpu, int idx)
+{
+  cAnalyzeGenotype* genotype = m_genotypes[idx];
+  cCPUTestInfo test_info(m_test_info.GetGenerationTests());
+  test_info.CopySettings(m_test_info);
+  
+  const Genome& base_genome = genotype->GetGenome();
   ConstInstructionSequencePtr base_seq_p;
   base_seq_p.DynamicCastFrom(base_genome.Representation());
   const InstructionSequence& base_seq = *base_seq_p;
@@ -79,7 +110,7 @@ void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx)
   // Don't calculate the modularity if the organism doesn't reproduce. i.e. if the fitness is 0
   if (base_fitness > 0.0 && does_tasks) {
     // Set up the instruction set for mapping
-    cInstSet& map_inst_set = m_genotype->GetWorld()->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
+    cInstSet& map_inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
     const Instruction null_inst = map_inst_set.ActivateNullInst();
 
     // Genome for testing
@@ -90,60 +121,65 @@ void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx)
     mod_seq_p.DynamicCastFrom(mod_rep_p);
     InstructionSequence& mod_seq = *mod_seq_p;
     
-    // Create and initialize the modularity matrix
-    tMatrix<int> mod_matrix(num_tasks, max_line);
-    mod_matrix.SetAll(0);
-    
-    Apto::Array<int> site_num_tasks(max_line);  // number of tasks instruction is used in
-    site_num_tasks.SetAll(0);
-    Apto::Array<int> sites_per_task(num_tasks); // number of sites involved in each task
-    sites_per_task.SetAll(0);
-    
-    // Loop through all the lines of code, testing the removal of each.
-    for (int line_num = 0; line_num < max_line; line_num++) {
-      int cur_inst = base_seq[line_num].GetOp();
-      
-      mod_seq[line_num] = null_inst;
-      
-      // Run the modified genome through the Test CPU
-      testcpu->TestGenome(ctx, test_info, mod_genome);
+    // The modularity matrix, one row of sites for each task
+    cModularityData* mod_data = new cModularityData;
+    Apto::Array<cBitArray> task_sites;
+    if (!GetTaskSites(m_world, genotype, test_info, task_sites)) {
+      task_sites.Resize(num_tasks);
+      for (int i = 0; i < num_tasks; i++) task_sites[i].ResizeClear(max_line);
       
-      if (test_info.GetColonyFitness() > 0.0) {
-        const Apto::Array<int>& test_tasks = test_info.GetColonyOrganism()->GetPhenotype().GetLastTaskCount();
+      // Loop through all the lines of code, testing the removal of each.
+      for (int line_num = 0; line_num < max_line; line_num++) {
+        int cur_inst = base_seq[line_num].GetOp();
+        
+        mod_seq[line_num] = null_inst;
         
-        for (int cur_task = 0; cur_task < num_tasks; cur_task++) {
-          // This is done so that under 'binary' option it marks
-          // the task as being influenced by the mutation iff
-          // it is completely knocked out, not just decreased
-          if (base_tasks[cur_task] && !test_tasks[cur_task]) {
-            // If knocking out an instruction stops the expression of a particular task, mark that in the modularity matrix
-            // and add it to two counts
-            mod_matrix(cur_task, line_num) = 1;
-            sites_per_task[cur_task]++;
-            site_num_tasks[line_num]++;
+        // Run the modified genome through the Test CPU
+        testcpu->TestGenome(ctx, test_info, mod_genome);
+        
+        if (test_info.GetColonyFitness() > 0.0) {
+          const Apto::Array<int>& test_tasks = test_info.GetColonyOrganism()->GetPhenotype().GetLastTaskCount();
+          
+          for (int cur_task = 0; cur_task < num_tasks; cur_task++) {
+            // This is done so that under 'binary' option it marks
+            // the task as being influenced by the mutation iff
+            // it is completely knocked out, not just decreased
+            if (base_tasks[cur_task] && !test_tasks[cur_task]) {
+              // If knocking out an instruction stops the expression of a particular task, mark that in the modularity matrix
+              task_sites[cur_task].Set(line_num, true);
+            }
           }
         }
+        
+        // Reset the mod_genome back to the original sequence.
+        mod_seq[line_num].SetOp(cur_inst);
       }
-          
-      // Reset the mod_genome back to the original sequence.
-      mod_seq[line_num].SetOp(cur_inst);
+      
+      SetTaskSites(genotype, test_info, task_sites);
     }
     
+    Apto::Array<int> site_num_tasks(max_line);  // number of tasks instruction is used in
+    site_num_tasks.SetAll(0);
+    for (int i = 0; i < num_tasks; i++) {
+      Apto::Array<int> sites = task_sites[i].GetOnes();
+      for (int j = 0; j < sites.GetSize(); j++) site_num_tasks[sites[j]]++;
+    }
+    
+    Apto::Array<int> sites_per_task(num_tasks); // number of sites involved in each task
     Apto::Array<int> sites_inv_x_tasks(num_tasks + 1);  // # of inst's involved in 0,1,2,3... tasks
     sites_inv_x_tasks.SetAll(0);
     Apto::Array<double> ave_task_position(num_tasks); // mean positions of the tasks in the genome
-    ave_task_position.SetAll(0.0);
     Apto::Array<int> task_length(num_tasks);  // distance between first and last inst involved in a task
-    task_length.SetAll(0);
  
     int total_task = 0;           // total number of tasks done
     int total_inst = 0;           // total number of instructions involved in tasks
-    int total_all = 0;            // sum of mod_matrix
+    int total_all = 0;            // sum of the modularity matrix
     double sum_task_overlap = 0;  // sum of task overlap for for this genome
 
 
     // Calculate instruction and task totals
     for (int i = 0; i < num_tasks; i++) {
+      sites_per_task[i] = task_sites[i].CountBits();
       total_all += sites_per_task[i];
       if (sites_per_task[i]) total_task++;
     }
@@ -153,68 +189,37 @@ void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx)
     }
     
     
-    // Calculate average task overlap
-    // first construct num_task x num_task matrix with number of sites overlapping
-    tMatrix<int> task_overlap(num_tasks, num_tasks);
-    task_overlap.SetAll(0);
-
-    for (int i = 0; i < max_line; i++) {
-      for (int j = 0; j < num_tasks; j++) {
-        for (int k = j; k < num_tasks; k++) {
-          if (mod_matrix(j, i) > 0 && mod_matrix(k, i) > 0) {
-            task_overlap(j, k)++;
-            if (j != k) task_overlap(k, j)++;
-          }               
-        }
-      }
-    }
-    
-    // go though the task_overlap matrix, add and average everything up. 
+    // Calculate average task overlap, the number of sites each task shares with every other task
     if (total_task > 1) {
+      Apto::Array<int> overlap_per_task(num_tasks);
+      overlap_per_task.SetAll(0);
       for (int i = 0; i < num_tasks; i++) {
-        if (task_overlap(i, i)) {
-          int overlap_per_task = 0;
-          for (int j = 0; j < num_tasks; j++) if (i != j) overlap_per_task += task_overlap(i,j);
-          sum_task_overlap += (double)overlap_per_task / (task_overlap(i, i) * (total_task - 1));
+        if (!sites_per_task[i]) continue;
+        for (int j = i + 1; j < num_tasks; j++) {
+          const int overlap = task_sites[i].CountBitsAND(task_sites[j]);
+          overlap_per_task[i] += overlap;
+          overlap_per_task[j] += overlap;
         }
       }
-    }
-    
-    
-    // Calculate the first/last position of a task, the task "spread"
-    // starting from the top look for the fist command that matters for a task
-    for (int i = 0; i < num_tasks; i++) { 
-      for (int j = 0; j < max_line; j++) {
-        if (mod_matrix(i, j) > 0 && task_length[i] == 0) {
-          task_length[i] = j;
-          break;
-        }
-      }
-    }
-    
-    // starting from the bottom look for the last command that matters for a task
-    // and subtract it from the first to get the task length
-    // add one in order to account for both the beginning and the end instruction
-    for (int i = 0; i < num_tasks; i++) {
-      for (int j = max_line - 1; j >= 0; j--) {
-        if (mod_matrix(i, j) > 0) {
-          task_length[i] = j - task_length[i] + 1;
-          break;
+      for (int i = 0; i < num_tasks; i++) {
+        if (sites_per_task[i]) {
+          sum_task_overlap += (double)overlap_per_task[i] / (sites_per_task[i] * (total_task - 1));
         }
       }
     }
     
     
-    // Calculate mean positions of the tasks
-    Apto::Array<int> task_position(num_tasks);
+    // Calculate the task "spread", from the first to the last site that matters for a task (including both), and the
+    // mean position of the task's sites
     for (int i = 0; i < num_tasks; i++) {
-      task_position[i] = 0;
-      for (int j = 0; j < max_line; j++) if (mod_matrix(i,j) > 0) task_position[i] += j;
+      Apto::Array<int> sites = task_sites[i].GetOnes();
+      int task_position = 0;
+      for (int j = 0; j < sites.GetSize(); j++) task_position += sites[j];
+      task_length[i] = (sites.GetSize()) ? sites[sites.GetSize() - 1] - sites[0] + 1 : 0;
+      ave_task_position[i] = (double)task_position / sites_per_task[i];
     }
-    for (int i = 0; i < num_tasks; i++) ave_task_position[i] = (double)task_position[i] / sites_per_task[i];
     
     
-    cModularityData* mod_data = new cModularityData;
     mod_data->tasks_done = total_task;
     mod_data->insts_tasks = total_inst;
     mod_data->tasks_prop = (double)total_inst / max_line;
@@ -225,10 +230,39 @@ void cModularityAnalysis::CalcFunctionalModularity(cAvidaContext& ctx)
     mod_data->sites_inv_x_tasks = sites_inv_x_tasks;
     mod_data->task_length = task_length;
     mod_data->ave_task_position = ave_task_position;
-    m_genotype->SetGenotypeData(GD_MD_ID, mod_data);
+    genotype->SetGenotypeData(GD_MD_ID, mod_data);
   }
 }
 
+bool cModularityAnalysis::GetTaskSites(cWorld* world, const cAnalyzeGenotype* genotype, const cCPUTestInfo& test_info,
+                                       Apto::Array<cBitArray>& task_sites)
+{
+  const bool has_resources = (world->GetEnvironment().GetResourceLib().GetSize() > 0);
+  
+  cAnalyzeGenotype::ReadToken* tok = genotype->GetReadToken();
+  cTaskSiteData* data = static_cast<cTaskSiteData*>(genotype->GetGenotypeData(tok, GD_TS_ID));
+  const bool found = (data && data->settings.HasSameSettings(test_info, has_resources));
+  if (found) task_sites = data->task_sites;
+  delete tok;
+  return found;
+}
+
+void cModularityAnalysis::SetTaskSites(cAnalyzeGenotype* genotype, const cCPUTestInfo& test_info,
+                                       const Apto::Array<cBitArray>& task_sites)
+{
+  // Knockouts tested with random inputs give different sites each time
+  if (test_info.GetUseRandomInputs()) return;
+  
+  cTaskSiteData* data = new cTaskSiteData(test_info);
+  data->task_sites = task_sites;
+  
+  cAnalyzeGenotype::ReadToken* tok = genotype->GetReadToken();
+  cGenotypeData* old_data = genotype->GetGenotypeData(tok, GD_TS_ID);
+  delete tok;
+  genotype->SetGenotypeData(GD_TS_ID, data);
+  delete old_data;
+}
+
 #ifdef DEBUG
 #define GET_MD() \
   cAnalyzeGenotype::ReadToken* tok = genotype->GetReadToken(); \
@@ -342,3 +376,9 @@ cModularityAnalysis::cModularityData::cModularityData()
 : tasks_done(0), insts_tasks(0), tasks_prop(0.0), ave_tasks_per_site(0.0), ave_sites_per_task(0.0), ave_prop_nonoverlap(0.0)
 {
 }
+
+cModularityAnalysis::cTaskSiteData::cTaskSiteData(const cCPUTestInfo& test_info)
+: settings(test_info.GetGenerationTests())
+{
+  settings.CopySettings(test_info);
+}
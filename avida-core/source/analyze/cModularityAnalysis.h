@@ -22,26 +22,58 @@
 #ifndef cModularityAnalysis_h
 #define cModularityAnalysis_h
 
+#include "apto/core.h"
+
+#include "cBitArray.h"
 #include "cGenotypeData.h"
 #include "cCPUTestInfo.h"
+#include "tList.h"
 
 class cAvidaContext;
 class cAnalyzeGenotype;
+class cAnalyzeJobQueue;
 class cFlexVar;
 class cString;
+class cTestCPU;
+class cWorld;
+
 
+// cModularityAnalysis - functional modularity of a batch of genotypes (CALC_FUNCTIONAL_MODULARITY)
+//
+// Each genotype is its own analyze job, knocking out every site in turn on the test CPU of the worker running it.
+// The sites whose knockout stops each task are kept as one bit array per task, so the site, position and overlap
+// statistics are all counts over those bit arrays.  The bit arrays are kept as genotype data too, along with the test
+// settings they were found under, and are reused instead of knocking out the sites again.  MAP_TASKS records them from
+// its own knockouts.
 
 class cModularityAnalysis
 {
 private:
-  cAnalyzeGenotype* m_genotype;
-  cCPUTestInfo m_test_info;
+  cWorld* m_world;
+  cCPUTestInfo m_test_info;     // settings only, copied for every job
+  Apto::Array<cAnalyzeGenotype*> m_genotypes;
+
+
+  cModularityAnalysis(); // @not_implemented
+  cModularityAnalysis(const cModularityAnalysis&); // @not_implemented
+  cModularityAnalysis& operator=(const cModularityAnalysis&); // @not_implemented
+
+
 public:
-  cModularityAnalysis(cAnalyzeGenotype* genotype, const cCPUTestInfo& test_info) : m_genotype(genotype), m_test_info(test_info) { ; }
+  cModularityAnalysis(cWorld* world, const cCPUTestInfo& test_info);
   
   static void Initialize();
   
-  void CalcFunctionalModularity(cAvidaContext& ctx);
+  void Run(cAnalyzeJobQueue& queue, cAvidaContext& ctx, tList<cAnalyzeGenotype>& genotypes);
+  void CalcFunctionalModularity(cAvidaContext& ctx, cTestCPU* testcpu, int idx);
+  
+  // Copies out the sites whose knockout stops each task (one bit per site), if they have been found for the genotype
+  // under the same test settings (resource settings only count if the environment has resources)
+  static bool GetTaskSites(cWorld* world, const cAnalyzeGenotype* genotype, const cCPUTestInfo& test_info,
+                           Apto::Array<cBitArray>& task_sites);
+  // Keeps the sites for later analyses of the genotype, unless the test used random inputs
+  static void SetTaskSites(cAnalyzeGenotype* genotype, const cCPUTestInfo& test_info,
+                           const Apto::Array<cBitArray>& task_sites);
   
   static cFlexVar GetTasksDoneFor(const cAnalyzeGenotype* genotype);
   static cFlexVar GetInstsInvolvedInTasksFor(const cAnalyzeGenotype* genotype);
@@ -77,6 +109,15 @@ private:
     
     cModularityData();
   };
+  
+  class cTaskSiteData : public cGenotypeData
+  {
+  public:
+    cCPUTestInfo settings;                    // input and resource settings of the knockout tests
+    Apto::Array<cBitArray> task_sites;        // sites whose knockout stops each task
+    
+    cTaskSiteData(const cCPUTestInfo& test_info);
+  };
 };
 
 #endif
@@ -0,0 +1,169 @@
+/*
+ *  cPhylogenyIndex.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPhylogenyIndex.h"
+
+#include "cAnalyzeGenotype.h"
+
+
+cPhylogenyIndex::cPhylogenyIndex(tList<cAnalyzeGenotype>& genotype_list)
+{
+  const int num_nodes = genotype_list.GetSize();
+
+  m_genotypes.Resize(num_nodes);
+  tListIterator<cAnalyzeGenotype> list_it(genotype_list);
+  for (int node = 0; node < num_nodes; node++) {
+    m_genotypes[node] = list_it.Next();
+    int existing = -1;
+    if (!m_id_node.Get(m_genotypes[node]->GetID(), existing)) m_id_node.Set(m_genotypes[node]->GetID(), node);
+  }
+
+  // Chain the children of each parent ID; walking backwards leaves every chain in list order
+  m_next_sibling.Resize(num_nodes);
+  for (int node = num_nodes - 1; node >= 0; node--) {
+    const int parent_id = m_genotypes[node]->GetParentID();
+    int first = -1;
+    m_first_child.Get(parent_id, first);
+    m_next_sibling[node] = first;
+    m_first_child.Set(parent_id, node);
+  }
+
+  m_parent.Resize(num_nodes);
+  m_num_children.Resize(num_nodes);
+  m_num_children.SetAll(0);
+  for (int node = 0; node < num_nodes; node++) {
+    m_parent[node] = FindNode(m_genotypes[node]->GetParentID());
+    if (m_parent[node] == -1) m_roots.Push(node);
+    else m_num_children[m_parent[node]]++;
+  }
+
+  // Breadth first from the roots, so that every parent precedes its children
+  m_depth.Resize(num_nodes);
+  m_depth.SetAll(-1);
+  m_preorder.Resize(0);
+  for (int i = 0; i < m_roots.GetSize(); i++) {
+    m_depth[m_roots[i]] = 0;
+    m_preorder.Push(m_roots[i]);
+  }
+  for (int i = 0; i < m_preorder.GetSize(); i++) {
+    const int node = m_preorder[i];
+    int child = -1;
+    m_first_child.Get(m_genotypes[node]->GetID(), child);
+    for (; child != -1; child = m_next_sibling[child]) {
+      if (m_parent[child] != node || m_depth[child] != -1) continue;
+      m_depth[child] = m_depth[node] + 1;
+      m_preorder.Push(child);
+    }
+  }
+}
+
+
+int cPhylogenyIndex::FindNode(int genotype_id) const
+{
+  int node = -1;
+  m_id_node.Get(genotype_id, node);
+  return node;
+}
+
+
+void cPhylogenyIndex::GetChildrenOf(int genotype_id, Apto::Array<int, Apto::Smart>& children) const
+{
+  children.Resize(0);
+  int child = -1;
+  m_first_child.Get(genotype_id, child);
+  for (; child != -1; child = m_next_sibling[child]) children.Push(child);
+}
+
+
+void cPhylogenyIndex::GetLineage(int node, Apto::Array<int, Apto::Smart>& lineage) const
+{
+  lineage.Resize(0);
+
+  // Bounded by the number of nodes, in case the parent links form a cycle
+  for (; node != -1 && lineage.GetSize() < GetSize(); node = m_parent[node]) lineage.Push(node);
+}
+
+
+int cPhylogenyIndex::FindLCA(int node_a, int node_b) const
+{
+  if (node_a == -1 || node_b == -1 || m_depth[node_a] == -1 || m_depth[node_b] == -1) return -1;
+  if (m_ancestor.GetSize() == 0) buildAncestorTable();
+
+  // Lift the deeper node to the depth of the other...
+  if (m_depth[node_a] < m_depth[node_b]) {
+    const int tmp = node_a;
+    node_a = node_b;
+    node_b = tmp;
+  }
+  const int lift = m_depth[node_a] - m_depth[node_b];
+  for (int k = 0; k < m_ancestor.GetSize(); k++) {
+    if (lift & (1 << k)) node_a = m_ancestor[k][node_a];
+  }
+  if (node_a == node_b) return node_a;
+
+  // ...then lift both to just below their common ancestor
+  for (int k = m_ancestor.GetSize() - 1; k >= 0; k--) {
+    if (m_ancestor[k][node_a] != m_ancestor[k][node_b]) {
+      node_a = m_ancestor[k][node_a];
+      node_b = m_ancestor[k][node_b];
+    }
+  }
+  return m_parent[node_a];
+}
+
+int cPhylogenyIndex::FindLCA(const Apto::Array<int, Apto::Smart>& nodes) const
+{
+  if (nodes.GetSize() == 0) return -1;
+
+  int lca = nodes[0];
+  for (int i = 1; i < nodes.GetSize() && lca != -1; i++) lca = FindLCA(lca, nodes[i]);
+  return lca;
+}
+
+int cPhylogenyIndex::FindLastCommonAncestor() const
+{
+  if (m_roots.GetSize() != 1) return -1;
+
+  Apto::Array<int, Apto::Smart> leaves;
+  for (int i = 0; i < m_preorder.GetSize(); i++) if (m_num_children[m_preorder[i]] == 0) leaves.Push(m_preorder[i]);
+  return FindLCA(leaves);
+}
+
+
+void cPhylogenyIndex::buildAncestorTable() const
+{
+  const int num_nodes = GetSize();
+  int max_depth = 0;
+  for (int node = 0; node < num_nodes; node++) if (m_depth[node] > max_depth) max_depth = m_depth[node];
+
+  int levels = 1;
+  while ((1 << levels) <= max_depth) levels++;
+
+  m_ancestor.Resize(levels);
+  m_ancestor[0] = m_parent;
+  for (int k = 1; k < levels; k++) {
+    m_ancestor[k].Resize(num_nodes);
+    for (int node = 0; node < num_nodes; node++) {
+      const int mid = m_ancestor[k - 1][node];
+      m_ancestor[k][node] = (mid == -1) ? -1 : m_ancestor[k - 1][mid];
+    }
+  }
+}
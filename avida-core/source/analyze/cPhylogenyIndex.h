@@ -0,0 +1,88 @@
+/*
+ *  cPhylogenyIndex.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPhylogenyIndex_h
+#define cPhylogenyIndex_h
+
+#include "apto/core.h"
+
+#include "tList.h"
+
+class cAnalyzeGenotype;
+
+
+// cPhylogenyIndex - parent/child structure of a list of cAnalyzeGenotypes, built in one pass
+//
+// Nodes are numbered in list order.  A genotype whose parent is not in the list is a root.  Should two genotypes share
+// an ID, the one earlier in the list is the one found by ID.  Genotypes caught in a parent cycle are unreachable from
+// any root and have a depth of -1.
+
+class cPhylogenyIndex
+{
+private:
+  Apto::Array<cAnalyzeGenotype*> m_genotypes;
+  Apto::Map<int, int> m_id_node;          // Genotype ID -> node
+  Apto::Map<int, int> m_first_child;      // Parent genotype ID -> first child node (present or not)
+  Apto::Array<int> m_next_sibling;        // Children of an ID are chained in list order
+  Apto::Array<int> m_parent;              // -1 if the parent is not in the list
+  Apto::Array<int> m_num_children;
+  Apto::Array<int> m_depth;
+  Apto::Array<int> m_preorder;            // Reachable nodes, every parent before its children
+  Apto::Array<int> m_roots;
+
+  // Binary lifting table (m_ancestor[k][node] = 2^k-th ancestor), built on the first LCA query
+  mutable Apto::Array<Apto::Array<int> > m_ancestor;
+
+  cPhylogenyIndex(const cPhylogenyIndex&); // @not_implemented
+  cPhylogenyIndex& operator=(const cPhylogenyIndex&); // @not_implemented
+
+public:
+  cPhylogenyIndex(tList<cAnalyzeGenotype>& genotype_list);
+
+  inline int GetSize() const { return m_genotypes.GetSize(); }
+  inline cAnalyzeGenotype* GetGenotype(int node) const { return m_genotypes[node]; }
+
+  int FindNode(int genotype_id) const;  // -1 if not present
+
+  inline int GetParent(int node) const { return m_parent[node]; }
+  inline int GetNumChildren(int node) const { return m_num_children[node]; }
+  inline int GetDepth(int node) const { return m_depth[node]; }
+  inline const Apto::Array<int>& GetRoots() const { return m_roots; }
+  inline const Apto::Array<int>& GetPreorder() const { return m_preorder; }
+
+  // Children of a genotype ID in list order; the ID itself need not be in the list
+  void GetChildrenOf(int genotype_id, Apto::Array<int, Apto::Smart>& children) const;
+
+  // Lineage of a node, from the node back to its root
+  void GetLineage(int node, Apto::Array<int, Apto::Smart>& lineage) const;
+
+  // Last common ancestor of two nodes, or of a set of nodes; -1 if they do not share a root
+  int FindLCA(int node_a, int node_b) const;
+  int FindLCA(const Apto::Array<int, Apto::Smart>& nodes) const;
+
+  // Last common ancestor of every leaf of a single rooted tree; -1 if the list does not have exactly one root
+  int FindLastCommonAncestor() const;
+
+private:
+  void buildAncestorTable() const;
+};
+
+#endif
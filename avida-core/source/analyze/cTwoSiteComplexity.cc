@@ -0,0 +1,294 @@
+/*
+ *  cTwoSiteComplexity.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cTwoSiteComplexity.h"
+
+#include "avida/core/InstructionSequence.h"
+
+#include "cAnalyzeGenotype.h"
+#include "cAnalyzeJobQueue.h"
+#include "cHardwareManager.h"
+#include "cInstSet.h"
+#include "cWorld.h"
+#include "tAnalyzeTestJobBatch.h"
+#include "tMatrix.h"
+
+#include <cmath>
+
+
+cTwoSiteComplexity::cTwoSiteComplexity(cWorld* world, const Genome& base_genome, double base_fitness, double mut_rate,
+                                       double converg_accuracy)
+  : m_world(world), m_base_genome(base_genome), m_base_fitness(base_fitness), m_mut_rate(mut_rate)
+  , m_converg_accuracy(converg_accuracy)
+{
+  ConstInstructionSequencePtr seq_p;
+  seq_p.DynamicCastFrom(m_base_genome.Representation());
+  m_length = seq_p->GetSize();
+  m_num_insts = m_world->GetHardwareManager().GetInstSet(m_base_genome.Properties().Get("instset").StringValue()).GetSize();
+
+  m_sites.Resize(m_length);
+  for (int site1 = 0; site1 < m_length; site1++) {
+    for (int site2 = site1 + 1; site2 < m_length; site2++) {
+      sPairResult pair;
+      pair.site1 = site1;
+      pair.site2 = site2;
+      m_pairs.Push(pair);
+    }
+  }
+}
+
+
+void cTwoSiteComplexity::Run(cAnalyzeJobQueue& queue, cAvidaContext& ctx)
+{
+  tAnalyzeTestJobBatch<cTwoSiteComplexity> site_batch(m_world, queue);
+  for (int site = 0; site < m_sites.GetSize(); site++) site_batch.AddJob(this, &cTwoSiteComplexity::ProcessSite, site);
+  site_batch.RunBatch();
+
+  if (m_base_fitness <= 0.0) return;
+
+  tAnalyzeTestJobBatch<cTwoSiteComplexity> pair_batch(m_world, queue);
+  for (int i = 0; i < m_pairs.GetSize(); i++) pair_batch.AddJob(this, &cTwoSiteComplexity::ProcessPair, i);
+  pair_batch.RunBatch();
+}
+
+
+double cTwoSiteComplexity::testFitness(cAvidaContext& ctx, cTestCPU* testcpu, const Genome& genome)
+{
+  cAnalyzeGenotype test_genotype(m_world, genome);
+  test_genotype.Recalculate(ctx, NULL, NULL, 1, testcpu);
+  return test_genotype.GetFitness();
+}
+
+
+void cTwoSiteComplexity::ProcessSite(cAvidaContext& ctx, cTestCPU* testcpu, int site)
+{
+  const int num_insts = m_num_insts;
+  sSiteResult& result = m_sites[site];
+  result.viable = false;
+  result.entropy_mers = 0.0;
+  result.entropy_bits = 0.0;
+  result.complexity_mers = 0.0;
+  result.complexity_bits = 0.0;
+
+  m_mutex.Lock();
+  Genome mod_genome(m_base_genome);
+  m_mutex.Unlock();
+
+  InstructionSequencePtr seq_p;
+  seq_p.DynamicCastFrom(mod_genome.Representation());
+  InstructionSequence& seq = *seq_p;
+  const int cur_inst = seq[site].GetOp();
+
+  // recalculate fitness of each mutant.
+  Apto::Array<double> test_fitness(num_insts);
+  for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
+    seq[site].SetOp(mod_inst);
+    test_fitness[mod_inst] = testFitness(ctx, testcpu, mod_genome);
+  }
+
+  // Adjust fitness
+  // - set all fitness values greater than current instruction equal to current instruction fitness
+  // - make the rest of the fitness values relative to the current instruction fitness
+  const double cur_inst_fitness = test_fitness[cur_inst];
+  if (cur_inst_fitness <= 0.0) return;
+  for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
+    if (test_fitness[mod_inst] > cur_inst_fitness) test_fitness[mod_inst] = cur_inst_fitness;
+    test_fitness[mod_inst] /= cur_inst_fitness;
+  }
+
+  // initialize prob for mutation-selection balance
+  Apto::Array<double> prob(num_insts);
+  Apto::Array<double> prob_next(num_insts);
+  double fitness_total = 0.0;
+  for (int i = 0; i < num_insts; i++) fitness_total += test_fitness[i];
+  for (int i = 0; i < num_insts; i++) {
+    prob[i] = test_fitness[i] / fitness_total;
+    prob_next[i] = 0.0;
+  }
+
+  while (true) {
+    double delta_prob = 0.0;
+    for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
+      // calculate the average fitness
+      double w_avg = 0.0;
+      for (int i = 0; i < num_insts; i++) w_avg += prob[i] * test_fitness[i];
+
+      if (m_mut_rate != 0.0) {
+        // run mutation-selection equation
+        prob_next[mod_inst] = ((1.0 - m_mut_rate) * test_fitness[mod_inst] * prob[mod_inst]) / (w_avg);
+        prob_next[mod_inst] += m_mut_rate / ((double)num_insts);
+      } else {
+        // run selection equation
+        prob_next[mod_inst] = (test_fitness[mod_inst] * prob[mod_inst]) / (w_avg);
+      }
+      delta_prob += (prob_next[mod_inst] - prob[mod_inst]) * (prob_next[mod_inst] - prob[mod_inst]);
+    }
+    for (int i = 0; i < num_insts; i++) prob[i] = prob_next[i];
+
+    if (delta_prob < m_converg_accuracy) break;
+  }
+
+  // Calculate complexity and entropy in bits and mers
+  for (int i = 0; i < num_insts; i++) {
+    // --> 0.0 log(0.0) = 0.0
+    if (prob[i] != 0.0) {
+      result.entropy_mers += prob[i] * log((double) 1.0 / prob[i]) / log((double) num_insts);
+      result.entropy_bits += prob[i] * log((double) 1.0 / prob[i]) / log((double) 2.0);
+    }
+  }
+  result.complexity_mers = 1 - result.entropy_mers;
+  result.complexity_bits = (log((double) num_insts) / log((double) 2.0)) - result.entropy_bits;
+  result.viable = true;
+}
+
+
+void cTwoSiteComplexity::ProcessPair(cAvidaContext& ctx, cTestCPU* testcpu, int idx)
+{
+  const int num_insts = m_num_insts;
+  sPairResult& result = m_pairs[idx];
+
+  m_mutex.Lock();
+  Genome mod_genome(m_base_genome);
+  m_mutex.Unlock();
+
+  InstructionSequencePtr seq_p;
+  seq_p.DynamicCastFrom(mod_genome.Representation());
+  InstructionSequence& seq = *seq_p;
+
+  // run through all possible instructions at both sites, scaling fitness relative to (and capping it at) the
+  // fitness of the base genome
+  tMatrix<double> test_fitness_2s(num_insts, num_insts);
+  double fitness_total_2s = 0.0;
+  for (int mod_inst1 = 0; mod_inst1 < num_insts; mod_inst1++) {
+    for (int mod_inst2 = 0; mod_inst2 < num_insts; mod_inst2++) {
+      seq[result.site1].SetOp(mod_inst1);
+      seq[result.site2].SetOp(mod_inst2);
+      double fitness = testFitness(ctx, testcpu, mod_genome);
+      if (fitness > m_base_fitness) fitness = m_base_fitness;
+      test_fitness_2s[mod_inst1][mod_inst2] = fitness / m_base_fitness;
+      fitness_total_2s += test_fitness_2s[mod_inst1][mod_inst2];
+    }
+  }
+
+  // initialize two site probabilities with relative fitness
+  tMatrix<double> prob_2s(num_insts, num_insts);
+  tMatrix<double> prob_next_2s(num_insts, num_insts);
+  for (int i = 0; i < num_insts; i++) {
+    for (int j = 0; j < num_insts; j++) {
+      prob_2s[i][j] = test_fitness_2s[i][j] / fitness_total_2s;
+      prob_next_2s[i][j] = 0.0;
+    }
+  }
+
+  while (true) {
+    double delta_prob_2s = 0.0;
+    for (int mod_inst1 = 0; mod_inst1 < num_insts; mod_inst1++) {
+      for (int mod_inst2 = 0; mod_inst2 < num_insts; mod_inst2++) {
+        // calculate the average fitness
+        double w_avg_2s = 0.0;
+        for (int i = 0; i < num_insts; i++) {
+          for (int j = 0; j < num_insts; j++) {
+            w_avg_2s += prob_2s[i][j] * test_fitness_2s[i][j];
+          }
+        }
+        if (m_mut_rate != 0.0) {
+          // run mutation-selection equation
+          // -term 1
+          prob_next_2s[mod_inst1][mod_inst2] = ((1.0 - m_mut_rate) * (1.0 - m_mut_rate) * test_fitness_2s[mod_inst1][mod_inst2] *
+                                                prob_2s[mod_inst1][mod_inst2]) / (w_avg_2s);
+          // -term 2
+          double sum_term2 = 0.0;
+          for (int i = 0; i < num_insts; i++) {
+            sum_term2 += (test_fitness_2s[i][mod_inst2] * prob_2s[i][mod_inst2]) / (w_avg_2s);
+          }
+          prob_next_2s[mod_inst1][mod_inst2] += (((m_mut_rate * (1.0 - m_mut_rate)) / ((double)num_insts))) * sum_term2;
+          // -term 3
+          double sum_term3 = 0.0;
+          for (int j = 0; j < num_insts; j++) {
+            sum_term3 += (test_fitness_2s[mod_inst1][j] * prob_2s[mod_inst1][j]) / (w_avg_2s);
+          }
+          prob_next_2s[mod_inst1][mod_inst2] += (((m_mut_rate * (1.0 - m_mut_rate)) / ((double)num_insts))) * sum_term3;
+          // -term 4
+          prob_next_2s[mod_inst1][mod_inst2] += (m_mut_rate / ((double)num_insts)) * (m_mut_rate / ((double)num_insts));
+        } else {
+          // run selection equation
+          prob_next_2s[mod_inst1][mod_inst2] = (test_fitness_2s[mod_inst1][mod_inst2] * prob_2s[mod_inst1][mod_inst2]) / (w_avg_2s);
+        }
+        const double delta = prob_next_2s[mod_inst1][mod_inst2] - prob_2s[mod_inst1][mod_inst2];
+        delta_prob_2s += delta * delta;
+      }
+    }
+    for (int i = 0; i < num_insts; i++) {
+      for (int j = 0; j < num_insts; j++) prob_2s[i][j] = prob_next_2s[i][j];
+    }
+
+    if (delta_prob_2s < m_converg_accuracy) break;
+  }
+
+  // get single site probabilites from two site probabilities
+  Apto::Array<double> prob_1s_i(num_insts);
+  Apto::Array<double> prob_1s_j(num_insts);
+  for (int i = 0; i < num_insts; i++) {
+    prob_1s_i[i] = 0.0;
+    prob_1s_j[i] = 0.0;
+  }
+  for (int i = 0; i < num_insts; i++) {
+    for (int j = 0; j < num_insts; j++) {
+      prob_1s_i[i] += prob_2s[i][j];
+      prob_1s_j[j] += prob_2s[i][j];
+    }
+  }
+
+  // single site entropies, watching for zero probabilities
+  double entropy_ss_site1_mers = 0.0;
+  double entropy_ss_site2_mers = 0.0;
+  double entropy_ss_site1_bits = 0.0;
+  double entropy_ss_site2_bits = 0.0;
+  for (int i = 0; i < num_insts; i++) {
+    if (prob_1s_i[i] != 0.0) {
+      entropy_ss_site1_mers += prob_1s_i[i] * log((double) 1.0 / prob_1s_i[i]) / log((double) num_insts);
+      entropy_ss_site1_bits += prob_1s_i[i] * log((double) 1.0 / prob_1s_i[i]) / log((double) 2.0);
+    }
+    if (prob_1s_j[i] != 0.0) {
+      entropy_ss_site2_mers += prob_1s_j[i] * log((double) 1.0 / prob_1s_j[i]) / log((double) num_insts);
+      entropy_ss_site2_bits += prob_1s_j[i] * log((double) 1.0 / prob_1s_j[i]) / log((double) 2.0);
+    }
+  }
+
+  // two site joint entropies
+  double entropy_ds_mers = 0.0;
+  double entropy_ds_bits = 0.0;
+  for (int i = 0; i < num_insts; i++) {
+    for (int j = 0; j < num_insts; j++) {
+      if (prob_2s[i][j] != 0.0) {
+        entropy_ds_mers += prob_2s[i][j] * log((double) 1.0 / prob_2s[i][j]) / log((double) num_insts);
+        entropy_ds_bits += prob_2s[i][j] * log((double) 1.0 / prob_2s[i][j]) / log((double) 2.0);
+      }
+    }
+  }
+
+  // mutual information is the sum of the single site entropies less the two site joint entropy
+  result.entropy_site1_mers = entropy_ss_site1_mers;
+  result.entropy_site2_mers = entropy_ss_site2_mers;
+  result.entropy_joint_mers = entropy_ds_mers;
+  result.mut_info_mers = entropy_ss_site1_mers + entropy_ss_site2_mers - entropy_ds_mers;
+  result.mut_info_bits = entropy_ss_site1_bits + entropy_ss_site2_bits - entropy_ds_bits;
+}
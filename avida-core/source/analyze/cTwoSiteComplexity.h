@@ -0,0 +1,104 @@
+/*
+ *  cTwoSiteComplexity.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cTwoSiteComplexity_h
+#define cTwoSiteComplexity_h
+
+#include "apto/core.h"
+#include "avida/core/Genome.h"
+
+class cAnalyzeJobQueue;
+class cAvidaContext;
+class cTestCPU;
+class cWorld;
+
+using namespace Avida;
+
+
+// cTwoSiteComplexity - one and two site entropies of a genome under mutation-selection balance (COMPLEXITY_TWO_SITES)
+//
+// Every site, and then every pair of sites, is an independent analyze job that tests all of its mutants and solves
+// for the balance itself.  Results are stored by site and by pair, in the order the pairs are visited by
+// (site1, site2 > site1), for the caller to write out.  Every site and pair is mutated from the unmodified genome; a
+// site skipped for zero fitness does not leave a mutation behind for the sites after it.
+
+class cTwoSiteComplexity
+{
+public:
+  struct sSiteResult
+  {
+    bool viable;              // false if the unmutated site has zero fitness, in which case the site carries no information
+    double entropy_mers;
+    double entropy_bits;
+    double complexity_mers;
+    double complexity_bits;
+  };
+
+  struct sPairResult
+  {
+    int site1;
+    int site2;
+    double entropy_site1_mers;
+    double entropy_site2_mers;
+    double entropy_joint_mers;
+    double mut_info_mers;
+    double mut_info_bits;
+  };
+
+private:
+  cWorld* m_world;
+  Genome m_base_genome;
+  int m_length;
+  int m_num_insts;
+  double m_base_fitness;
+  double m_mut_rate;
+  double m_converg_accuracy;
+
+  Apto::Array<sSiteResult> m_sites;
+  Apto::Array<sPairResult> m_pairs;
+
+  Apto::Mutex m_mutex;
+
+
+  cTwoSiteComplexity(); // @not_implemented
+  cTwoSiteComplexity(const cTwoSiteComplexity&); // @not_implemented
+  cTwoSiteComplexity& operator=(const cTwoSiteComplexity&); // @not_implemented
+
+
+public:
+  cTwoSiteComplexity(cWorld* world, const Genome& base_genome, double base_fitness, double mut_rate, double converg_accuracy);
+
+  // Runs all site jobs, then (if the base genome is viable) all pair jobs
+  void Run(cAnalyzeJobQueue& queue, cAvidaContext& ctx);
+
+  int GetNumSites() const { return m_sites.GetSize(); }
+  const sSiteResult& GetSite(int site) const { return m_sites[site]; }
+  int GetNumPairs() const { return m_pairs.GetSize(); }
+  const sPairResult& GetPair(int idx) const { return m_pairs[idx]; }
+
+  void ProcessSite(cAvidaContext& ctx, cTestCPU* testcpu, int site);
+  void ProcessPair(cAvidaContext& ctx, cTestCPU* testcpu, int idx);
+
+private:
+  double testFitness(cAvidaContext& ctx, cTestCPU* testcpu, const Genome& genome);
+};
+
+#endif
@@ -72,6 +72,15 @@ public:
   }
   
 protected:
+  // Signals while holding the lock, since the batch may be gone as soon as it is released
+  void jobFinished()
+  {
+    m_mutex.Lock();
+    m_jobs--;
+    m_cond.Signal();
+    m_mutex.Unlock();
+  }
+  
   template<class T> class tAnalyzeBatchJob : public tAnalyzeJob<T>
   {
   protected:
@@ -84,11 +93,7 @@ protected:
     void Run(cAvidaContext& ctx)
     {
       tAnalyzeJob<T>::Run(ctx);
-      
-      m_batch->m_mutex.Lock();
-      m_batch->m_jobs--;
-      m_batch->m_mutex.Unlock();
-      m_batch->m_cond.Signal();
+      m_batch->jobFinished();
     }
   };
 };
@@ -0,0 +1,105 @@
+/*
+ *  tAnalyzeTestJobBatch.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef tAnalyzeTestJobBatch_h
+#define tAnalyzeTestJobBatch_h
+
+#include "apto/core.h"
+#include "apto/platform.h"
+
+#include "cAnalyzeJob.h"
+#include "cAnalyzeJobQueue.h"
+#include "cAvidaContext.h"
+#include "cHardwareManager.h"
+#include "cTestCPU.h"
+#include "cWorld.h"
+#include "tAnalyzeJobBatch.h"
+
+#if APTO_PLATFORM(WINDOWS) && defined(AddJob)
+# undef AddJob
+#endif
+
+
+// tAnalyzeTestJobBatch - a tAnalyzeJobBatch that also takes indexed jobs that test genomes
+//
+// Each test job calls target->funJ(ctx, testcpu, idx) on the test CPU of the worker that runs it.  Its random number
+// generator is first reseeded with a seed the queue handed out, in submission order, when the job was added.  So as
+// long as every job only writes results to its own index, the results do not depend on how many workers ran the batch.
+
+template<class JobClass> class tAnalyzeTestJobBatch : public tAnalyzeJobBatch<JobClass>
+{
+protected:
+  template<class T> class tAnalyzeTestJob;
+  friend class tAnalyzeTestJob<JobClass>;
+
+protected:
+  cWorld* m_world;
+
+
+public:
+  tAnalyzeTestJobBatch(cWorld* world, cAnalyzeJobQueue& queue) : tAnalyzeJobBatch<JobClass>(queue), m_world(world) { ; }
+
+  using tAnalyzeJobBatch<JobClass>::AddJob;
+
+  void AddJob(JobClass* target, void (JobClass::*funJ)(cAvidaContext&, cTestCPU*, int), int idx)
+  {
+    const int seed = this->m_queue.GetSeedForSubmission();
+    this->m_mutex.Lock();
+    this->m_jobs++;
+    this->m_mutex.Unlock();
+    this->m_queue.AddJob(new tAnalyzeTestJob<JobClass>(this, target, funJ, idx, seed));
+  }
+
+protected:
+  template<class T> class tAnalyzeTestJob : public cAnalyzeJob
+  {
+  protected:
+    tAnalyzeTestJobBatch<T>* m_batch;
+    T* m_target;
+    void (T::*JobTask)(cAvidaContext&, cTestCPU*, int);
+    int m_idx;
+    int m_seed;
+
+  public:
+    tAnalyzeTestJob(tAnalyzeTestJobBatch<T>* batch, T* target, void (T::*funJ)(cAvidaContext&, cTestCPU*, int), int idx,
+                    int seed)
+      : cAnalyzeJob(), m_batch(batch), m_target(target), JobTask(funJ), m_idx(idx), m_seed(seed) { ; }
+
+    bool UsesTestCPU() const { return true; }
+
+    void Run(cAvidaContext& ctx)
+    {
+      cTestCPU* testcpu = m_batch->m_world->GetHardwareManager().CreateTestCPU(ctx);
+      RunOnTestCPU(ctx, testcpu);
+      delete testcpu;
+    }
+
+    void RunOnTestCPU(cAvidaContext& ctx, cTestCPU* testcpu)
+    {
+      ctx.GetRandom().ResetSeed(m_seed);
+      (m_target->*JobTask)(ctx, testcpu, m_idx);
+      m_batch->jobFinished();
+    }
+  };
+};
+
+
+#endif
@@ -26,6 +26,8 @@
 
 #include "AvidaTools.h"
 
+#include <cstring>
+
 using namespace AvidaTools;
 
 
@@ -33,6 +35,48 @@ const int MEMORY_INCREASE_MINIMUM = 5;
 const double MEMORY_INCREASE_FACTOR = 1.5;
 const double MEMORY_SHRINK_TEST_FACTOR = 4.0;
 
+// The fast comparison methods work directly on the raw site bytes
+typedef char InstructionIsOneByte[(sizeof(Avida::Instruction) == 1) ? 1 : -1];
+
+
+// Helpers for comparing eight sites at a time
+static inline uint64_t loadSites(const unsigned char* sites)
+{
+  uint64_t word;
+  memcpy(&word, sites, sizeof(word));
+  return word;
+}
+
+static inline int countNonZeroBytes(uint64_t word)
+{
+  // Fold each byte down into its low bit, then sum the low bits
+  word |= word >> 4;
+  word |= word >> 2;
+  word |= word >> 1;
+  word &= 0x0101010101010101ULL;
+  return (int)((word * 0x0101010101010101ULL) >> 56);
+}
+
+// Sort key that orders instructions the way their symbols order as strings (see Instruction::GetSymbol)
+static inline int symbolOrderKey(int op)
+{
+  if (op == 255) return '_' << 8;
+  
+  const int offset = op % 62;
+  int symbol = 0;
+  if (offset < 26) symbol = offset + 'a';
+  else if (offset < 52) symbol = offset - 26 + 'A';
+  else symbol = offset - 52 + '0';
+  
+  switch (op / 62) {
+    case 1: return ('+' << 8) | symbol;
+    case 2: return ('-' << 8) | symbol;
+    case 3: return ('~' << 8) | symbol;
+    case 4: return ('?' << 8) | symbol;
+  }
+  return symbol << 8;
+}
+
 
 Avida::InstructionSequence::InstructionSequence(const InstructionSequence& seq)
 : GeneticRepresentation(seq), m_seq(seq.GetSize()), m_active_size(seq.GetSize())
@@ -255,6 +299,55 @@ void Avida::InstructionSequence::Remove(int pos, int num_sites)
   adjustCapacity(new_size);
 }
 
+/*
+ Insert insts[i] before site positions[i] of the current sequence, for all i, in a single pass.
+ 
+ Positions must be sorted ascending.  Instructions sharing a position end up in the same order as in insts, which
+ matches calling Insert() once per site working backwards from the end of the list.
+*/
+void Avida::InstructionSequence::InsertSorted(const Apto::Array<int>& positions, const Apto::Array<Instruction>& insts)
+{
+  assert(positions.GetSize() == insts.GetSize());
+  
+  const int num_sites = positions.GetSize();
+  if (num_sites == 0) return;
+  
+  const int old_size = m_active_size;
+  adjustCapacity(old_size + num_sites);
+  
+  // Fill from the back, so every site moves at most once
+  int src = old_size - 1;
+  int dest = old_size + num_sites - 1;
+  for (int i = num_sites - 1; i >= 0; i--) {
+    assert(positions[i] >= 0 && positions[i] <= old_size);
+    assert(i == 0 || positions[i - 1] <= positions[i]);
+    while (src >= positions[i]) m_seq[dest--] = m_seq[src--];
+    m_seq[dest--] = insts[i];
+  }
+}
+
+/*
+ Remove all of the listed sites (positions in the current sequence, sorted ascending and distinct) in a single pass.
+*/
+void Avida::InstructionSequence::RemoveSorted(const Apto::Array<int>& positions)
+{
+  const int num_sites = positions.GetSize();
+  if (num_sites == 0) return;
+  assert(positions[0] >= 0 && positions[num_sites - 1] < m_active_size);
+  
+  int dest = positions[0];
+  int next = 0;
+  for (int src = positions[0]; src < m_active_size; src++) {
+    if (next < num_sites && positions[next] == src) {
+      next++;
+      continue;
+    }
+    m_seq[dest++] = m_seq[src];
+  }
+  assert(next == num_sites);
+  adjustCapacity(m_active_size - num_sites);
+}
+
 void Avida::InstructionSequence::Replace(int pos, int num_sites, const InstructionSequence& seq)
 {
   assert(pos >= 0);                         // Replace must be in sequence
@@ -360,12 +453,88 @@ bool Avida::InstructionSequence::operator==(const GeneticRepresentation& other_s
   
   // Make sure the sizes are the same.
   if (m_active_size != seq->m_active_size) return false;
+  if (m_active_size == 0) return true;
+  
+  return memcmp(rawSites(), seq->rawSites(), m_active_size) == 0;
+}
+
+
+// Orders sequences exactly as comparing their AsString() forms would, without building the strings
+bool Avida::InstructionSequence::operator<(const InstructionSequence& other_seq) const
+{
+  const int prefix = CommonPrefixLength(*this, other_seq);
+  if (prefix == m_active_size || prefix == other_seq.m_active_size) return m_active_size < other_seq.m_active_size;
+  
+  return symbolOrderKey(m_seq[prefix].GetOp()) < symbolOrderKey(other_seq[prefix].GetOp());
+}
+
+
+// 64-bit FNV-1a hash of the sequence
+uint64_t Avida::InstructionSequence::Hash() const
+{
+  uint64_t hash = 14695981039346656037ULL;
+  const unsigned char* sites = (m_active_size) ? rawSites() : NULL;
+  for (int i = 0; i < m_active_size; i++) {
+    hash ^= sites[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+
+int Avida::InstructionSequence::CommonPrefixLength(const InstructionSequence& seq1, const InstructionSequence& seq2)
+{
+  const int min_size = Apto::Min(seq1.GetSize(), seq2.GetSize());
+  if (min_size == 0) return 0;
   
-  // Then go through line by line.
-  for (int i = 0; i < m_active_size; i++)
-    if (m_seq[i] != (*seq)[i]) return false;
+  const unsigned char* sites1 = seq1.rawSites();
+  const unsigned char* sites2 = seq2.rawSites();
   
-  return true;
+  int i = 0;
+  for (; i + 8 <= min_size; i += 8) {
+    if (loadSites(sites1 + i) != loadSites(sites2 + i)) break;
+  }
+  while (i < min_size && sites1[i] == sites2[i]) i++;
+  
+  return i;
+}
+
+
+int Avida::InstructionSequence::CommonSuffixLength(const InstructionSequence& seq1, const InstructionSequence& seq2)
+{
+  const int min_size = Apto::Min(seq1.GetSize(), seq2.GetSize());
+  if (min_size == 0) return 0;
+  
+  const unsigned char* end1 = seq1.rawSites() + seq1.GetSize();
+  const unsigned char* end2 = seq2.rawSites() + seq2.GetSize();
+  
+  int i = 0;
+  for (; i + 8 <= min_size; i += 8) {
+    if (loadSites(end1 - i - 8) != loadSites(end2 - i - 8)) break;
+  }
+  while (i < min_size && end1[-i - 1] == end2[-i - 1]) i++;
+  
+  return i;
+}
+
+
+// Number of differing sites between [start1, start1 + length) of seq1 and [start2, start2 + length) of seq2
+int Avida::InstructionSequence::CountMismatches(const InstructionSequence& seq1, int start1,
+                                                const InstructionSequence& seq2, int start2, int length)
+{
+  assert(start1 >= 0 && start1 + length <= seq1.GetSize());
+  assert(start2 >= 0 && start2 + length <= seq2.GetSize());
+  if (length <= 0) return 0;
+  
+  const unsigned char* sites1 = seq1.rawSites() + start1;
+  const unsigned char* sites2 = seq2.rawSites() + start2;
+  
+  int mismatches = 0;
+  int i = 0;
+  for (; i + 8 <= length; i += 8) mismatches += countNonZeroBytes(loadSites(sites1 + i) ^ loadSites(sites2 + i));
+  for (; i < length; i++) if (sites1[i] != sites2[i]) mismatches++;
+  
+  return mismatches;
 }
 
 
@@ -495,10 +664,8 @@ int Avida::InstructionSequence::FindHammingDistance(const InstructionSequence& s
   
   int hamming_distance = seq1.GetSize() + seq2.GetSize() - 2 * overlap;
   
-  // Cycle through the overlap adding all differences to the distance.
-  for (int i = 0; i < overlap; i++) {
-    if (seq1[start1 + i] != seq2[start2 + i])  hamming_distance++;
-  }
+  // Add all differences within the overlap to the distance.
+  hamming_distance += CountMismatches(seq1, start1, seq2, start2, overlap);
   
   return hamming_distance;
 }
@@ -554,9 +721,8 @@ int Avida::InstructionSequence::FindEditDistance(const InstructionSequence& seq1
   if (!min_size) return (size1 > size2) ? size1 : size2;
   
   // Count how many direct matches we have at the front and end.
-  int match_front = 0, match_end = 0;
-  while (match_front < min_size && seq1[match_front] == seq2[match_front]) match_front++;
-  while (match_end < min_size && seq1[size1 - match_end - 1] == seq2[size2 - match_end - 1]) match_end++;
+  const int match_front = CommonPrefixLength(seq1, seq2);
+  const int match_end = CommonSuffixLength(seq1, seq2);
   
   // We can ignore the last match_end sites since we know they have distance zero.
   const int test_size1 = size1 - match_front - match_end;
@@ -22,12 +22,15 @@
 
 #include "cCPUMemory.h"
 
+#include "cInstSet.h"
+
 using namespace std;
 using namespace Avida;
 
 cCPUMemory::cCPUMemory(const cCPUMemory& in_memory) : InstructionSequence(in_memory), m_flag_array(in_memory.GetSize())
 {
   for (int i = 0; i < m_flag_array.GetSize(); i++) m_flag_array[i] = in_memory.m_flag_array[i];
+  resetDecode();
 }
 
 
@@ -35,6 +38,30 @@ void cCPUMemory::adjustCapacity(int new_size)
 {
   InstructionSequence::adjustCapacity(new_size);
   if (m_seq.GetSize() != m_flag_array.GetSize()) m_flag_array.Resize(m_seq.GetSize()); 
+  resetDecode();
+}
+
+
+void cCPUMemory::resetDecode()
+{
+  if (m_nop_run.GetSize() != m_seq.GetSize()) {
+    m_nop_run.ResizeClear(m_seq.GetSize());
+    m_nop_mod.ResizeClear(m_seq.GetSize());
+  }
+  m_nop_run.SetAll(DECODE_UNKNOWN);
+}
+
+
+void cCPUMemory::decodeNopRun(int pos, const cInstSet& inst_set) const
+{
+  // Find the end of the run, then fill in every site of it so that later reads anywhere in the run are hits
+  int end = pos;
+  while (end < m_active_size && inst_set.IsNop(m_seq[end])) {
+    m_nop_mod[end] = inst_set.GetNopMod(m_seq[end]);
+    end++;
+  }
+  for (int i = pos; i < end; i++) m_nop_run[i] = end - i;
+  if (end == pos) m_nop_run[pos] = 0;
 }
 
 
@@ -95,7 +122,7 @@ void cCPUMemory::Copy(int to, int from)
   assert(from >= 0);
   assert(from < m_seq.GetSize());
   
-  m_seq[to] = m_seq[from];
+  SetInst(to, m_seq[from]);
   m_flag_array[to] = m_flag_array[from];
 }
 
@@ -136,6 +163,50 @@ void cCPUMemory::Remove(int pos, int num_sites)
   adjustCapacity(new_size);
 }
 
+void cCPUMemory::InsertSorted(const Apto::Array<int>& positions, const Apto::Array<Instruction>& insts)
+{
+  assert(positions.GetSize() == insts.GetSize());
+  
+  const int num_sites = positions.GetSize();
+  if (num_sites == 0) return;
+  
+  const int old_size = m_active_size;
+  adjustCapacity(old_size + num_sites);
+  
+  int src = old_size - 1;
+  int dest = old_size + num_sites - 1;
+  for (int i = num_sites - 1; i >= 0; i--) {
+    assert(positions[i] >= 0 && positions[i] <= old_size);
+    assert(i == 0 || positions[i - 1] <= positions[i]);
+    while (src >= positions[i]) {
+      m_seq[dest] = m_seq[src];
+      m_flag_array[dest--] = m_flag_array[src--];
+    }
+    m_seq[dest] = insts[i];
+    m_flag_array[dest--] = 0;
+  }
+}
+
+void cCPUMemory::RemoveSorted(const Apto::Array<int>& positions)
+{
+  const int num_sites = positions.GetSize();
+  if (num_sites == 0) return;
+  assert(positions[0] >= 0 && positions[num_sites - 1] < m_active_size);
+  
+  int dest = positions[0];
+  int next = 0;
+  for (int src = positions[0]; src < m_active_size; src++) {
+    if (next < num_sites && positions[next] == src) {
+      next++;
+      continue;
+    }
+    m_seq[dest] = m_seq[src];
+    m_flag_array[dest++] = m_flag_array[src];
+  }
+  assert(next == num_sites);
+  adjustCapacity(m_active_size - num_sites);
+}
+
 void cCPUMemory::Replace(int pos, int num_sites, const InstructionSequence& genome)
 {
   assert(pos >= 0);                         // Replace must be in genome
@@ -147,6 +218,7 @@ void cCPUMemory::Replace(int pos, int num_sites, const InstructionSequence& geno
   // First, get the size right
   if (size_change > 0) prepareInsert(pos, size_change);
   else if (size_change < 0) Remove(pos, -size_change);
+  else resetDecode();
   
   // Now just copy everything over!
   for (int i = 0; i < genome.GetSize(); i++) {
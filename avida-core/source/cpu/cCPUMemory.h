@@ -25,6 +25,7 @@
 
 #include "avida/core/InstructionSequence.h"
 
+class cInstSet;
 
 class cCPUMemory : public Avida::InstructionSequence
 {
@@ -40,14 +41,24 @@ private:
   
   Apto::Array<unsigned char> m_flag_array;
 
+  // Decode cache: length of the nop run starting at each site (0 = not a nop) and the nop modifier of the site.
+  // Filled lazily by GetNopRun(), a whole run at a time, and invalidated by SetInst() and by every structural change.
+  // Every site of a known run that follows a known site is itself known, so invalidation can stop at the first
+  // unknown or non-nop site.
+  static const int DECODE_UNKNOWN = -1;
+  mutable Apto::Array<int> m_nop_run;
+  mutable Apto::Array<int> m_nop_mod;
+
   void adjustCapacity(int new_size);
   void prepareInsert(int pos, int num_sites);
+  void resetDecode();
+  void decodeNopRun(int pos, const cInstSet& inst_set) const;
 
 public:
   cCPUMemory(const cCPUMemory& in_memory);
-  cCPUMemory(const InstructionSequence& in_genome) : InstructionSequence(in_genome), m_flag_array(in_genome.GetSize()) { ; }
-  explicit cCPUMemory(int size = 1)  : InstructionSequence(size), m_flag_array(size) { ClearFlags(); }
-  cCPUMemory(const Apto::String& in_string) : InstructionSequence(in_string), m_flag_array(in_string.GetSize()) { ; }
+  cCPUMemory(const InstructionSequence& in_genome) : InstructionSequence(in_genome), m_flag_array(in_genome.GetSize()) { resetDecode(); }
+  explicit cCPUMemory(int size = 1)  : InstructionSequence(size), m_flag_array(size) { ClearFlags(); resetDecode(); }
+  cCPUMemory(const Apto::String& in_string) : InstructionSequence(in_string), m_flag_array(in_string.GetSize()) { resetDecode(); }
   ~cCPUMemory() { ; }
 
   inline bool FlagCopied(int pos) const     { return (MASK_COPIED   & m_flag_array[pos]) != 0; }
@@ -71,6 +82,13 @@ public:
 	inline void ClearFlagCopyMut(int pos)    { m_flag_array[pos] &= ~MASK_COPYMUT;  }
   inline void ClearFlagInjected(int pos)   { m_flag_array[pos] &= ~MASK_INJECTED; }
   
+  // Single site writes that should be visible to the decode cache must go through SetInst()
+  inline void SetInst(int pos, const Avida::Instruction& inst);
+  
+  // Number of consecutive nops starting at pos, and the modifier of a nop site
+  inline int GetNopRun(int pos, const cInstSet& inst_set) const;
+  inline int GetNopMod(int pos) const { return m_nop_mod[pos]; }
+  
   
   void Clear()
 	{
@@ -78,6 +96,7 @@ public:
 			m_seq[i].SetOp(0);
 			m_flag_array[i] = 0;
 		}
+		resetDecode();
 	}
   inline void ClearFlags() { m_flag_array.SetAll(0); }
   void Reset(int new_size);     // Reset size, clearing contents...
@@ -89,10 +108,28 @@ public:
   void Insert(int pos, const Avida::Instruction& inst);
   void Insert(int pos, const InstructionSequence& genome);
   void Remove(int pos, int num_sites = 1);
+  void InsertSorted(const Apto::Array<int>& positions, const Apto::Array<Avida::Instruction>& insts);
+  void RemoveSorted(const Apto::Array<int>& positions);
   void Replace(int pos, int num_sites, const InstructionSequence& genome);
 
   void operator=(const cCPUMemory& other_memory);
   void operator=(const InstructionSequence& other_genome);
 };
 
+
+inline void cCPUMemory::SetInst(int pos, const Avida::Instruction& inst)
+{
+  m_seq[pos] = inst;
+
+  // The run at pos, and any known run before it that reaches pos, are now stale
+  m_nop_run[pos] = DECODE_UNKNOWN;
+  for (int i = pos - 1; i >= 0 && m_nop_run[i] > 0; i--) m_nop_run[i] = DECODE_UNKNOWN;
+}
+
+inline int cCPUMemory::GetNopRun(int pos, const cInstSet& inst_set) const
+{
+  if (m_nop_run[pos] == DECODE_UNKNOWN) decodeNopRun(pos, inst_set);
+  return m_nop_run[pos];
+}
+
 #endif
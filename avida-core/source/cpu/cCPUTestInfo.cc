@@ -80,6 +80,35 @@ cCPUTestInfo& cCPUTestInfo::operator=(const cCPUTestInfo& test_info)
 }
 
 
+void cCPUTestInfo::CopySettings(const cCPUTestInfo& test_info)
+{
+  trace_task_order = test_info.trace_task_order;
+  use_random_inputs = test_info.use_random_inputs;
+  use_manual_inputs = test_info.use_manual_inputs;
+  manual_inputs = test_info.manual_inputs;
+  m_mut_rates = test_info.m_mut_rates;
+  m_cur_sg = test_info.m_cur_sg;
+  m_res_method = test_info.m_res_method;
+  m_res = test_info.m_res;
+  m_res_update = test_info.m_res_update;
+  m_res_cpu_cycle_offset = test_info.m_res_cpu_cycle_offset;
+}
+
+
+bool cCPUTestInfo::HasSameSettings(const cCPUTestInfo& test_info, bool compare_resources) const
+{
+  if (trace_task_order != test_info.trace_task_order || use_random_inputs != test_info.use_random_inputs ||
+      use_manual_inputs != test_info.use_manual_inputs || m_cur_sg != test_info.m_cur_sg) return false;
+  if (use_manual_inputs) {
+    if (manual_inputs.GetSize() != test_info.manual_inputs.GetSize()) return false;
+    for (int i = 0; i < manual_inputs.GetSize(); i++) if (manual_inputs[i] != test_info.manual_inputs[i]) return false;
+  }
+  if (!compare_resources) return true;
+  return m_res_method == test_info.m_res_method && m_res == test_info.m_res && m_res_update == test_info.m_res_update &&
+    m_res_cpu_cycle_offset == test_info.m_res_cpu_cycle_offset;
+}
+
+
 cCPUTestInfo::~cCPUTestInfo()
 {
   for (int i = 0; i < generation_tests; i++) {
@@ -82,6 +82,12 @@ public:
   ~cCPUTestInfo();
 
   void Clear();
+  
+  // Copy only the input and resource settings (not the tracer, results or test organisms)
+  void CopySettings(const cCPUTestInfo& test_info);
+  // Whether the input and resource settings match (mutation rates are not compared).  Resource settings can be left
+  // out where they cannot matter, such as an environment without resources.
+  bool HasSameSettings(const cCPUTestInfo& test_info, bool compare_resources = true) const;
  
   // Input Setup
   void TraceTaskOrder(bool _trace=true) { trace_task_order = _trace; }
@@ -460,10 +460,10 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
       for (int i = 0; i < num_mut; i++) mut_sites[i] = ctx.GetRandom().GetUInt(offspring_genome.GetSize() + 1);
       Apto::QSort(mut_sites);
       
-      // Actually do the mutations (in reverse sort order)
-      for (int i = mut_sites.GetSize() - 1; i >= 0; i--) {
-        offspring_genome.Insert(mut_sites[i], m_inst_set->GetRandomInst(ctx));
-      }
+      // Draw the new instructions in reverse sort order, then shift everything into place in one pass
+      Apto::Array<Instruction> mut_insts(num_mut);
+      for (int i = mut_sites.GetSize() - 1; i >= 0; i--) mut_insts[i] = m_inst_set->GetRandomInst(ctx);
+      offspring_genome.InsertSorted(mut_sites, mut_insts);
       
       totalMutations += num_mut;
     }
@@ -480,9 +480,10 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
     }
     
     // If we have lines to delete...
-    for (int i = 0; i < num_mut; i++) {
-      int site = ctx.GetRandom().GetUInt(offspring_genome.GetSize());
-      offspring_genome.Remove(site);
+    if (num_mut > 0) {
+      Apto::Array<int> mut_sites;
+      SelectDeletionSites(ctx, offspring_genome.GetSize(), num_mut, mut_sites);
+      offspring_genome.RemoveSorted(mut_sites);
     }
     
     totalMutations += num_mut;
@@ -514,7 +515,7 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
     if (num_mut > 0) {
       for (int i = 0; i < num_mut && totalMutations < maxmut; i++) {
         int site = ctx.GetRandom().GetUInt(memory.GetSize());
-        memory[site] = m_inst_set->GetRandomInst(ctx);
+        memory.SetInst(site, m_inst_set->GetRandomInst(ctx));
         totalMutations++;
       }
     }
@@ -536,10 +537,10 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
       for (int i = 0; i < num_mut; i++) mut_sites[i] = ctx.GetRandom().GetUInt(memory.GetSize() + 1);
       Apto::QSort(mut_sites);
       
-      // Actually do the mutations (in reverse sort order)
-      for (int i = mut_sites.GetSize() - 1; i >= 0; i--) {
-        memory.Insert(mut_sites[i], m_inst_set->GetRandomInst(ctx));
-      }
+      // Draw the new instructions in reverse sort order, then shift everything into place in one pass
+      Apto::Array<Instruction> mut_insts(num_mut);
+      for (int i = mut_sites.GetSize() - 1; i >= 0; i--) mut_insts[i] = m_inst_set->GetRandomInst(ctx);
+      memory.InsertSorted(mut_sites, mut_insts);
       
       totalMutations += num_mut;
     }
@@ -556,9 +557,10 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
     }
     
     // If we have lines to delete...
-    for (int i = 0; i < num_mut; i++) {
-      int site = ctx.GetRandom().GetUInt(memory.GetSize());
-      memory.Remove(site);
+    if (num_mut > 0) {
+      Apto::Array<int> mut_sites;
+      SelectDeletionSites(ctx, memory.GetSize(), num_mut, mut_sites);
+      memory.RemoveSorted(mut_sites);
     }
     
     totalMutations += num_mut;
@@ -569,6 +571,25 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
 }
 
 
+// Draws num_sites sites exactly as that many successive single-site deletions from the shrinking genome would, but
+// records each as a position in the original genome (sorted), so that they can all be removed in one pass
+void cHardwareBase::SelectDeletionSites(cAvidaContext& ctx, int genome_size, int num_sites, Apto::Array<int>& sites)
+{
+  sites.Resize(0);
+  for (int i = 0; i < num_sites; i++) {
+    int site = ctx.GetRandom().GetUInt(genome_size - i);
+    
+    // Skip over the sites already removed at or before this one
+    int idx = 0;
+    for (; idx < sites.GetSize() && sites[idx] <= site; idx++) site++;
+    
+    sites.Push(site);
+    for (int j = sites.GetSize() - 1; j > idx; j--) sites[j] = sites[j - 1];
+    sites[idx] = site;
+  }
+}
+
+
 bool cHardwareBase::doUniformMutation(cAvidaContext& ctx, InstructionSequence& genome)
 {
   
@@ -1111,7 +1132,7 @@ int cHardwareBase::PointMutate(cAvidaContext& ctx, double override_mut_rate)
     if (num_mut > 0) {
       for (int i = 0; i < num_mut; i++) {
         int site = ctx.GetRandom().GetUInt(memory.GetSize());
-        memory[site] = m_inst_set->GetRandomInst(ctx);
+        memory.SetInst(site, m_inst_set->GetRandomInst(ctx));
         totalMutations++;
       }
     }
@@ -1133,10 +1154,10 @@ int cHardwareBase::PointMutate(cAvidaContext& ctx, double override_mut_rate)
       for (int i = 0; i < num_mut; i++) mut_sites[i] = ctx.GetRandom().GetUInt(memory.GetSize() + 1);
       Apto::QSort(mut_sites);
       
-      // Actually do the mutations (in reverse sort order)
-      for (int i = mut_sites.GetSize() - 1; i >= 0; i--) {
-        memory.Insert(mut_sites[i], m_inst_set->GetRandomInst(ctx));
-      }
+      // Draw the new instructions in reverse sort order, then shift everything into place in one pass
+      Apto::Array<Instruction> mut_insts(num_mut);
+      for (int i = mut_sites.GetSize() - 1; i >= 0; i--) mut_insts[i] = m_inst_set->GetRandomInst(ctx);
+      memory.InsertSorted(mut_sites, mut_insts);
       
       totalMutations += num_mut;
     }
@@ -1153,9 +1174,10 @@ int cHardwareBase::PointMutate(cAvidaContext& ctx, double override_mut_rate)
     }
     
     // If we have lines to delete...
-    for (int i = 0; i < num_mut; i++) {
-      int site = ctx.GetRandom().GetUInt(memory.GetSize());
-      memory.Remove(site);
+    if (num_mut > 0) {
+      Apto::Array<int> mut_sites;
+      SelectDeletionSites(ctx, memory.GetSize(), num_mut, mut_sites);
+      memory.RemoveSorted(mut_sites);
     }
     
     totalMutations += num_mut;
@@ -125,6 +125,9 @@ public:
   
   // interrupt types
   enum interruptTypes {MSG_INTERRUPT = 0, MOVE_INTERRUPT};
+
+  // --------  Mutation Site Selection  --------
+  static void SelectDeletionSites(cAvidaContext& ctx, int genome_size, int num_sites, Apto::Array<int>& sites);
   
   // --------  Organism  ---------
   cOrganism* GetOrganism() { return m_organism; }
@@ -1480,22 +1480,25 @@ void cHardwareCPU::AdjustHeads()
 
 void cHardwareCPU::ReadLabel(int max_size)
 {
-  int count = 0;
-  cHeadCPU * inst_ptr = &( getIP() );
+  cHeadCPU& inst_ptr = getIP();
+  cCPUMemory& memory = inst_ptr.GetMemory();
   
   GetLabel().Clear();
   
-  while (m_inst_set->IsNop(inst_ptr->GetNextInst()) &&
-         (count < max_size)) {
-    count++;
-    inst_ptr->Advance();
-    GetLabel().AddNop(m_inst_set->GetNopMod(inst_ptr->GetInst()));
+  // The memory's decode cache knows how many nops follow, so the label is copied out without re-testing each site
+  int count = inst_ptr.GetNextNopRun();
+  if (count > max_size) count = max_size;
+  if (count == 0) return;
+  
+  const int start = inst_ptr.GetPosition() + 1;
+  const int max_exe_size = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
+  for (int i = 0; i < count; i++) {
+    GetLabel().AddNop(memory.GetNopMod(start + i));
     
     // If this is the first line of the template, mark it executed.
-    if (GetLabel().GetSize() <=	m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get()) {
-      inst_ptr->SetFlagExecuted();
-    }
+    if (GetLabel().GetSize() <= max_exe_size) memory.SetFlagExecuted(start + i);
   }
+  inst_ptr.AbsSet(start + count - 1);
 }
 
 
@@ -1620,11 +1623,7 @@ inline int cHardwareCPU::FindModifiedRegister(int default_register)
 {
   assert(default_register < NUM_REGISTERS);  // Reg ID too high.
   
-  if (m_inst_set->IsNop(getIP().GetNextInst())) {
-    getIP().Advance();
-    default_register = m_inst_set->GetNopMod(getIP().GetInst());
-    getIP().SetFlagExecuted();
-  }
+  getIP().ReadNextNopMod(default_register);
   return default_register;
 }
 
@@ -1632,11 +1631,7 @@ inline int cHardwareCPU::FindModifiedNextRegister(int default_register)
 {
   assert(default_register < NUM_REGISTERS);  // Reg ID too high.
   
-  if (m_inst_set->IsNop(getIP().GetNextInst())) {
-    getIP().Advance();
-    default_register = m_inst_set->GetNopMod(getIP().GetInst());
-    getIP().SetFlagExecuted();
-  } else {
+  if (!getIP().ReadNextNopMod(default_register)) {
     default_register = (default_register + 1) % NUM_REGISTERS;
   }
   return default_register;
@@ -1646,11 +1641,7 @@ inline int cHardwareCPU::FindModifiedPreviousRegister(int default_register)
 {
   assert(default_register < NUM_REGISTERS);  // Reg ID too high.
   
-  if (m_inst_set->IsNop(getIP().GetNextInst())) {
-    getIP().Advance();
-    default_register = m_inst_set->GetNopMod(getIP().GetInst());
-    getIP().SetFlagExecuted();
-  } else {
+  if (!getIP().ReadNextNopMod(default_register)) {
     default_register = (default_register + NUM_REGISTERS - 1) % NUM_REGISTERS;
   }
   return default_register;
@@ -1661,11 +1652,7 @@ inline int cHardwareCPU::FindModifiedHead(int default_head)
 {
   assert(default_head < NUM_HEADS); // Head ID too high.
   
-  if (m_inst_set->IsNop(getIP().GetNextInst())) {
-    getIP().Advance();
-    default_head = m_inst_set->GetNopMod(getIP().GetInst());
-    getIP().SetFlagExecuted();
-  }
+  getIP().ReadNextNopMod(default_head);
   return default_head;
 }
 
@@ -1687,7 +1674,7 @@ bool cHardwareCPU::Allocate_Random(cAvidaContext& ctx, const int old_size, const
   m_memory.Resize(new_size);
   
   for (int i = old_size; i < new_size; i++) {
-    m_memory[i] = m_inst_set->GetRandomInst(ctx);
+    m_memory.SetInst(i, m_inst_set->GetRandomInst(ctx));
   }
   return true;
 }
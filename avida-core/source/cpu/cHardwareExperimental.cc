@@ -1295,22 +1295,25 @@ void cHardwareExperimental::AdjustHeads()
 
 void cHardwareExperimental::ReadLabel(int max_size)
 {
-  int count = 0;
-  cHeadCPU * inst_ptr = &( getIP() );
+  cHeadCPU& inst_ptr = getIP();
+  cCPUMemory& memory = inst_ptr.GetMemory();
   
   GetLabel().Clear();
   
-  while (m_inst_set->IsNop(inst_ptr->GetNextInst()) &&
-         (count < max_size)) {
-    count++;
-    inst_ptr->Advance();
-    GetLabel().AddNop(m_inst_set->GetNopMod(inst_ptr->GetInst()));
+  // The memory's decode cache knows how many nops follow, so the label is copied out without re-testing each site
+  int count = inst_ptr.GetNextNopRun();
+  if (count > max_size) count = max_size;
+  if (count == 0) return;
+  
+  const int start = inst_ptr.GetPosition() + 1;
+  const int max_exe_size = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
+  for (int i = 0; i < count; i++) {
+    GetLabel().AddNop(memory.GetNopMod(start + i));
     
     // If this is the first line of the template, mark it executed.
-    if (GetLabel().GetSize() <=	m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get()) {
-      inst_ptr->SetFlagExecuted();
-    }
+    if (GetLabel().GetSize() <= max_exe_size) memory.SetFlagExecuted(start + i);
   }
+  inst_ptr.AbsSet(start + count - 1);
 }
 
 bool cHardwareExperimental::ForkThread()
@@ -1397,11 +1400,7 @@ inline int cHardwareExperimental::FindModifiedRegister(int default_register)
 {
   assert(default_register < NUM_REGISTERS);  // Reg ID too high.
   
-  if (m_inst_set->IsNop(getIP().GetNextInst())) {
-    getIP().Advance();
-    default_register = m_inst_set->GetNopMod(getIP().GetInst());
-    getIP().SetFlagExecuted();
-  }
+  getIP().ReadNextNopMod(default_register);
   return default_register;
 }
 
@@ -1409,11 +1408,7 @@ inline int cHardwareExperimental::FindModifiedNextRegister(int default_register)
 {
   assert(default_register < NUM_REGISTERS);  // Reg ID too high.
   
-  if (m_inst_set->IsNop(getIP().GetNextInst())) {
-    getIP().Advance();
-    default_register = m_inst_set->GetNopMod(getIP().GetInst());
-    getIP().SetFlagExecuted();
-  } else {
+  if (!getIP().ReadNextNopMod(default_register)) {
     default_register = (default_register + 1) % NUM_REGISTERS;
   }
   return default_register;
@@ -1423,11 +1418,7 @@ inline int cHardwareExperimental::FindModifiedPreviousRegister(int default_regis
 {
   assert(default_register < NUM_REGISTERS);  // Reg ID too high.
   
-  if (m_inst_set->IsNop(getIP().GetNextInst())) {
-    getIP().Advance();
-    default_register = m_inst_set->GetNopMod(getIP().GetInst());
-    getIP().SetFlagExecuted();
-  } else {
+  if (!getIP().ReadNextNopMod(default_register)) {
     default_register = (default_register + NUM_REGISTERS - 1) % NUM_REGISTERS;
   }
   return default_register;
@@ -1438,11 +1429,7 @@ inline int cHardwareExperimental::FindModifiedHead(int default_head)
 {
   assert(default_head < NUM_HEADS); // Head ID too high.
   
-  if (m_inst_set->IsNop(getIP().GetNextInst())) {
-    getIP().Advance();
-    default_head = m_inst_set->GetNopMod(getIP().GetInst());
-    getIP().SetFlagExecuted();
-  }
+  getIP().ReadNextNopMod(default_head);
   return default_head;
 }
 
@@ -1464,7 +1451,7 @@ bool cHardwareExperimental::Allocate_Random(cAvidaContext& ctx, const int old_si
   m_memory.Resize(new_size);
   
   for (int i = old_size; i < new_size; i++) {
-    m_memory[i] = m_inst_set->GetRandomInst(ctx);
+    m_memory.SetInst(i, m_inst_set->GetRandomInst(ctx));
   }
   return true;
 }
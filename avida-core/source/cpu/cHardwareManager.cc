@@ -34,10 +34,13 @@
 #include "cHardwareStatusPrinter.h"
 #include "cInitFile.h"
 #include "cInstSet.h"
+#include "cObjectPool.h"
 #include "cStringList.h"
 #include "cStringUtil.h"
 #include "cWorld.h"
 
+#include <new>
+
 using namespace Avida;
 
 static const Apto::BasicString<Apto::ThreadSafe> s_prop_id_instset("instset");
@@ -48,11 +51,20 @@ cHardwareManager::cHardwareManager(cWorld* world)
   cString filename = world->GetConfig().INST_SET.Get();
   m_is_name_map.Set("(default)", 0);
 
+  const bool pooled = world->GetConfig().POOL_ALLOCATION.Get();
+  m_hw_pools.Resize(HARDWARE_TYPE_CPU_BCR + 1);
+  m_hw_pools.SetAll(NULL);
+  m_hw_pools[HARDWARE_TYPE_CPU_ORIGINAL] = new cObjectPool("cpu", sizeof(cHardwareCPU), pooled);
+  m_hw_pools[HARDWARE_TYPE_CPU_TRANSSMT] = new cObjectPool("transsmt", sizeof(cHardwareTransSMT), pooled);
+  m_hw_pools[HARDWARE_TYPE_CPU_EXPERIMENTAL] = new cObjectPool("experimental", sizeof(cHardwareExperimental), pooled);
+  m_hw_pools[HARDWARE_TYPE_CPU_GP8] = new cObjectPool("gp8", sizeof(cHardwareGP8), pooled);
+  m_hw_pools[HARDWARE_TYPE_CPU_BCR] = new cObjectPool("bcr", sizeof(cHardwareBCR), pooled);
 }
 
 cHardwareManager::~cHardwareManager()
 {
   for (int i = 0; i < m_inst_sets.GetSize(); i++) delete m_inst_sets[i];
+  for (int i = 0; i < m_hw_pools.GetSize(); i++) delete m_hw_pools[i];
 }
 
 
@@ -256,21 +268,23 @@ cHardwareBase* cHardwareManager::Create(cAvidaContext& ctx, cOrganism* org, cons
   }
   
   cHardwareBase* hw = 0;
-  switch (inst_set->GetHardwareType()) {
+  const int hw_type = inst_set->GetHardwareType();
+  cObjectPool* pool = (hw_type >= 0 && hw_type < m_hw_pools.GetSize()) ? m_hw_pools[hw_type] : NULL;
+  switch (hw_type) {
     case HARDWARE_TYPE_CPU_ORIGINAL:
-      hw = new cHardwareCPU(ctx, m_world, org, inst_set);
+      hw = new (pool->Allocate(sizeof(cHardwareCPU))) cHardwareCPU(ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_TRANSSMT:
-      hw = new cHardwareTransSMT(ctx, m_world, org, inst_set);
+      hw = new (pool->Allocate(sizeof(cHardwareTransSMT))) cHardwareTransSMT(ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_EXPERIMENTAL:
-      hw = new cHardwareExperimental(ctx, m_world, org, inst_set);
+      hw = new (pool->Allocate(sizeof(cHardwareExperimental))) cHardwareExperimental(ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_GP8:
-      hw = new cHardwareGP8(ctx, m_world, org, inst_set);
+      hw = new (pool->Allocate(sizeof(cHardwareGP8))) cHardwareGP8(ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_BCR:
-      hw = new cHardwareBCR(ctx, m_world, org, inst_set);
+      hw = new (pool->Allocate(sizeof(cHardwareBCR))) cHardwareBCR(ctx, m_world, org, inst_set);
       break;
     default:
       assert(false);
@@ -282,6 +296,16 @@ cHardwareBase* cHardwareManager::Create(cAvidaContext& ctx, cOrganism* org, cons
   return hw;
 }
 
+void cHardwareManager::Destroy(cHardwareBase* hw)
+{
+  if (hw == NULL) return;
+  
+  // Hardware storage comes from the pools in Create, so it must be torn down by hand and handed back to its pool
+  void* storage = dynamic_cast<void*>(hw);
+  hw->~cHardwareBase();
+  cObjectPool::Release(storage);
+}
+
 bool cHardwareManager::RegisterInstSet(const Apto::String& name, cInstSet* inst_set)
 {
   if (m_is_name_map.Has(name)) return false;
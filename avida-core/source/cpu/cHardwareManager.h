@@ -31,6 +31,7 @@ namespace Avida {
 class cAvidaContext;
 class cHardwareBase;
 class cInstSet;
+class cObjectPool;
 class cOrganism;
 class cStringList;
 class cUserFeedback;
@@ -46,6 +47,7 @@ private:
   cWorld* m_world;
   Apto::Array<cInstSet*> m_inst_sets;
   Apto::Map<Apto::String, int> m_is_name_map;
+  Apto::Array<cObjectPool*> m_hw_pools;  // Hardware storage, indexed by hardware type (NULL for unsupported types)
 
   
   cHardwareManager(); // @not_implemented
@@ -65,6 +67,7 @@ public:
   bool ConvertLegacyInstSetFile(cString filename, cStringList& str_list, cUserFeedback* feedback = NULL);
   
   cHardwareBase* Create(cAvidaContext& ctx, cOrganism* org, const Genome& mg);
+  static void Destroy(cHardwareBase* hw);
   inline cTestCPU* CreateTestCPU(cAvidaContext& ctx) { return new cTestCPU(ctx, m_world); }
 
   inline bool IsInstSet(const Apto::String& name) const { return m_is_name_map.Has(name); }
@@ -78,6 +81,9 @@ public:
   int GetNumInstSets() const { return m_inst_sets.GetSize(); }
   
   bool RegisterInstSet(const Apto::String& name, cInstSet* inst_set);
+  
+  int GetNumHardwarePools() const { return m_hw_pools.GetSize(); }
+  const cObjectPool* GetHardwarePool(int hw_type) const { return m_hw_pools[hw_type]; }
     
 private:
   bool loadInstSet(int hw_type, const Apto::String& name, int stack_size, int uops_per_cycle, cStringList& sl, cUserFeedback* feedback);
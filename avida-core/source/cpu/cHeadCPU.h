@@ -82,8 +82,12 @@ public:
   inline const Instruction& GetInst(int offset) const { return GetMemory()[m_position + offset]; }
   inline Instruction GetPrevInst() const;
   inline Instruction GetNextInst() const;
+  
+  // Nop lookahead through the memory's decode cache
+  inline int GetNextNopRun() const;
+  inline bool ReadNextNopMod(int& nop_mod);  // Steps onto a following nop, marking it executed
 
-  inline void SetInst(const Instruction& value) { GetMemory()[m_position] = value; }
+  inline void SetInst(const Instruction& value) { GetMemory().SetInst(m_position, value); }
   inline void InsertInst(const Instruction& inst) { GetMemory().Insert(m_position, inst); }
   inline void RemoveInst() { GetMemory().Remove(m_position); }
 
@@ -169,4 +173,19 @@ inline Instruction cHeadCPU::GetNextInst() const
   return (AtEnd()) ? m_hardware->GetInstSet().GetInstError() : GetMemory()[m_position + 1];
 }
 
+inline int cHeadCPU::GetNextNopRun() const
+{
+  return (AtEnd()) ? 0 : GetMemory().GetNopRun(m_position + 1, m_hardware->GetInstSet());
+}
+
+inline bool cHeadCPU::ReadNextNopMod(int& nop_mod)
+{
+  if (GetNextNopRun() == 0) return false;
+  
+  m_position++;
+  nop_mod = GetMemory().GetNopMod(m_position);
+  GetMemory().SetFlagExecuted(m_position);
+  return true;
+}
+
 #endif
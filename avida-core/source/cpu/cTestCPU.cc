@@ -253,7 +253,7 @@ bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, cons
   if (test_info.org_array[cur_depth] != NULL) {
     delete test_info.org_array[cur_depth];
   }
-  cOrganism* organism = new cOrganism(m_world, ctx, genome, -1, Systematics::Source(Systematics::DIVISION, "", true));
+  cOrganism* organism = new (m_world) cOrganism(m_world, ctx, genome, -1, Systematics::Source(Systematics::DIVISION, "", true));
   
   // Copy the test mutation rates
   organism->MutationRates().Copy(test_info.MutationRates());
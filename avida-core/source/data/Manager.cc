@@ -29,6 +29,8 @@
 #include "avida/data/Provider.h"
 #include "avida/data/Recorder.h"
 
+#include "apto/core/Thread.h"
+
 #include <cassert>
 
 
@@ -42,13 +44,29 @@ bool Avida::Data::Manager::s_registered_with_facet_factory =
   Avida::WorldFacet::RegisterFacetType(Avida::Reserved::DataManagerFacetID, DeserializeDataManager);
 
 
-Avida::Data::Manager::Manager() : m_world(NULL), m_available(new DataSet)
+class Avida::Data::Manager::NotificationThread : public Apto::Thread
+{
+private:
+  Manager* m_mgr;
+  
+  void Run();
+  
+public:
+  NotificationThread(Manager* mgr) : m_mgr(mgr) { ; }
+};
+
+
+Avida::Data::Manager::Manager()
+  : m_world(NULL), m_available(new DataSet), m_handle_index(new HandleIndex)
+  , m_notify_thread(NULL), m_notify_pending_update(0), m_notify_busy(false), m_notify_stop(false)
 {
   
 }
 
 Avida::Data::Manager::~Manager()
 {
+  // Delivers any update still queued for background recorders before the thread exits
+  stopNotificationThread();
 }
 
 
@@ -295,6 +313,12 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
     }
   }
   
+  // Resolve the requested data ids to handles once, rather than parsing and looking them up every update.  Published
+  // indices are never modified, so extend a private copy.
+  HandleIndexPtr index(new HandleIndex(*m_handle_index));
+  internRequestedData(*index, recorder);
+  m_handle_index = index;
+  
   m_rwlock.WriteUnlock();
   
   
@@ -303,16 +327,15 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
       if ((*it.Get())->SupportsConcurrentUpdate()) {
         ProviderPtr provider = (*it.Get());
         provider->UpdateProvidedValues(UPDATE_CONCURRENT);
-        
-        // Invalidate cached entries for this provider
-        ConstDataSetPtr provided = provider->Provides();
-        m_current_value_mutex.Lock();
-        for (ConstDataSetIterator pit = provided->Begin(); pit.Next();) m_current_values.Remove(*pit.Get());
-        m_current_value_mutex.Unlock();
       }
     }
-    DataRetrievalFunctor drf(this, &Manager::GetCurrentValue);
-    recorder->NotifyData(UPDATE_CONCURRENT, drf);
+    
+    m_rwlock.ReadLock();
+    ValueTable values(this, m_handle_index);
+    m_rwlock.ReadUnlock();
+    
+    DataRetrievalFunctor drf(&values, &ValueTable::GetValue);
+    notifyRecorder(recorder, UPDATE_CONCURRENT, values, drf);
   }
   
   // Store the recorder
@@ -325,14 +348,61 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
 bool Avida::Data::Manager::DetachRecorder(RecorderPtr recorder)
 {
   bool success = false;
+  m_rwlock.WriteLock();
   m_recorder_mutex.Lock();
   success = m_recorders.Remove(recorder);
+  
+  // Rebuild the handles from the remaining recorders, so that the value table stops capturing data nobody requested
+  if (success) {
+    HandleIndexPtr index(new HandleIndex);
+    for (Apto::Set<RecorderPtr>::Iterator it = m_recorders.Begin(); it.Next();) internRequestedData(*index, *it.Get());
+    m_handle_index = index;
+  }
+  
   // @TODO - this should probably deactivate data providers that are no longer needed, or at least adjust schedule
   m_recorder_mutex.Unlock();
+  m_rwlock.WriteUnlock();
   return success;
 }
 
 
+void Avida::Data::Manager::SetConcurrentNotification(bool enabled)
+{
+  if (enabled && !m_notify_thread) {
+    m_notify_stop = false;
+    m_notify_thread = new NotificationThread(this);
+    m_notify_thread->Start();
+  } else if (!enabled) {
+    stopNotificationThread();
+  }
+}
+
+void Avida::Data::Manager::FlushNotifications()
+{
+  m_notify_mutex.Lock();
+  while (m_notify_pending || m_notify_busy) m_notify_cond.Wait(m_notify_mutex);
+  m_notify_mutex.Unlock();
+}
+
+
+void Avida::Data::Manager::ReleaseProviders()
+{
+  // The notification thread may still hold the last value table, which references the providers
+  stopNotificationThread();
+  
+  m_rwlock.WriteLock();
+  m_recorder_mutex.Lock();
+  m_active_providers.Resize(0);
+  m_active_arg_providers.Resize(0);
+  m_active_provider_map.Clear();
+  m_active_arg_provider_map.Clear();
+  m_active_args.Clear();
+  m_handle_index = HandleIndexPtr(new HandleIndex);
+  m_recorder_mutex.Unlock();
+  m_rwlock.WriteUnlock();
+}
+
+
 bool Avida::Data::Manager::Register(const DataID& data_id, ProviderActivateFunctor functor)
 {
   if (data_id.GetSize() == 0 || data_id[data_id.GetSize() - 1] == ']') return false;
@@ -420,17 +490,14 @@ Avida::WorldFacetID Avida::Data::Manager::UpdateAfter() const
 
 void Avida::Data::Manager::PerformUpdate(Context&, Update current_update)
 {
-  m_current_value_mutex.Lock();
-  m_current_values.Clear();
-  m_current_value_mutex.Unlock();
-  
   m_rwlock.ReadLock();
   
   // Update all of the active providers
   for (int i = 0; i < m_active_providers.GetSize(); i++) m_active_providers[i]->UpdateProvidedValues(current_update);
   
-  // Notify recorders that new data is available
-  DataRetrievalFunctor drf(this, &Manager::GetCurrentValue);
+  // Notify recorders that new data is available, each value being computed once when a recorder first asks for it
+  ValueTablePtr values(new ValueTable(this, m_handle_index));
+  DataRetrievalFunctor drf(&(*values), &ValueTable::GetValue);
 
   // Lock recorder mutex before releasing RWLock, so that only recorders that have values will be notified
   m_recorder_mutex.Lock();
@@ -438,18 +505,33 @@ void Avida::Data::Manager::PerformUpdate(Context&, Update current_update)
   // Release RWLock before notification to prevent double RWLocking deadlock during recorder attachment
   m_rwlock.ReadUnlock();
   
+  Apto::Array<RecorderPtr> background;
   for (Apto::Set<RecorderPtr>::Iterator it = m_recorders.Begin(); it.Next();) {
-    (*it.Get())->NotifyData(current_update, drf);
+    RecorderPtr recorder = *it.Get();
+    if (m_notify_thread && recorder->SupportsConcurrentNotification()) background.Push(recorder);
+    else notifyRecorder(recorder, current_update, *values, drf);
   }
   m_recorder_mutex.Unlock();
+  
+  if (background.GetSize()) {
+    // The providers can only be consulted from this thread, so capture everything the background recorders will ask
+    // for before handing the table over.  This only blocks while an earlier update is still queued.
+    for (int i = 0; i < background.GetSize(); i++) values->CaptureRecorderValues(background[i]);
+    values->Seal();
+    
+    m_notify_mutex.Lock();
+    while (m_notify_pending) m_notify_cond.Wait(m_notify_mutex);
+    m_notify_pending = values;
+    m_notify_pending_update = current_update;
+    m_notify_pending_recorders = background;
+    m_notify_cond.Broadcast();
+    m_notify_mutex.Unlock();
+  }
 }
 
 Avida::Data::PackagePtr Avida::Data::Manager::GetCurrentValue(const DataID& data_id) const
 {
   PackagePtr rtn;
-  Apto::MutexAutoLock cvmutexlock(m_current_value_mutex);
-  
-  if (m_current_values.Get(data_id, rtn)) return rtn;
   
   if (data_id[data_id.GetSize() - 1] == ']') {
     // Find start of argument
@@ -470,7 +552,6 @@ Avida::Data::PackagePtr Avida::Data::Manager::GetCurrentValue(const DataID& data
     ArgumentedProviderPtr arg_provider;
     if (m_active_arg_provider_map.Get(raw_id, arg_provider)) {
       rtn = arg_provider->GetProvidedValueForArgument(raw_id, argument);
-      if (rtn) m_current_values[data_id] = rtn;
     }
     m_rwlock.ReadUnlock();
   } else {
@@ -478,7 +559,6 @@ Avida::Data::PackagePtr Avida::Data::Manager::GetCurrentValue(const DataID& data
     ProviderPtr provider;
     if (m_active_provider_map.Get(data_id, provider)) {
       rtn = provider->GetProvidedValue(data_id);
-      if (rtn) m_current_values[data_id] = rtn;
     }
     m_rwlock.ReadUnlock();
   }
@@ -486,3 +566,163 @@ Avida::Data::PackagePtr Avida::Data::Manager::GetCurrentValue(const DataID& data
   return rtn;
 }
 
+
+void Avida::Data::Manager::stopNotificationThread()
+{
+  if (!m_notify_thread) return;
+  
+  m_notify_mutex.Lock();
+  m_notify_stop = true;
+  m_notify_cond.Broadcast();
+  m_notify_mutex.Unlock();
+  
+  m_notify_thread->Join();
+  delete m_notify_thread;
+  m_notify_thread = NULL;
+}
+
+
+void Avida::Data::Manager::internRequestedData(HandleIndex& index, RecorderPtr recorder)
+{
+  // Must be called with the write lock held, after the providers for all requested data have been activated
+  Apto::Array<DataHandle> recorder_handles;
+  
+  ConstDataSetPtr requested = recorder->RequestedData();
+  for (ConstDataSetIterator it = requested->Begin(); it.Next();) {
+    const DataID& data_id = *it.Get();
+    
+    DataHandle handle = -1;
+    if (data_id.GetSize() && !index.handles.Get(data_id, handle)) {
+      HandleEntry entry;
+      entry.data_id = data_id;
+      if (data_id[data_id.GetSize() - 1] == ']') {
+        // Find start of argument
+        int start_idx = -1;
+        for (int i = 0; i < data_id.GetSize(); i++) {
+          if (data_id[i] == '[') {
+            start_idx = i + 1;
+            break;
+          }
+        }
+        if (start_idx != -1) {
+          entry.argument = data_id.Substring(start_idx, data_id.GetSize() - start_idx - 1);
+          entry.raw_id = data_id.Substring(0, start_idx) + "]";
+          m_active_arg_provider_map.Get(entry.raw_id, entry.arg_provider);
+        }
+      } else {
+        m_active_provider_map.Get(data_id, entry.provider);
+      }
+      
+      handle = index.entries.GetSize();
+      index.handles[data_id] = handle;
+      index.entries.Push(entry);
+    }
+    recorder_handles.Push(handle);
+  }
+  
+  int slot = -1;
+  if (!index.recorder_slots.Get(recorder, slot)) {
+    slot = index.recorder_handles.GetSize();
+    index.recorder_slots[recorder] = slot;
+    index.recorder_handles.Push(recorder_handles);
+  } else {
+    index.recorder_handles[slot] = recorder_handles;
+  }
+}
+
+
+void Avida::Data::Manager::notifyRecorder(RecorderPtr recorder, Update update, const ValueTable& values,
+                                          DataRetrievalFunctor retrieve_data)
+{
+  const Apto::Array<DataHandle>* handles = NULL;
+  if (recorder->SupportsIndexedNotification() && (handles = values.RecorderHandles(recorder))) {
+    IndexedValues indexed(values, *handles);
+    IndexedDataRetrievalFunctor idrf(&indexed, &IndexedValues::GetValue);
+    recorder->NotifyIndexedData(update, idrf);
+  } else {
+    recorder->NotifyData(update, retrieve_data);
+  }
+}
+
+
+Avida::Data::Manager::ValueTable::ValueTable(const Manager* manager, HandleIndexPtr index)
+  : m_manager(manager), m_index(index), m_values(index->entries.GetSize()), m_captured(index->entries.GetSize())
+  , m_sealed(false)
+{
+  m_captured.SetAll(false);
+}
+
+void Avida::Data::Manager::ValueTable::capture(DataHandle handle) const
+{
+  const HandleEntry& entry = m_index->entries[handle];
+  if (entry.arg_provider) {
+    m_values[handle] = entry.arg_provider->GetProvidedValueForArgument(entry.raw_id, entry.argument);
+  } else if (entry.provider) {
+    m_values[handle] = entry.provider->GetProvidedValue(entry.data_id);
+  }
+  m_captured[handle] = true;
+}
+
+Avida::Data::PackagePtr Avida::Data::Manager::ValueTable::GetValue(const DataID& data_id) const
+{
+  DataHandle handle = -1;
+  if (m_index->handles.Get(data_id, handle)) return GetHandleValue(handle);
+  
+  // Data that no attached recorder requested, resolve it the long way
+  return m_manager->GetCurrentValue(data_id);
+}
+
+Avida::Data::PackagePtr Avida::Data::Manager::ValueTable::GetSnapshotValue(const DataID& data_id) const
+{
+  // Used off of the simulation thread, where the providers cannot be consulted, so only captured values are available
+  DataHandle handle = -1;
+  if (m_index->handles.Get(data_id, handle) && m_captured[handle]) return m_values[handle];
+  return PackagePtr();
+}
+
+void Avida::Data::Manager::ValueTable::CaptureRecorderValues(RecorderPtr recorder)
+{
+  const Apto::Array<DataHandle>* handles = RecorderHandles(recorder);
+  if (!handles) return;
+  for (int i = 0; i < handles->GetSize(); i++) GetHandleValue((*handles)[i]);
+}
+
+const Apto::Array<Avida::Data::Manager::DataHandle>* Avida::Data::Manager::ValueTable::RecorderHandles(RecorderPtr recorder) const
+{
+  // Recorders attached after this table's index was published have no handles in it
+  int slot = -1;
+  if (m_index->recorder_slots.Get(recorder, slot)) return &m_index->recorder_handles[slot];
+  return NULL;
+}
+
+
+void Avida::Data::Manager::NotificationThread::Run()
+{
+  while (true) {
+    m_mgr->m_notify_mutex.Lock();
+    while (!m_mgr->m_notify_pending && !m_mgr->m_notify_stop) m_mgr->m_notify_cond.Wait(m_mgr->m_notify_mutex);
+    
+    // Stop only once everything queued has been delivered
+    if (!m_mgr->m_notify_pending) {
+      m_mgr->m_notify_mutex.Unlock();
+      break;
+    }
+    
+    ValueTablePtr values = m_mgr->m_notify_pending;
+    Update update = m_mgr->m_notify_pending_update;
+    Apto::Array<RecorderPtr> recorders = m_mgr->m_notify_pending_recorders;
+    m_mgr->m_notify_pending = ValueTablePtr();
+    m_mgr->m_notify_pending_recorders.Resize(0);
+    m_mgr->m_notify_busy = true;
+    m_mgr->m_notify_cond.Broadcast();  // the buffer is free for the next update
+    m_mgr->m_notify_mutex.Unlock();
+    
+    DataRetrievalFunctor drf(&(*values), &ValueTable::GetSnapshotValue);
+    for (int i = 0; i < recorders.GetSize(); i++) notifyRecorder(recorders[i], update, *values, drf);
+    
+    m_mgr->m_notify_mutex.Lock();
+    m_mgr->m_notify_busy = false;
+    m_mgr->m_notify_cond.Broadcast();
+    m_mgr->m_notify_mutex.Unlock();
+  }
+}
@@ -25,3 +25,18 @@
 #include "avida/data/Recorder.h"
 
 Avida::Data::Recorder::~Recorder() { ; }
+
+bool Avida::Data::Recorder::SupportsConcurrentNotification() const
+{
+  return false;
+}
+
+bool Avida::Data::Recorder::SupportsIndexedNotification() const
+{
+  return false;
+}
+
+void Avida::Data::Recorder::NotifyIndexedData(Update, IndexedDataRetrievalFunctor)
+{
+  
+}
@@ -27,168 +27,239 @@
 #include "avida/data/Package.h"
 
 
+namespace {
+  // Downsampling rollups: by default a group is represented by its first point; numeric series can instead keep the
+  // group's min, max or mean
+  template <class T> inline T rollupValues(const Apto::Array<T>& values, int)
+  {
+    return values[0];
+  }
+  
+  template <class T> inline T rollupNumeric(const Apto::Array<T>& values, int mode)
+  {
+    T rtn = values[0];
+    double sum = 0.0;
+    for (int i = 0; i < values.GetSize(); i++) {
+      switch (mode) {
+        case Avida::Data::TimeSeriesRecorder<T>::ROLLUP_MIN: if (values[i] < rtn) rtn = values[i]; break;
+        case Avida::Data::TimeSeriesRecorder<T>::ROLLUP_MAX: if (values[i] > rtn) rtn = values[i]; break;
+        default: sum += values[i]; break;
+      }
+    }
+    if (mode == Avida::Data::TimeSeriesRecorder<T>::ROLLUP_MEAN) rtn = static_cast<T>(sum / values.GetSize());
+    return rtn;
+  }
+  
+  inline int rollupValues(const Apto::Array<int>& values, int mode)
+  {
+    return (mode == Avida::Data::TimeSeriesRecorder<int>::ROLLUP_SAMPLE) ? values[0] : rollupNumeric(values, mode);
+  }
+  
+  inline double rollupValues(const Apto::Array<double>& values, int mode)
+  {
+    return (mode == Avida::Data::TimeSeriesRecorder<double>::ROLLUP_SAMPLE) ? values[0] : rollupNumeric(values, mode);
+  }
+  
+  inline void appendBytes(Apto::Array<unsigned char, Apto::Smart>& buffer, const void* data, int size)
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (int i = 0; i < size; i++) buffer.Push(bytes[i]);
+  }
+  
+  inline void appendString(Apto::Array<unsigned char, Apto::Smart>& buffer, const Apto::String& str)
+  {
+    const int size = str.GetSize();
+    appendBytes(buffer, &size, sizeof(size));
+    appendBytes(buffer, (const char*)str, size);
+  }
+};
+
+
 namespace Avida {
   namespace Data {
     
-    template <>
-    TimeSeriesRecorder<PackagePtr>::TimeSeriesRecorder(const DataID& data_id) : m_data_id(data_id)
+    template <class T> TimeSeriesRecorder<T>::TimeSeriesRecorder(const DataID& data_id)
+      : m_data_id(data_id), m_num_points(0), m_retain_horizon(-1), m_retain_every(1), m_rollup(ROLLUP_SAMPLE)
+      , m_thinned_points(0)
     {
       DataSetPtr ds(new DataSet);
       ds->Insert(m_data_id);
       m_requested = ds;
     }
-
-    template <>
-    TimeSeriesRecorder<bool>::TimeSeriesRecorder(const DataID& data_id) : m_data_id(data_id)
+    
+    template <class T> TimeSeriesRecorder<T>::TimeSeriesRecorder(const DataID& data_id, Apto::String str)
+      : m_data_id(data_id), m_num_points(0), m_retain_horizon(-1), m_retain_every(1), m_rollup(ROLLUP_SAMPLE)
+      , m_thinned_points(0)
     {
       DataSetPtr ds(new DataSet);
       ds->Insert(m_data_id);
       m_requested = ds;
+      
+      while (str.GetSize()) {
+        Apto::String entry_str = str.Pop(',');
+        Update update = Apto::StrAs(entry_str.Pop(':'));
+        pushPoint(update, valueFromString(entry_str));
+      }
     }
     
-    template <>
-    TimeSeriesRecorder<int>::TimeSeriesRecorder(const DataID& data_id) : m_data_id(data_id)
+    
+    template <> PackagePtr TimeSeriesRecorder<PackagePtr>::valueFromString(const Apto::String& str)
     {
-      DataSetPtr ds(new DataSet);
-      ds->Insert(m_data_id);
-      m_requested = ds;
+      return PackagePtr(new Wrap<Apto::String>(str));
     }
-
-    template <>
-    TimeSeriesRecorder<double>::TimeSeriesRecorder(const DataID& data_id) : m_data_id(data_id)
+    
+    template <> bool TimeSeriesRecorder<bool>::valueFromString(const Apto::String& str) { return Apto::StrAs(str); }
+    template <> int TimeSeriesRecorder<int>::valueFromString(const Apto::String& str) { return Apto::StrAs(str); }
+    template <> double TimeSeriesRecorder<double>::valueFromString(const Apto::String& str) { return Apto::StrAs(str); }
+    template <> Apto::String TimeSeriesRecorder<Apto::String>::valueFromString(const Apto::String& str) { return str; }
+    
+    
+    template <class T> void TimeSeriesRecorder<T>::SetRetention(Update horizon, int keep_every, RollupMode rollup)
     {
-      DataSetPtr ds(new DataSet);
-      ds->Insert(m_data_id);
-      m_requested = ds;
+      Apto::MutexAutoLock lock(m_mutex);
+      m_retain_horizon = horizon;
+      m_retain_every = (keep_every > 1) ? keep_every : 1;
+      m_rollup = rollup;
+      applyRetention();
     }
-
-    template <>
-    TimeSeriesRecorder<Apto::String>::TimeSeriesRecorder(const DataID& data_id) : m_data_id(data_id)
+    
+    
+    template <class T> void TimeSeriesRecorder<T>::pushPoint(Update update, const T& value)
     {
-      DataSetPtr ds(new DataSet);
-      ds->Insert(m_data_id);
-      m_requested = ds;
+      if ((m_num_points >> CHUNK_SHIFT) == m_chunks.GetSize()) m_chunks.Push(ChunkPtr(new Chunk));
+      setPoint(m_num_points++, update, value);
+      
+      applyRetention();
     }
     
     
-    template <>
-    TimeSeriesRecorder<PackagePtr>::TimeSeriesRecorder(const DataID& data_id, Apto::String str) : m_data_id(data_id)
+    template <class T> void TimeSeriesRecorder<T>::applyRetention()
     {
-      DataSetPtr ds(new DataSet);
-      ds->Insert(m_data_id);
-      m_requested = ds;
+      if (m_retain_horizon < 0 || m_retain_every < 2 || m_num_points == 0) return;
       
-      while (str.GetSize()) {
-        Apto::String entry_str = str.Pop(',');
-        Update update = Apto::StrAs(entry_str.Pop(':'));
-        PackagePtr package(new Wrap<Apto::String>(entry_str));
-        m_data.Push(DataEntry(update, package));
+      // Only whole groups older than the horizon are rolled up, and only once at least a chunk's worth of points has
+      // built up, so that the shift of the newer points below stays amortized
+      const int old_end = firstPointAtOrAfter(pointTime(m_num_points - 1) - m_retain_horizon);
+      const int num_groups = (old_end - m_thinned_points) / m_retain_every;
+      if (num_groups * m_retain_every < CHUNK_SIZE) return;
+      
+      Apto::Array<T> group(m_retain_every);
+      int src = m_thinned_points;
+      int dest = m_thinned_points;
+      for (int g = 0; g < num_groups; g++, dest++) {
+        const Update group_update = pointTime(src);
+        for (int i = 0; i < m_retain_every; i++, src++) group[i] = pointValue(src);
+        setPoint(dest, group_update, rollupValues(group, m_rollup));
       }
+      m_thinned_points = dest;
+      
+      for (; src < m_num_points; src++, dest++) setPoint(dest, pointTime(src), pointValue(src));
+      m_num_points = dest;
+      m_chunks.Resize((m_num_points + CHUNK_SIZE - 1) >> CHUNK_SHIFT);
     }
     
-    template <>
-    TimeSeriesRecorder<bool>::TimeSeriesRecorder(const DataID& data_id, Apto::String str) : m_data_id(data_id)
+    
+    template <class T> int TimeSeriesRecorder<T>::firstPointAtOrAfter(Update update) const
     {
-      DataSetPtr ds(new DataSet);
-      ds->Insert(m_data_id);
-      m_requested = ds;
-
-      while (str.GetSize()) {
-        Apto::String entry_str = str.Pop(',');
-        Update update = Apto::StrAs(entry_str.Pop(':'));
-        bool value = Apto::StrAs(entry_str);
-        m_data.Push(DataEntry(update, value));
+      // Updates are recorded in nondecreasing order
+      int lo = 0;
+      int hi = m_num_points;
+      while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (pointTime(mid) < update) lo = mid + 1;
+        else hi = mid;
       }
+      return lo;
     }
     
-    template <>
-    TimeSeriesRecorder<int>::TimeSeriesRecorder(const DataID& data_id, Apto::String str) : m_data_id(data_id)
+    template <class T> void TimeSeriesRecorder<T>::CopyPoints(Apto::Array<Update>& updates, Apto::Array<T>& values) const
     {
-      DataSetPtr ds(new DataSet);
-      ds->Insert(m_data_id);
-      m_requested = ds;
-      
-      while (str.GetSize()) {
-        Apto::String entry_str = str.Pop(',');
-        Update update = Apto::StrAs(entry_str.Pop(':'));
-        int value = Apto::StrAs(entry_str);
-        m_data.Push(DataEntry(update, value));
+      Apto::MutexAutoLock lock(m_mutex);
+      updates.Resize(m_num_points);
+      values.Resize(m_num_points);
+      for (int i = 0; i < m_num_points; i++) {
+        updates[i] = pointTime(i);
+        values[i] = pointValue(i);
       }
     }
     
-    template <>
-    TimeSeriesRecorder<double>::TimeSeriesRecorder(const DataID& data_id, Apto::String str) : m_data_id(data_id)
+    template <class T> int TimeSeriesRecorder<T>::FirstPointAtOrAfter(Update update) const
     {
-      DataSetPtr ds(new DataSet);
-      ds->Insert(m_data_id);
-      m_requested = ds;
-      
-      while (str.GetSize()) {
-        Apto::String entry_str = str.Pop(',');
-        Update update = Apto::StrAs(entry_str.Pop(':'));
-        double value = Apto::StrAs(entry_str);
-        m_data.Push(DataEntry(update, value));
-      }
+      Apto::MutexAutoLock lock(m_mutex);
+      return firstPointAtOrAfter(update);
     }
     
-    template <>
-    TimeSeriesRecorder<Apto::String>::TimeSeriesRecorder(const DataID& data_id, Apto::String str) : m_data_id(data_id)
+    template <class T> void TimeSeriesRecorder<T>::PointRange(Update first, Update last, int& begin_idx, int& end_idx) const
     {
-      DataSetPtr ds(new DataSet);
-      ds->Insert(m_data_id);
-      m_requested = ds;
-      
-      while (str.GetSize()) {
-        Apto::String entry_str = str.Pop(',');
-        Update update = Apto::StrAs(entry_str.Pop(':'));
-        m_data.Push(DataEntry(update, entry_str));
-      }
+      Apto::MutexAutoLock lock(m_mutex);
+      begin_idx = firstPointAtOrAfter(first);
+      end_idx = (last < first) ? begin_idx : firstPointAtOrAfter(last + 1);
     }
     
-
     
-    template <>
-    void TimeSeriesRecorder<PackagePtr>::NotifyData(Update update, DataRetrievalFunctor retrieve_data)
+    template <> void TimeSeriesRecorder<PackagePtr>::appendValue(Apto::Array<unsigned char, Apto::Smart>& buffer, const PackagePtr& value)
     {
-      if (shouldRecordValue(update)) {
-        m_data.Push(DataEntry(update, retrieve_data(m_data_id)));
-        didRecordValue();
-      }
+      appendString(buffer, value->StringValue());
     }
     
+    template <> void TimeSeriesRecorder<bool>::appendValue(Apto::Array<unsigned char, Apto::Smart>& buffer, const bool& value)
+    {
+      buffer.Push(value ? 1 : 0);
+    }
     
-    template <>
-    void TimeSeriesRecorder<bool>::NotifyData(Update update, DataRetrievalFunctor retrieve_data)
+    template <> void TimeSeriesRecorder<int>::appendValue(Apto::Array<unsigned char, Apto::Smart>& buffer, const int& value)
     {
-      if (shouldRecordValue(update)) {
-        m_data.Push(DataEntry(update, retrieve_data(m_data_id)->BoolValue()));
-        didRecordValue();
-      }
+      appendBytes(buffer, &value, sizeof(value));
     }
     
-    template <>
-    void TimeSeriesRecorder<int>::NotifyData(Update update, DataRetrievalFunctor retrieve_data)
+    template <> void TimeSeriesRecorder<double>::appendValue(Apto::Array<unsigned char, Apto::Smart>& buffer, const double& value)
     {
-      if (shouldRecordValue(update)) {
-        m_data.Push(DataEntry(update, retrieve_data(m_data_id)->IntValue()));
-        didRecordValue();
+      appendBytes(buffer, &value, sizeof(value));
+    }
+    
+    template <> void TimeSeriesRecorder<Apto::String>::appendValue(Apto::Array<unsigned char, Apto::Smart>& buffer, const Apto::String& value)
+    {
+      appendString(buffer, value);
+    }
+    
+    template <class T> void TimeSeriesRecorder<T>::ExportBinary(Apto::Array<unsigned char, Apto::Smart>& buffer) const
+    {
+      Apto::MutexAutoLock lock(m_mutex);
+      buffer.Resize(0);
+      appendBytes(buffer, &m_num_points, sizeof(m_num_points));
+      for (int c = 0; c * CHUNK_SIZE < m_num_points; c++) {
+        const int count = ((m_num_points - c * CHUNK_SIZE) < CHUNK_SIZE) ? (m_num_points - c * CHUNK_SIZE) : CHUNK_SIZE;
+        appendBytes(buffer, m_chunks[c]->updates, count * static_cast<int>(sizeof(Update)));
       }
+      for (int i = 0; i < m_num_points; i++) appendValue(buffer, pointValue(i));
     }
     
-    template <>
-    void TimeSeriesRecorder<double>::NotifyData(Update update, DataRetrievalFunctor retrieve_data)
+    
+    template <> PackagePtr TimeSeriesRecorder<PackagePtr>::valueFromPackage(PackagePtr value) { return value; }
+    template <> bool TimeSeriesRecorder<bool>::valueFromPackage(PackagePtr value) { return value->BoolValue(); }
+    template <> int TimeSeriesRecorder<int>::valueFromPackage(PackagePtr value) { return value->IntValue(); }
+    template <> double TimeSeriesRecorder<double>::valueFromPackage(PackagePtr value) { return value->DoubleValue(); }
+    template <> Apto::String TimeSeriesRecorder<Apto::String>::valueFromPackage(PackagePtr value) { return value->StringValue(); }
+    
+    template <class T> void TimeSeriesRecorder<T>::NotifyData(Update update, DataRetrievalFunctor retrieve_data)
     {
       if (shouldRecordValue(update)) {
-        m_data.Push(DataEntry(update, retrieve_data(m_data_id)->DoubleValue()));
+        const T value = valueFromPackage(retrieve_data(m_data_id));
+        m_mutex.Lock();
+        pushPoint(update, value);
+        m_mutex.Unlock();
         didRecordValue();
       }
     }
-
-    template <>
-    void TimeSeriesRecorder<Apto::String>::NotifyData(Update update, DataRetrievalFunctor retrieve_data)
+    
+    template <class T> void TimeSeriesRecorder<T>::NotifyIndexedData(Update update, IndexedDataRetrievalFunctor retrieve_data)
     {
+      // The recorded id is the only one requested
       if (shouldRecordValue(update)) {
-        m_data.Push(DataEntry(update, retrieve_data(m_data_id)->StringValue()));
+        const T value = valueFromPackage(retrieve_data(0));
+        m_mutex.Lock();
+        pushPoint(update, value);
+        m_mutex.Unlock();
         didRecordValue();
       }
     }
@@ -197,11 +268,12 @@ namespace Avida {
     template <>
     Apto::String TimeSeriesRecorder<PackagePtr>::AsString() const
     {
-      if (m_data.GetSize() == 0) return "";
+      Apto::MutexAutoLock lock(m_mutex);
+      if (m_num_points == 0) return "";
       
-      Apto::String rtn = Apto::FormatStr("%d:%s", m_data[0].update, (const char*)m_data[0].data->StringValue());
-      for (int i = 1; i < m_data.GetSize(); i++) {
-        rtn += Apto::FormatStr(",%d:%s", m_data[i].update, (const char*)m_data[i].data->StringValue());
+      Apto::String rtn = Apto::FormatStr("%d:%s", pointTime(0), (const char*)pointValue(0)->StringValue());
+      for (int i = 1; i < m_num_points; i++) {
+        rtn += Apto::FormatStr(",%d:%s", pointTime(i), (const char*)pointValue(i)->StringValue());
       }
       return rtn;
     }
@@ -209,11 +281,12 @@ namespace Avida {
     template <>
     Apto::String TimeSeriesRecorder<bool>::AsString() const
     {
-      if (m_data.GetSize() == 0) return "";
+      Apto::MutexAutoLock lock(m_mutex);
+      if (m_num_points == 0) return "";
       
-      Apto::String rtn = Apto::FormatStr("%d:%d", m_data[0].update, m_data[0].data);
-      for (int i = 1; i < m_data.GetSize(); i++) {
-        rtn += Apto::FormatStr(",%d:%d", m_data[i].update, m_data[i].data);
+      Apto::String rtn = Apto::FormatStr("%d:%d", pointTime(0), pointValue(0));
+      for (int i = 1; i < m_num_points; i++) {
+        rtn += Apto::FormatStr(",%d:%d", pointTime(i), pointValue(i));
       }
       return rtn;
     }
@@ -221,11 +294,12 @@ namespace Avida {
     template <>
     Apto::String TimeSeriesRecorder<int>::AsString() const
     {
-      if (m_data.GetSize() == 0) return "";
+      Apto::MutexAutoLock lock(m_mutex);
+      if (m_num_points == 0) return "";
       
-      Apto::String rtn = Apto::FormatStr("%d:%d", m_data[0].update, m_data[0].data);
-      for (int i = 1; i < m_data.GetSize(); i++) {
-        rtn += Apto::FormatStr(",%d:%d", m_data[i].update, m_data[i].data);
+      Apto::String rtn = Apto::FormatStr("%d:%d", pointTime(0), pointValue(0));
+      for (int i = 1; i < m_num_points; i++) {
+        rtn += Apto::FormatStr(",%d:%d", pointTime(i), pointValue(i));
       }
       return rtn;
     }
@@ -233,11 +307,12 @@ namespace Avida {
     template <>
     Apto::String TimeSeriesRecorder<double>::AsString() const
     {
-      if (m_data.GetSize() == 0) return "";
+      Apto::MutexAutoLock lock(m_mutex);
+      if (m_num_points == 0) return "";
       
-      Apto::String rtn = Apto::FormatStr("%d:%f", m_data[0].update, m_data[0].data);
-      for (int i = 1; i < m_data.GetSize(); i++) {
-        rtn += Apto::FormatStr(",%d:%f", m_data[i].update, m_data[i].data);
+      Apto::String rtn = Apto::FormatStr("%d:%f", pointTime(0), pointValue(0));
+      for (int i = 1; i < m_num_points; i++) {
+        rtn += Apto::FormatStr(",%d:%f", pointTime(i), pointValue(i));
       }
       return rtn;
     }
@@ -245,11 +320,12 @@ namespace Avida {
     template <>
     Apto::String TimeSeriesRecorder<Apto::String>::AsString() const
     {
-      if (m_data.GetSize() == 0) return "";
+      Apto::MutexAutoLock lock(m_mutex);
+      if (m_num_points == 0) return "";
       
-      Apto::String rtn = Apto::FormatStr("%d:%s", m_data[0].update, (const char*)m_data[0].data);
-      for (int i = 1; i < m_data.GetSize(); i++) {
-        rtn += Apto::FormatStr(",%d:%s", m_data[i].update, (const char*)m_data[i].data);
+      Apto::String rtn = Apto::FormatStr("%d:%s", pointTime(0), (const char*)pointValue(0));
+      for (int i = 1; i < m_num_points; i++) {
+        rtn += Apto::FormatStr(",%d:%s", pointTime(i), (const char*)pointValue(i));
       }
       return rtn;
     }
@@ -282,6 +282,8 @@ public:
   CONFIG_ADD_VAR(VERBOSITY, int, 1, "0 = No output at all\n1 = Normal output\n2 = Verbose output, detailing progress\n3 = High level of details, as available\n4 = Print Debug Information, as applicable");
   CONFIG_ADD_VAR(RANDOM_SEED, int, -1, "Random number seed (-1 for based on time)");
   CONFIG_ADD_VAR(SPECULATIVE, bool, 1, "Enable speculative execution\n(pre-execute instructions that don't affect other organisms)");
+  CONFIG_ADD_VAR(POOL_ALLOCATION, bool, 1, "Recycle organism and hardware storage through per-world pools\n(disable when debugging with memory checkers)");
+  CONFIG_ADD_VAR(CONCURRENT_DATA_RECORDING, bool, 0, "Notify data recorders that support it on a background thread,\noverlapping data recording with the next update");
   CONFIG_ADD_VAR(POPULATION_CAP, int, 0, "Carrying capacity in number of organisms (use 0 for no cap)");
   CONFIG_ADD_VAR(POP_CAP_ELDEST, int, 0, "Carrying capacity in number of organisms (use 0 for no cap). Will kill oldest organism in population, but still use birth method to place new offspring."); 
   
@@ -294,6 +296,7 @@ public:
   CONFIG_ADD_VAR(SCALE_FREE_M, int, 3, "Number of connections per cell in a scale-free geometry");
   CONFIG_ADD_VAR(SCALE_FREE_ALPHA, double, 1.0, "Attachment power (1=linear)");
   CONFIG_ADD_VAR(SCALE_FREE_ZERO_APPEAL, double, 0.0, "Appeal of cells with zero connections");	
+  CONFIG_ADD_VAR(CELL_ORDERING, int, 0, "Memory layout of the population cells (cell IDs seen outside the population are unaffected)\n0 = Row-major\n1 = Morton (Z-order) curve\n2 = Hilbert curve");
     
   // -------- Configuration File config options --------
   CONFIG_ADD_GROUP(CONFIG_FILE_GROUP, "Other configuration Files");
@@ -541,6 +544,7 @@ public:
   CONFIG_ADD_GROUP(TIME_GROUP, "Time Slicing");
   CONFIG_ADD_VAR(AVE_TIME_SLICE, int, 30, "Average number of CPU-cycles per org per update");
   CONFIG_ADD_VAR(SLICING_METHOD, int, 1, "0 = CONSTANT: all organisms receive equal number of CPU cycles\n1 = PROBABILISTIC: CPU cycles distributed randomly, proportional to merit.\n2 = INTEGRATED: CPU cycles given out deterministicly, proportional to merit\n3 = DEME_PROBABALISTIC: Demes receive fixed number of CPU cycles, awarded probabalistically to members\n4 = CROSS_DEME_PROBABALISTIC: Demes receive CPU cycles proportional to living population size, awarded probabalistically to members");
+  CONFIG_ADD_VAR(BURST_SIZE, int, 1, "Consecutive CPU cycles executed each time an organism is scheduled\n1 = Interleave organisms one instruction at a time\n>1 = Burst execution; scheduling remains proportional to merit, but other organisms\n     see births, deaths and resource use only at burst boundaries, where resource\n     time and implicit deme replication are also settled");
   CONFIG_ADD_VAR(BASE_MERIT_METHOD, int, 4, "How should merit be initialized?\n0 = Constant (merit independent of size)\n1 = Merit proportional to copied size\n2 = Merit prop. to executed size\n3 = Merit prop. to full size\n4 = Merit prop. to min of executed or copied size\n5 = Merit prop. to sqrt of the minimum size\n6 = Merit prop. to num times MERIT_BONUS_INST is in genome.");
   CONFIG_ADD_VAR(BASE_CONST_MERIT, int, 100, "Base merit valse for BASE_MERIT_METHOD 0");
   CONFIG_ADD_VAR(MERIT_BONUS_INST, int, 0, "Instruction ID to count for BASE_MERIT_METHOD 6"); 
@@ -561,6 +565,9 @@ public:
   CONFIG_ADD_VAR(MAX_LABEL_EXE_SIZE, int, 1, "Max nops marked as executed when labels are used");
   CONFIG_ADD_VAR(PRECALC_PHENOTYPE, int, 0, "0 = Disabled\n 1 = Assign precalculated merit at birth (unlimited resources only)\n 2 = Assign precalculated gestation time\n 3 = Assign precalculated merit AND gestation time.\n 4 = Assign last instruction counts \n 5 = Assign last instruction counts and merit\n 6 = Assign last instruction counts and gestation time \n 7 = Assign everything currently supported\nFitness will be evaluated for organism based on these settings.");
   CONFIG_ADD_VAR(GENOTYPE_PHENPLAST_CALC, int, 100, "Number of times to test a genotype's\nplasticity during runtime.");
+  CONFIG_ADD_VAR(PHENPLAST_CONCURRENCY, int, 1, "Number of threads used to run a genotype's plasticity trials,\n-1 == use all available.  Each trial is seeded on its own, so\nresults do not depend on the number of threads (they do differ\nfrom versions that ran every trial on one random stream).\nTrials started from a parallel analyze job run on its thread.");
+  CONFIG_ADD_VAR(PHENPLAST_TOLERANCE, double, 0.0, "Stop plasticity trials early once every phenotype frequency\nis estimated to within this margin (0 = always run every trial).");
+  CONFIG_ADD_VAR(PHENPLAST_CONFIDENCE, double, 0.95, "Confidence level required of PHENPLAST_TOLERANCE.");
   
 
   // -------- Altruism config options --------
@@ -590,6 +597,7 @@ public:
   CONFIG_ADD_GROUP(GENEOLOGY_GROUP, "Geneology");
   CONFIG_ADD_VAR(THRESHOLD, int, 3, "Number of organisms in a genotype needed for it\n  to be considered viable.");
   CONFIG_ADD_VAR(TEST_CPU_TIME_MOD, int, 20, "Time allocated in test CPUs (multiple of length)");
+  CONFIG_ADD_VAR(THRESHOLD_TEST_THREADS, int, 0, "Number of threads that evaluate new threshold genotypes on\n  test CPUs in the background (0 = evaluate on demand)");
   
 
   // -------- Organism Network config options --------
@@ -636,6 +644,7 @@ public:
   // -------- Analyze config options --------
   CONFIG_ADD_GROUP(ANALYZE_GROUP, "Analysis Settings");
   CONFIG_ADD_VAR(MAX_CONCURRENCY, int, -1, "Maximum number of analyze threads, -1 == use all available.");
+  CONFIG_ADD_VAR(ANALYZE_SHARE_RECALC, int, 0, "Run each distinct genome in a batch through a test CPU only once when\nrecalculating, copying its results to identical genotypes.  Only enable\nif the hardware and instruction set draw no random numbers.\n0 = test every genotype\n1 = share results between identical genomes");
   CONFIG_ADD_VAR(INJECT_RESETS_TASKS, int, 0, "Executing INJECT (semi-succesfully) will trigger last_task_count to be writen from current_task_count");
   CONFIG_ADD_VAR(ANALYZE_OPTION_1, cString, "", "String variable accessible from analysis scripts");
   CONFIG_ADD_VAR(ANALYZE_OPTION_2, cString, "", "String variable accessible from analysis scripts");
@@ -0,0 +1,109 @@
+/*
+ *  cCellArray.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cCellArray.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+
+static unsigned long long mortonKey(unsigned int x, unsigned int y)
+{
+  // Interleave the bits of x (even positions) and y (odd positions)
+  unsigned long long key = 0;
+  for (int bit = 0; bit < 32; bit++) {
+    key |= (unsigned long long)((x >> bit) & 1) << (2 * bit);
+    key |= (unsigned long long)((y >> bit) & 1) << (2 * bit + 1);
+  }
+  return key;
+}
+
+static unsigned long long hilbertKey(unsigned int side, unsigned int x, unsigned int y)
+{
+  // Distance along the Hilbert curve filling a side x side square (side a power of two)
+  unsigned long long d = 0;
+  for (unsigned int s = side / 2; s > 0; s /= 2) {
+    const unsigned int rx = (x & s) ? 1 : 0;
+    const unsigned int ry = (y & s) ? 1 : 0;
+    d += (unsigned long long)s * s * ((3 * rx) ^ ry);
+
+    // Rotate the quadrant so that the sub-curve is traversed in the right orientation
+    if (ry == 0) {
+      if (rx == 1) {
+        x = side - 1 - x;
+        y = side - 1 - y;
+      }
+      const unsigned int t = x;
+      x = y;
+      y = t;
+    }
+  }
+  return d;
+}
+
+
+Apto::Array<int> cCellArray::CurveOrder(int world_x, int world_y, Ordering ordering)
+{
+  const int num_cells = world_x * world_y;
+  Apto::Array<int> order(num_cells);
+
+  if (ordering == ROW_MAJOR) {
+    for (int i = 0; i < num_cells; i++) order[i] = i;
+    return order;
+  }
+
+  unsigned int side = 1;
+  while (side < (unsigned int)world_x || side < (unsigned int)world_y) side *= 2;
+
+  // Sort cell ids by curve position; cells of a non-square or non power of two world simply skip the unused keys
+  std::vector<std::pair<unsigned long long, int> > keyed(num_cells);
+  for (int i = 0; i < num_cells; i++) {
+    const unsigned int x = i % world_x;
+    const unsigned int y = i / world_x;
+    keyed[i].first = (ordering == MORTON) ? mortonKey(x, y) : hilbertKey(side, x, y);
+    keyed[i].second = i;
+  }
+  std::sort(keyed.begin(), keyed.end());
+
+  for (int i = 0; i < num_cells; i++) order[i] = keyed[i].second;
+  return order;
+}
+
+
+void cCellArray::ResizeClear(int world_x, int world_y, Ordering ordering)
+{
+  const int num_cells = world_x * world_y;
+
+  m_ordering = ordering;
+  m_reordered = (ordering != ROW_MAJOR);
+  m_cells.ResizeClear(num_cells);
+
+  if (!m_reordered) {
+    m_slot.ResizeClear(0);
+    return;
+  }
+
+  Apto::Array<int> order = CurveOrder(world_x, world_y, ordering);
+  m_slot.ResizeClear(num_cells);
+  for (int slot = 0; slot < num_cells; slot++) m_slot[order[slot]] = slot;
+}
@@ -0,0 +1,81 @@
+/*
+ *  cCellArray.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cCellArray_h
+#define cCellArray_h
+
+#include "cPopulationCell.h"
+
+
+// cCellArray - population cell storage, indexed by row-major cell id
+//
+// Cells may optionally be laid out in memory along a space-filling curve (Morton or Hilbert), so that grid
+// neighbors sit close together in memory.  Lookups always take the row-major cell id used everywhere outside
+// this class; the id to storage slot mapping is applied here and nowhere else.
+
+class cCellArray
+{
+public:
+  enum Ordering { ROW_MAJOR = 0, MORTON = 1, HILBERT = 2 };
+
+  // A contiguous range of cell ids, as consumed by the topology builders
+  class Slice
+  {
+  private:
+    cCellArray* m_array;
+    int m_first;
+    int m_size;
+
+  public:
+    inline Slice(cCellArray* array, int first, int size) : m_array(array), m_first(first), m_size(size) { ; }
+
+    inline int GetSize() const { return m_size; }
+    inline cPopulationCell& operator[](int idx) const { return (*m_array)[m_first + idx]; }
+    inline Slice Range(int first, int last) const { return Slice(m_array, m_first + first, last - first + 1); }
+  };
+
+private:
+  Apto::Array<cPopulationCell> m_cells;   // Storage, in curve order when reordered
+  Apto::Array<int> m_slot;                // Cell id -> storage slot (unused when row-major)
+  Ordering m_ordering;
+  bool m_reordered;
+
+  cCellArray(const cCellArray&); // @not_implemented
+  cCellArray& operator=(const cCellArray&); // @not_implemented
+
+public:
+  cCellArray() : m_ordering(ROW_MAJOR), m_reordered(false) { ; }
+
+  void ResizeClear(int world_x, int world_y, Ordering ordering = ROW_MAJOR);
+
+  inline int GetSize() const { return m_cells.GetSize(); }
+  inline Ordering GetOrdering() const { return m_ordering; }
+
+  inline cPopulationCell& operator[](int cell_id) { return m_cells[m_reordered ? m_slot[cell_id] : cell_id]; }
+  inline const cPopulationCell& operator[](int cell_id) const { return m_cells[m_reordered ? m_slot[cell_id] : cell_id]; }
+
+  inline Slice Range(int first, int last) { return Slice(this, first, last - first + 1); }
+
+  // Cell ids of a world_x by world_y grid, listed in the order they are stored under the given ordering
+  static Apto::Array<int> CurveOrder(int world_x, int world_y, Ordering ordering);
+};
+
+#endif
@@ -119,6 +119,8 @@ cGradientCount::cGradientCount(cWorld* world, int peakx, int peaky, int height,
   , m_min_usedy(-1)
   , m_max_usedx(-1)
   , m_max_usedy(-1)
+  , m_tmpl_height(-1)
+  , m_tmpl_spread(-1)
 {
   ResetGradRes(m_world->GetDefaultContext(), worldx, worldy);
 }
@@ -272,9 +274,9 @@ void cGradientCount::fillinResourceValues()
   int min_pos_x;
   int max_pos_y;
   int min_pos_y;
-  resetUsedBounds();
 
-  // if we are resetting a resource, we need to calculate new values for the whole world so we can wipe away any residue
+  // if we are resetting a resource, we need to wipe away any residue left by the previous peak, which is all held
+  // within the bounds we last wrote to (plus the new cone, wherever that landed)
   if (m_just_reset) {
     if (m_min_usedx == -1 || m_min_usedy == -1 || m_max_usedx == -1 || m_max_usedy == -1) {
       max_pos_x = GetX() - 1;
@@ -283,10 +285,10 @@ void cGradientCount::fillinResourceValues()
       min_pos_y = 0;
     }
     else {
-      max_pos_x = m_max_usedx;
-      min_pos_x = m_min_usedx;
-      max_pos_y = m_max_usedy;
-      min_pos_y = m_min_usedy;
+      max_pos_x = max(m_max_usedx, min(m_peakx + m_spread, GetX() - 1));
+      min_pos_x = min(m_min_usedx, max(m_peakx - m_spread, 0));
+      max_pos_y = max(m_max_usedy, min(m_peaky + m_spread, GetY() - 1));
+      min_pos_y = min(m_min_usedy, max(m_peaky - m_spread, 0));
     }
   } else {
     // otherwise we only need to update values within the possible range of the peak 
@@ -296,6 +298,7 @@ void cGradientCount::fillinResourceValues()
     max_pos_y = min(m_peaky + m_spread + m_move_speed + 1, GetY() - 1);
     min_pos_y = max(m_peaky - m_spread - m_move_speed - 1, 0);
   }
+  resetUsedBounds();
 
   if (m_is_plateau_common == 1 && !m_just_reset && m_world->GetStats().GetUpdate() > 0) {
     // with common depletion, new peak height is not the plateau heights, but the delta in plateau heights applied to 
@@ -311,62 +314,35 @@ void cGradientCount::fillinResourceValues()
     m_current_height = m_height;
   }
 
-  int plateau_cell = 0;
-  for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
-    for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
-      double thisheight = 0.0;
-      double thisdist = sqrt((double) (m_peakx - ii) * (m_peakx - ii) + (m_peaky - jj) * (m_peaky - jj));
-      if (m_spread >= thisdist) {
-        // determine theoretical individual cells values and add one to distance from center 
-        // (so that center point = radius 1, not 0)
-        // also used to distinguish plateau cells
-        
-        thisheight = m_current_height / (thisdist + 1);
-        
-        // set the floor values
-        // plateaus will override this so that plateaus can hit 0 when being eaten
-        if (thisheight < m_floor) thisheight = m_floor;
-        
-        // create cylindrical profiles of resources whereever thisheight would be >1 (area where thisdist + 1 <= m_height)
-        // and slopes outside of that range
-        // plateau = -1 turns off this option; if activated, causes 'peaks' to be flat plateaus = plateau value 
-        bool is_plat_cell = ((m_height / (thisdist + 1)) >= 1);
-        // apply plateau inflow(s) and outflow 
-        if ((is_plat_cell && m_plateau >= 0) || (m_plateau < 0 && thisdist == 0 && m_plateau_array.GetSize())) { 
-          if (m_just_reset || m_world->GetStats().GetUpdate() <= 0) {
-            m_past_height = m_height;
-            if (m_plateau >= 0.0) {
-              thisheight = m_plateau;
-            } 
-            else {
-              thisheight = m_height;
-            }
-          } 
-          else { 
-            if (m_is_plateau_common == 0) {
-              m_past_height = m_plateau_array[plateau_cell]; 
-              thisheight = m_past_height + m_plateau_inflow - (m_past_height * m_plateau_outflow);
-              thisheight += m_gradient_inflow / (thisdist + 1);
-              if (thisheight > m_plateau && m_plateau >= 0) {
-                thisheight = m_plateau;
-              } 
-              if (m_plateau < 0 && thisdist == 0 && thisheight > m_height) {
-                thisheight = m_height;
-              }
-            }
-            else if (m_is_plateau_common == 1) {   
-              thisheight = m_common_plat_height;
-            }
+  buildConeTemplate();
+  const int span = 2 * m_tmpl_spread + 1;
+  
+  // off-plateau cone inflow/outflow reads the old cone values in place as it goes, so those updates must keep the
+  // original column-by-column order; everything else is laid down row by row from the template
+  const bool in_place_cone = (m_cone_inflow > 0 || m_cone_outflow > 0 || m_gradient_inflow > 0)
+                             && !m_just_reset && m_world->GetStats().GetUpdate() > 0;
+
+  if (in_place_cone) {
+    int plateau_cell = 0;
+    for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
+      for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
+        double thisheight = 0.0;
+        const int dx = ii - m_peakx;
+        const int dy = jj - m_peaky;
+        if (abs(dx) <= m_tmpl_spread && abs(dy) <= m_tmpl_spread && abs(dx) <= m_tmpl_half_width[dy + m_tmpl_spread]) {
+          const int tmpl_idx = (dy + m_tmpl_spread) * span + dx + m_tmpl_spread;
+          const double thisdist = m_tmpl_dist[tmpl_idx];
+
+          // determine theoretical individual cells values and add one to distance from center 
+          // (so that center point = radius 1, not 0)
+          thisheight = m_current_height / (thisdist + 1);
+          if (thisheight < m_floor) thisheight = m_floor;
+
+          if (isPlateauCell(tmpl_idx)) {
+            thisheight = fillinPlateauCell(plateau_cell, ii, jj, thisdist, thisheight);
+            plateau_cell++;
           }
-          if (m_initial && m_initial_plat != -1) thisheight = m_initial_plat;
-          if (thisheight < 0) thisheight = 0;
-          m_plateau_array[plateau_cell] = thisheight;
-          m_plateau_cell_IDs[plateau_cell] = jj * GetX() + ii;
-          plateau_cell ++;
-         }
-        // now apply any off-plateau inflow(s) and outflow
-        else if (!is_plat_cell && (m_cone_inflow > 0 || m_cone_outflow > 0 || m_gradient_inflow > 0)) {
-          if (!m_just_reset && m_world->GetStats().GetUpdate() > 0) {
+          else if (!m_tmpl_plateau[tmpl_idx]) {
             int offsetx = m_old_peakx - m_peakx;
             int offsety = m_old_peaky - m_peaky;
             
@@ -388,16 +364,131 @@ void cGradientCount::fillinResourceValues()
             }
           }
         }
+        Element(jj * GetX() + ii).SetAmount(thisheight);
+        if (thisheight > 0) updateBounds(ii, jj);
       }
-      Element(jj * GetX() + ii).SetAmount(thisheight);
-      if (thisheight > 0) updateBounds(ii, jj);
     }
-  }         
+  }
+  else {
+    // cone body: zero the parts of each row outside the footprint, fill the footprint from the template
+    m_row_buffer.Resize(span);
+    for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
+      const int dy = jj - m_peaky;
+      const int row = jj * GetX();
+      int lo = max_pos_x + 1;
+      int hi = max_pos_x;
+      if (abs(dy) <= m_tmpl_spread && m_tmpl_half_width[dy + m_tmpl_spread] >= 0) {
+        const int half_width = m_tmpl_half_width[dy + m_tmpl_spread];
+        lo = max(m_peakx - half_width, min_pos_x);
+        hi = min(m_peakx + half_width, max_pos_x);
+      }
+      for (int ii = min_pos_x; ii < lo && ii < max_pos_x + 1; ii++) Element(row + ii).SetAmount(0.0);
+      if (lo <= hi) {
+        const int tmpl_row = (dy + m_tmpl_spread) * span + m_tmpl_spread - m_peakx;
+        const int count = hi - lo + 1;
+        for (int k = 0; k < count; k++) m_row_buffer[k] = m_current_height / (m_tmpl_dist[tmpl_row + lo + k] + 1);
+        for (int k = 0; k < count; k++) if (m_row_buffer[k] < m_floor) m_row_buffer[k] = m_floor;
+        for (int k = 0; k < count; k++) {
+          // plateau cells are filled in below, in the order the plateau arrays are kept in
+          if (isPlateauCell(tmpl_row + lo + k)) continue;
+          Element(row + lo + k).SetAmount(m_row_buffer[k]);
+          if (m_row_buffer[k] > 0) updateBounds(lo + k, jj);
+        }
+      }
+      for (int ii = max(hi + 1, min_pos_x); ii < max_pos_x + 1; ii++) Element(row + ii).SetAmount(0.0);
+    }
+
+    // plateau: apply plateau inflow(s) and outflow, column by column
+    {
+      int plateau_cell = 0;
+      const int plat_min_x = max(m_peakx - m_tmpl_spread, min_pos_x);
+      const int plat_max_x = min(m_peakx + m_tmpl_spread, max_pos_x);
+      const int plat_min_y = max(m_peaky - m_tmpl_spread, min_pos_y);
+      const int plat_max_y = min(m_peaky + m_tmpl_spread, max_pos_y);
+      for (int ii = plat_min_x; ii < plat_max_x + 1; ii++) {
+        for (int jj = plat_min_y; jj < plat_max_y + 1; jj++) {
+          const int dx = ii - m_peakx;
+          const int dy = jj - m_peaky;
+          if (abs(dx) > m_tmpl_half_width[dy + m_tmpl_spread]) continue;
+          const int tmpl_idx = (dy + m_tmpl_spread) * span + dx + m_tmpl_spread;
+          if (!isPlateauCell(tmpl_idx)) continue;
+          const double thisdist = m_tmpl_dist[tmpl_idx];
+          double thisheight = m_current_height / (thisdist + 1);
+          if (thisheight < m_floor) thisheight = m_floor;
+          thisheight = fillinPlateauCell(plateau_cell, ii, jj, thisdist, thisheight);
+          plateau_cell++;
+          Element(jj * GetX() + ii).SetAmount(thisheight);
+          if (thisheight > 0) updateBounds(ii, jj);
+        }
+      }
+    }
+  }
   SetCurrPeakX(m_peakx);
   SetCurrPeakY(m_peaky);
   m_just_reset = false;
 }
 
+double cGradientCount::fillinPlateauCell(int plateau_cell, int ii, int jj, double thisdist, double thisheight)
+{
+  if (m_just_reset || m_world->GetStats().GetUpdate() <= 0) {
+    m_past_height = m_height;
+    if (m_plateau >= 0.0) {
+      thisheight = m_plateau;
+    } 
+    else {
+      thisheight = m_height;
+    }
+  } 
+  else { 
+    if (m_is_plateau_common == 0) {
+      m_past_height = m_plateau_array[plateau_cell]; 
+      thisheight = m_past_height + m_plateau_inflow - (m_past_height * m_plateau_outflow);
+      thisheight += m_gradient_inflow / (thisdist + 1);
+      if (thisheight > m_plateau && m_plateau >= 0) {
+        thisheight = m_plateau;
+      } 
+      if (m_plateau < 0 && thisdist == 0 && thisheight > m_height) {
+        thisheight = m_height;
+      }
+    }
+    else if (m_is_plateau_common == 1) {   
+      thisheight = m_common_plat_height;
+    }
+  }
+  if (m_initial && m_initial_plat != -1) thisheight = m_initial_plat;
+  if (thisheight < 0) thisheight = 0;
+  m_plateau_array[plateau_cell] = thisheight;
+  m_plateau_cell_IDs[plateau_cell] = jj * GetX() + ii;
+  return thisheight;
+}
+
+void cGradientCount::buildConeTemplate()
+{
+  // create cylindrical profiles of resources whereever the cone would be >1 (area where dist + 1 <= m_height)
+  // and slopes outside of that range
+  if (m_tmpl_height == m_height && m_tmpl_spread == max(m_spread, 0)) return;
+  
+  m_tmpl_height = m_height;
+  m_tmpl_spread = max(m_spread, 0);
+  
+  const int span = 2 * m_tmpl_spread + 1;
+  m_tmpl_dist.ResizeClear(span * span);
+  m_tmpl_plateau.ResizeClear(span * span);
+  m_tmpl_half_width.ResizeClear(span);
+  for (int dy = -m_tmpl_spread; dy <= m_tmpl_spread; dy++) {
+    int half_width = -1;
+    for (int dx = -m_tmpl_spread; dx <= m_tmpl_spread; dx++) {
+      const int idx = (dy + m_tmpl_spread) * span + dx + m_tmpl_spread;
+      const double thisdist = sqrt((double) dx * dx + dy * dy);
+      const bool is_plat_cell = ((m_height / (thisdist + 1)) >= 1);
+      m_tmpl_dist[idx] = thisdist;
+      m_tmpl_plateau[idx] = is_plat_cell;
+      if (m_spread >= thisdist && abs(dx) > half_width) half_width = abs(dx);
+    }
+    m_tmpl_half_width[dy + m_tmpl_spread] = half_width;
+  }
+}
+
 void cGradientCount::getCurrentPlatValues()
 { 
   int temp_height = 0;
@@ -825,10 +916,9 @@ void cGradientCount::generateHills(cAvidaContext& ctx)
 { 
   // generate/regenerate hills when counter == config updatestep
   if (m_topo_counter == m_updatestep) { 
-    resetUsedBounds();
     // reset counter
     m_topo_counter = 1;
-    // since we are potentially plotting more than one hill per resource, we need to wipe the world before we start
+    // since we are potentially plotting more than one hill per resource, we need to wipe the old hills before we start
     if (m_min_usedx == -1 || m_min_usedy == -1 || m_max_usedx == -1 || m_max_usedy == -1) {
       for (int ii = 0; ii < GetX(); ii++) {
         for (int jj = 0; jj < GetY(); jj++) {
@@ -843,6 +933,7 @@ void cGradientCount::generateHills(cAvidaContext& ctx)
         }
       }
     }
+    resetUsedBounds();
 
     Apto::Random& rng = ctx.GetRandom();
     // generate number hills equal to count
@@ -116,6 +116,14 @@ private:
   int m_min_usedy;
   int m_max_usedx;
   int m_max_usedy;
+
+  // cone footprint template, rebuilt whenever height or spread change
+  int m_tmpl_height;
+  int m_tmpl_spread;
+  Apto::Array<double> m_tmpl_dist;     // distance from the peak, (2 * spread + 1)^2 offsets, row-major
+  Apto::Array<bool> m_tmpl_plateau;    // offsets within the plateau radius (dist + 1 <= height)
+  Apto::Array<int> m_tmpl_half_width;  // per row offset, largest |dx| still within spread (-1 if none)
+  Apto::Array<double> m_row_buffer;
     
 public:
   cGradientCount(cWorld* world, int peakx, int peaky, int height, int spread, double plateau, int decay,              
@@ -201,8 +209,19 @@ private:
   void updateBounds(int x, int y);
   void resetUsedBounds();
   void clearExistingProbRes();
+  void buildConeTemplate();
+  double fillinPlateauCell(int plateau_cell, int ii, int jj, double thisdist, double thisheight);
   
   inline void setHaloDirection(cAvidaContext& ctx);
+  inline bool isPlateauCell(int tmpl_idx) const;
 };
 
+
+inline bool cGradientCount::isPlateauCell(int tmpl_idx) const
+{
+  // plateau = -1 turns off plateaus, leaving only the center cell to take plateau inflow
+  if (m_plateau >= 0) return m_tmpl_plateau[tmpl_idx];
+  return (m_tmpl_dist[tmpl_idx] == 0 && m_plateau_array.GetSize());
+}
+
 #endif
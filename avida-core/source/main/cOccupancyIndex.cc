@@ -0,0 +1,92 @@
+/*
+ *  cOccupancyIndex.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cOccupancyIndex.h"
+
+#include <cassert>
+
+
+void cOccupancyIndex::Resize(int world_x, int world_y)
+{
+  m_world_x = world_x;
+  m_world_y = world_y;
+  m_cell_count.ResizeClear(world_x * world_y);
+  m_row_tree.ResizeClear(world_x * world_y);
+  m_col_tree.ResizeClear(world_x * world_y);
+  Clear();
+}
+
+void cOccupancyIndex::Clear()
+{
+  m_total = 0;
+  m_cell_count.SetAll(0);
+  m_row_tree.SetAll(0);
+  m_col_tree.SetAll(0);
+}
+
+void cOccupancyIndex::Adjust(int cell_id, int change)
+{
+  assert(cell_id >= 0 && cell_id < m_cell_count.GetSize());
+  if (change == 0) return;
+
+  m_cell_count[cell_id] += change;
+  m_total += change;
+  assert(m_cell_count[cell_id] >= 0);
+
+  const int x = cell_id % m_world_x;
+  const int y = cell_id / m_world_x;
+
+  const int row_offset = y * m_world_x;
+  for (int i = x + 1; i <= m_world_x; i += (i & -i)) m_row_tree[row_offset + i - 1] += change;
+
+  const int col_offset = x * m_world_y;
+  for (int i = y + 1; i <= m_world_y; i += (i & -i)) m_col_tree[col_offset + i - 1] += change;
+}
+
+int cOccupancyIndex::CountRow(int y, int x_lo, int x_hi) const
+{
+  if (y < 0 || y >= m_world_y) return 0;
+  if (x_lo < 0) x_lo = 0;
+  if (x_hi >= m_world_x) x_hi = m_world_x - 1;
+  if (x_lo > x_hi) return 0;
+
+  const int offset = y * m_world_x;
+  if (x_lo == x_hi) return m_cell_count[offset + x_lo];
+
+  int count = treePrefix(m_row_tree, offset, x_hi);
+  if (x_lo > 0) count -= treePrefix(m_row_tree, offset, x_lo - 1);
+  return count;
+}
+
+int cOccupancyIndex::CountCol(int x, int y_lo, int y_hi) const
+{
+  if (x < 0 || x >= m_world_x) return 0;
+  if (y_lo < 0) y_lo = 0;
+  if (y_hi >= m_world_y) y_hi = m_world_y - 1;
+  if (y_lo > y_hi) return 0;
+
+  if (y_lo == y_hi) return m_cell_count[y_lo * m_world_x + x];
+
+  const int offset = x * m_world_y;
+  int count = treePrefix(m_col_tree, offset, y_hi);
+  if (y_lo > 0) count -= treePrefix(m_col_tree, offset, y_lo - 1);
+  return count;
+}
@@ -0,0 +1,74 @@
+/*
+ *  cOccupancyIndex.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cOccupancyIndex_h
+#define cOccupancyIndex_h
+
+#include "avida/core/Types.h"
+
+
+// cOccupancyIndex - per-cell counts over the world grid with O(log n) row and column segment queries
+//
+// Every row and every column carries its own Fenwick (binary indexed) tree, so the number of counted things
+// in any horizontal or vertical run of cells is available without visiting the cells.  The look instructions
+// use this to skip the parts of a sensing wedge that cannot contain what they are searching for.
+
+class cOccupancyIndex
+{
+private:
+  int m_world_x;
+  int m_world_y;
+  int m_total;
+  Apto::Array<int> m_cell_count;
+  Apto::Array<int> m_row_tree;   // world_y trees of world_x entries, indexed by (y * world_x + x)
+  Apto::Array<int> m_col_tree;   // world_x trees of world_y entries, indexed by (x * world_y + y)
+
+  cOccupancyIndex(const cOccupancyIndex&); // @not_implemented
+  cOccupancyIndex& operator=(const cOccupancyIndex&); // @not_implemented
+
+  inline int treePrefix(const Apto::Array<int>& tree, int offset, int idx) const;
+
+public:
+  cOccupancyIndex() : m_world_x(0), m_world_y(0), m_total(0) { ; }
+
+  void Resize(int world_x, int world_y);
+  void Clear();
+
+  void Adjust(int cell_id, int change);
+
+  inline int GetCount(int cell_id) const { return m_cell_count[cell_id]; }
+  inline int GetTotal() const { return m_total; }
+
+  // Inclusive ranges, clipped to the world edges
+  int CountRow(int y, int x_lo, int x_hi) const;
+  int CountCol(int x, int y_lo, int y_hi) const;
+};
+
+
+inline int cOccupancyIndex::treePrefix(const Apto::Array<int>& tree, int offset, int idx) const
+{
+  // Sum of entries [0, idx] of the tree starting at offset
+  int sum = 0;
+  for (int i = idx + 1; i > 0; i -= (i & -i)) sum += tree[offset + i - 1];
+  return sum;
+}
+
+#endif
@@ -24,6 +24,8 @@
 #include "cOrgSensor.h"
 
 #include "cEnvironment.h"
+#include "cOccupancyIndex.h"
+#include "cPopulation.h"
 #include "cPopulationCell.h"
 #include "cResource.h"
 #include "cResourceCount.h"
@@ -466,6 +468,8 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
   bool foundFirstVisible = false;
   
   bool stop_at_first_found = (search_type == 0) || (habitat_used == -2 && (search_type == -1 || search_type == 1));
+  // organism searches only need to test cells the occupancy indices say could hold a match
+  const bool use_occupancy = (habitat_used == -2);
   
   // START WALKING
   bool first_step = true;
@@ -485,6 +489,17 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
       if (!do_left && direction == left) continue;
       if (!do_right && direction == right) break;
       
+      bool side_empty = false;
+      if (use_occupancy && num_cells_either_side > 0) {
+        side_empty = (CountOccupancy(center_cell, direction, num_cells_either_side, search_type) == 0);
+        // an empty side lying wholly inside the world has nothing to walk, but still counts as valid cells
+        if (side_empty && TestBounds(center_cell + direction, worldBounds) &&
+            TestBounds(center_cell + direction * num_cells_either_side, worldBounds)) {
+          any_valid_side_cells = true;
+          continue;
+        }
+      }
+      
       // walk in from the farthest cell on side towards the center
       for (int j = num_cells_either_side; j > 0; j--) {
         bool valid_cell = true;
@@ -517,7 +532,7 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
         else any_valid_side_cells = true;
         
         // Now we can look at the current side cell because we know it's in the world.
-        if (valid_cell) {
+        if (valid_cell && !side_empty) {
           cellResultInfo = TestCell(ctx, in_defs, this_cell, val_res, first_step, stop_at_first_found);
           first_step = false;
           
@@ -548,7 +563,7 @@ void cOrgSensor::WalkCells(cAvidaContext& ctx, sLookInit& in_defs, const int fac
     if (stop_at_first_found && found_edible) break;                             // end side and center searches (found on side)
     
     // work on CENTER cell for this dist
-    if (count_center) {
+    if (count_center && (!use_occupancy || CountOccupancy(center_cell, search_type) > 0)) {
       cellResultInfo = TestCell(ctx, in_defs, center_cell, val_res, first_step, stop_at_first_found);
       
       if (!foundFirstVisible && cellResultInfo.has_some) {
@@ -676,6 +691,8 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
   bool foundFirstVisible = false;
   
   bool stop_at_first_found = (search_type == 0) || (habitat_used == -2 && (search_type == -1 || search_type == 1));
+  // organism searches only need to test cells the occupancy indices say could hold a match
+  const bool use_occupancy = (habitat_used == -2);
   
   // START WALKING
   bool first_step = true;
@@ -691,6 +708,13 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
     for (int do_lr = 0; do_lr <= 1; do_lr++) {
       if (do_lr == 1) direction = right;
       
+      // on the torus every side cell is in bounds, so an empty side only needs to be marked valid
+      if (use_occupancy && num_cells_either_side > 0 &&
+          CountOccupancy(center_cell, direction, num_cells_either_side, search_type) == 0) {
+        any_valid_side_cells = true;
+        continue;
+      }
+      
       // walk in from the farthest cell on side towards the center
       for (int j = num_cells_either_side; j > 0; j--) {
         bool valid_cell = true;
@@ -739,7 +763,7 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
     if (stop_at_first_found && found_edible) break;                             // end side and center searches (found on side)
     
     // work on CENTER cell for this dist
-    if (count_center) {
+    if (count_center && (!use_occupancy || CountOccupancy(center_cell, search_type) > 0)) {
       cellResultInfo = TestCell(ctx, in_defs, center_cell, val_res, first_step, stop_at_first_found);
       
       if (!foundFirstVisible && cellResultInfo.has_some) {
@@ -842,6 +866,63 @@ void cOrgSensor::WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int fac
   return;
 }
 
+int cOrgSensor::CountOccupancy(const Apto::Coord<int>& cell, const int search_type)
+{
+  // Upper bound on the organisms in a cell that could match search_type; dead organisms and, without avatars,
+  // forage targets are not tracked by the indices, so TestCell still has the final say on nonzero counts
+  cPopulation& pop = m_world->GetPopulation();
+  const int cell_id = cell.Y() * m_world->GetConfig().WORLD_X.Get() + cell.X();
+  if (!m_use_avatar) return pop.GetOrgOccupancy().GetCount(cell_id);
+  
+  int count = 0;
+  if (search_type >= 0) count += pop.GetPredAVOccupancy().GetCount(cell_id);
+  if (search_type <= 0) count += pop.GetPreyAVOccupancy().GetCount(cell_id);
+  return count;
+}
+
+int cOrgSensor::CountOccupancy(const Apto::Coord<int>& start, const Apto::Coord<int>& direction, const int num_cells, const int search_type)
+{
+  // Same as above, summed over the num_cells cells stepping out from (but not including) start
+  cPopulation& pop = m_world->GetPopulation();
+  if (!m_use_avatar) return CountOccupancyRun(pop.GetOrgOccupancy(), start, direction, num_cells);
+  
+  int count = 0;
+  if (search_type >= 0) count += CountOccupancyRun(pop.GetPredAVOccupancy(), start, direction, num_cells);
+  if (search_type <= 0) count += CountOccupancyRun(pop.GetPreyAVOccupancy(), start, direction, num_cells);
+  return count;
+}
+
+int cOrgSensor::CountOccupancyRun(const cOccupancyIndex& index, const Apto::Coord<int>& start, const Apto::Coord<int>& direction, const int num_cells)
+{
+  if (num_cells <= 0) return 0;
+  
+  const bool torus = (m_world->GetConfig().WORLD_GEOMETRY.Get() == 2);
+  const bool along_row = (direction.X() != 0);
+  const int line_size = along_row ? m_world->GetConfig().WORLD_X.Get() : m_world->GetConfig().WORLD_Y.Get();
+  const int line = along_row ? start.Y() : start.X();
+  const int origin = along_row ? start.X() : start.Y();
+  const int step = along_row ? direction.X() : direction.Y();
+  
+  int lo = origin + step;
+  int hi = origin + step * num_cells;
+  if (lo > hi) std::swap(lo, hi);
+  
+  // off-world cells on bounded grids are clipped by the index itself; on the torus the run wraps around
+  if (torus) {
+    if (num_cells >= line_size) {
+      lo = 0;
+      hi = line_size - 1;
+    } else if (lo < 0) {
+      return (along_row ? index.CountRow(line, lo + line_size, line_size - 1) : index.CountCol(line, lo + line_size, line_size - 1))
+        + (along_row ? index.CountRow(line, 0, hi) : index.CountCol(line, 0, hi));
+    } else if (hi >= line_size) {
+      return (along_row ? index.CountRow(line, lo, line_size - 1) : index.CountCol(line, lo, line_size - 1))
+        + (along_row ? index.CountRow(line, 0, hi - line_size) : index.CountCol(line, 0, hi - line_size));
+    }
+  }
+  return along_row ? index.CountRow(line, lo, hi) : index.CountCol(line, lo, hi);
+}
+
 void cOrgSensor::CorrectTorusEdge(Apto::Coord<int>& cell, sBounds& worldBounds)
 {
   if (cell.X() > worldBounds.max_x) { cell.X() = worldBounds.min_x + (cell.X() - worldBounds.max_x - 1); }
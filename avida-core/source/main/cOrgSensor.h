@@ -28,6 +28,8 @@
 #include "cResourceLib.h"
 #include "cWorld.h"
 
+class cOccupancyIndex;
+
 struct sOrgDisplay 
 {
   int distance;
@@ -52,6 +54,7 @@ class cOrgSensor
   const cResourceLib& m_res_lib;
   
   void ResetOrgSensor();
+  int CountOccupancyRun(const cOccupancyIndex& index, const Apto::Coord<int>& start, const Apto::Coord<int>& direction, const int num_cells);
   
   public:
   cOrgSensor(cWorld* world, cOrganism* in_organism);
@@ -129,6 +132,8 @@ class cOrgSensor
 
   void WalkTorus(cAvidaContext& ctx, sLookInit& in_defs, const int facing, const int cell_id, sWalkLimits& limits, sLookOut& stuff_seen, Apto::Coord<int>& center_cell, sBounds& tot_bounds, sBounds& worldBounds, const Apto::Array<int, Apto::Smart>& val_res, Apto::Coord<int>& this_cell, const Apto::Coord<int>& ahead_dir, const int& worldx);
   void CorrectTorusEdge(Apto::Coord<int>& cell, sBounds& worldBounds);
+  int CountOccupancy(const Apto::Coord<int>& cell, const int search_type);
+  int CountOccupancy(const Apto::Coord<int>& start, const Apto::Coord<int>& direction, const int num_cells, const int search_type);
   void GetTorusTravelDist(int& travel_dist, int& x_dist, int& y_dist, const int facing, const int worldx, const int worldy);
   void GetConfusionOddsDensity(cAvidaContext& ctx, double& odds, cOrganism* first_org);
   void GetConfusionOddsFacings(cAvidaContext& ctx, double& odds, cOrganism* first_org);
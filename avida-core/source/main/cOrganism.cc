@@ -32,6 +32,7 @@
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cInstSet.h"
+#include "cObjectPool.h"
 #include "cOrgSensor.h"
 #include "cPopulationCell.h"
 #include "cStateGrid.h"
@@ -79,6 +80,7 @@ public:
   virtual ~OrgPropRetrievalContainer() { ; }
   
   virtual const Property& Get(cOrganism*, const cOrganism::OrgPropertyMap*) const = 0;
+  virtual void Compile(cOrganism::PropertyAccessor& accessor) const = 0;
 };
 
 
@@ -100,6 +102,25 @@ public:
   {
     return prop_map->SetTempProp(m_prop_id, (org->*m_fun)());
   }
+  
+  void Compile(cOrganism::PropertyAccessor& accessor) const { compileAccessor(accessor, m_fun); }
+  
+private:
+  static void compileAccessor(cOrganism::PropertyAccessor& accessor, int (cOrganism::*fun)())
+  {
+    accessor.m_type = cOrganism::PropertyAccessor::ACCESSOR_INT;
+    accessor.m_int_fun = fun;
+  }
+  static void compileAccessor(cOrganism::PropertyAccessor& accessor, double (cOrganism::*fun)())
+  {
+    accessor.m_type = cOrganism::PropertyAccessor::ACCESSOR_DOUBLE;
+    accessor.m_double_fun = fun;
+  }
+  static void compileAccessor(cOrganism::PropertyAccessor& accessor, Apto::String (cOrganism::*fun)())
+  {
+    accessor.m_type = cOrganism::PropertyAccessor::ACCESSOR_STRING;
+    accessor.m_string_fun = fun;
+  }
 };
 
 
@@ -141,6 +162,28 @@ void cOrganism::Initialize()
 }
 
 
+// cOrganism::ResolveProperty() - compile a property id into a direct accessor
+// --------------------------------------------------------------------------------------------------------------
+
+cOrganism::PropertyAccessor cOrganism::ResolveProperty(const PropertyID& prop_id)
+{
+  PropertyAccessor accessor;
+  OrgPropRetrievalContainer* container = NULL;
+  if (OrgGlobalPropMapSingleton::Instance().prop_map.Get(prop_id, container)) container->Compile(accessor);
+  return accessor;
+}
+
+Apto::String cOrganism::PropertyAccessor::StringValue(cOrganism* org) const
+{
+  switch (m_type) {
+    case ACCESSOR_INT:    return Apto::AsStr((org->*m_int_fun)());
+    case ACCESSOR_DOUBLE: return Apto::AsStr((org->*m_double_fun)());
+    case ACCESSOR_STRING: return (org->*m_string_fun)();
+    default:              return Apto::String();
+  }
+}
+
+
 
 // Creation Policies
 // --------------------------------------------------------------------------------------------------------------
@@ -248,7 +291,7 @@ void cOrganism::initialize(cAvidaContext& ctx)
 cOrganism::~cOrganism()
 {  
   assert(m_is_running == false);
-  delete m_hardware;
+  cHardwareManager::Destroy(m_hardware);
   delete m_interface;
   
   if(m_msg) delete m_msg;
@@ -260,6 +303,22 @@ cOrganism::~cOrganism()
 }
 
 
+void* cOrganism::operator new(size_t size, cWorld* world)
+{
+  return world->GetOrganismPool().Allocate(size);
+}
+
+void cOrganism::operator delete(void* ptr, cWorld*)
+{
+  cObjectPool::Release(ptr);
+}
+
+void cOrganism::operator delete(void* ptr)
+{
+  cObjectPool::Release(ptr);
+}
+
+
 const PropertyMap& cOrganism::Properties() const { return m_prop_map; }
 
 void cOrganism::SetOrgInterface(cAvidaContext& ctx, cOrgInterface* org_interface)
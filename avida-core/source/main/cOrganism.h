@@ -117,6 +117,11 @@ public:
   cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src);
   ~cOrganism();
   
+  // Organism storage is recycled through the owning world's pool; create with 'new (world) cOrganism(world, ...)'
+  static void* operator new(size_t size, cWorld* world);
+  static void operator delete(void* ptr, cWorld* world);
+  static void operator delete(void* ptr);
+  
   static void Initialize();
   
   
@@ -125,7 +130,33 @@ public:
   const Genome& UnitGenome() const { return m_initial_genome; }
   
   const PropertyMap& Properties() const;
-  
+
+  // Compiled property access - a PropertyID resolved once against the global organism property table.  The accessor
+  // calls the underlying getter directly, skipping the per-organism map lookup and temporary Property construction.
+  class PropertyAccessor
+  {
+    friend class cOrganism;
+    template <class T> friend class OrgPropOfType;
+  private:
+    enum AccessorType { ACCESSOR_NONE, ACCESSOR_INT, ACCESSOR_DOUBLE, ACCESSOR_STRING };
+
+    AccessorType m_type;
+    int (cOrganism::*m_int_fun)();
+    double (cOrganism::*m_double_fun)();
+    Apto::String (cOrganism::*m_string_fun)();
+
+  public:
+    inline PropertyAccessor() : m_type(ACCESSOR_NONE), m_int_fun(NULL), m_double_fun(NULL), m_string_fun(NULL) { ; }
+
+    inline bool IsValid() const { return m_type != ACCESSOR_NONE; }
+
+    inline int IntValue(cOrganism* org) const;
+    inline double DoubleValue(cOrganism* org) const;
+    Apto::String StringValue(cOrganism* org) const;
+  };
+
+  static PropertyAccessor ResolveProperty(const PropertyID& prop_id);
+
 
   // --------  Support Methods  --------
   inline double GetTestFitness(cAvidaContext& ctx) const;
@@ -848,6 +879,27 @@ inline double cOrganism::GetTestColonyFitness(cAvidaContext& ctx) const {
 }
 
 
+inline int cOrganism::PropertyAccessor::IntValue(cOrganism* org) const
+{
+  switch (m_type) {
+    case ACCESSOR_INT:    return (org->*m_int_fun)();
+    case ACCESSOR_DOUBLE: return (int)(org->*m_double_fun)();
+    case ACCESSOR_STRING: return Apto::StrAs((org->*m_string_fun)());
+    default:              return 0;
+  }
+}
+
+inline double cOrganism::PropertyAccessor::DoubleValue(cOrganism* org) const
+{
+  switch (m_type) {
+    case ACCESSOR_INT:    return (org->*m_int_fun)();
+    case ACCESSOR_DOUBLE: return (org->*m_double_fun)();
+    case ACCESSOR_STRING: return Apto::StrAs((org->*m_string_fun)());
+    default:              return 0.0;
+  }
+}
+
+
 inline void cOrganism::SetSleeping(bool sleeping)
 {
   m_is_sleeping = sleeping;
@@ -21,19 +21,30 @@
 
 #include "cPhenPlastGenotype.h"
 #include "cPhenPlastSummary.h"
+
+#include "apto/core/Mutex.h"
+#include "apto/core/Thread.h"
+#include "apto/platform.h"
+
+#include "cAnalyzeJobWorker.h"
+#include "cAvidaContext.h"
+#include "cStats.h"
+#include "cTestCPU.h"
+
 #include <iostream>
 #include <cmath>
 #include <cfloat>
 
 const Apto::String cPhenPlastSummary::ObjectKey("cPhenPlastSummary");
 
-cPhenPlastGenotype::cPhenPlastGenotype(const Genome& in_genome, int num_trials, cCPUTestInfo& test_info,  cWorld* world, cAvidaContext& ctx)
+cPhenPlastGenotype::cPhenPlastGenotype(const Genome& in_genome, int num_trials, cCPUTestInfo& test_info,  cWorld* world, cAvidaContext& ctx,
+                                       cTestCPU* testcpu)
 : m_genome(in_genome), m_num_trials(num_trials), m_world(world)
 {
   // Override input mode if more than one recalculation requested
   if (num_trials > 1)  
     test_info.UseRandomInputs(true);
-  Process(test_info, world, ctx);
+  Process(test_info, world, ctx, testcpu);
 }
 
 cPhenPlastGenotype::~cPhenPlastGenotype()
@@ -45,26 +56,176 @@ cPhenPlastGenotype::~cPhenPlastGenotype()
   }
 }
 
-void cPhenPlastGenotype::Process(cCPUTestInfo& test_info, cWorld* world, cAvidaContext& ctx)
+// Trials are run in fixed size blocks, each with its own set of phenotypes.  Blocks are merged back in trial order, so
+// the phenotypes found (and the first observation recorded for each) do not depend on how many threads ran them.
+static const int PHENPLAST_BLOCK_SIZE = 10;
+
+// When sampling adaptively, convergence is checked after every round of this many trials
+static const int PHENPLAST_ROUND_SIZE = 100;
+
+
+class cPhenPlastGenotype::TrialBlock
 {
-  cTestCPU* test_cpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+public:
+  int m_first_trial;
+  int m_num_trials;
+  tList<cPlasticPhenotype> m_phenotypes;  // In order of first observation
+  UniquePhenotypes m_unique;
+  
+  TrialBlock(int first_trial, int num_trials) : m_first_trial(first_trial), m_num_trials(num_trials) { ; }
+  ~TrialBlock() { cPlasticPhenotype* pp = NULL; while ((pp = m_phenotypes.Pop())) delete pp; }
+  
+  void Run(cAvidaContext& ctx, Apto::RNG::AvidaRNG& rng, cTestCPU* test_cpu, cCPUTestInfo& test_info,
+           const Genome& genome, const Apto::Array<int>& seeds);
+};
+
 
-  if (m_num_trials > 1) test_info.UseRandomInputs(true);
+class cPhenPlastGenotype::TrialWorker : public Apto::Thread
+{
+private:
+  cWorld* m_world;
+  cAvidaContext& m_ctx;
+  const Genome& m_genome;
+  const cCPUTestInfo& m_settings;
+  const Apto::Array<int>& m_seeds;
+  Apto::Array<TrialBlock*>& m_blocks;
+  Apto::Mutex& m_mutex;
+  int& m_next_block;
+  cStats* m_stats;  // only for workers started on their own thread
+  
+  void Run();
+  
+public:
+  TrialWorker(cWorld* world, cAvidaContext& ctx, const Genome& genome, const cCPUTestInfo& settings,
+              const Apto::Array<int>& seeds, Apto::Array<TrialBlock*>& blocks, Apto::Mutex& mutex, int& next_block,
+              cStats* stats = NULL)
+    : m_world(world), m_ctx(ctx), m_genome(genome), m_settings(settings), m_seeds(seeds), m_blocks(blocks)
+    , m_mutex(mutex), m_next_block(next_block), m_stats(stats) { ; }
+  ~TrialWorker() { delete m_stats; }
   
-  for (int k = 0; k < m_num_trials; k++){
-    test_cpu->TestGenome(ctx, test_info, m_genome);
-    //Is this a new phenotype?
+  void RunBlocks(cCPUTestInfo& test_info);
+};
+
+
+void cPhenPlastGenotype::TrialBlock::Run(cAvidaContext& ctx, Apto::RNG::AvidaRNG& rng, cTestCPU* test_cpu,
+                                         cCPUTestInfo& test_info, const Genome& genome, const Apto::Array<int>& seeds)
+{
+  for (int k = m_first_trial; k < m_first_trial + m_num_trials; k++) {
+    rng.ResetSeed(seeds[k]);
+    test_cpu->TestGenome(ctx, test_info, genome);
+    
     UniquePhenotypes::iterator uit = m_unique.find(&test_info.GetTestPhenotype());
-    if (uit == m_unique.end()){  // Yes, make a new entry for it
-      cPlasticPhenotype* new_phen = new cPlasticPhenotype(test_info, m_num_trials);
-      m_plastic_phenotypes.Push(new_phen);
-      m_unique.insert( static_cast<cPhenotype*>(new_phen) );
-    } else{   // No, add an observation to existing entry, make sure it is equivalent
-      if (!static_cast<cPlasticPhenotype*>((*uit))->AddObservation(test_info)){
-        cerr << "Error with this plastic phenotype. Abort." << endl;
-        exit(3);
+    if (uit == m_unique.end()) {
+      cPlasticPhenotype* new_phen = new cPlasticPhenotype(test_info, seeds.GetSize());
+      m_phenotypes.PushRear(new_phen);
+      m_unique.insert(static_cast<cPhenotype*>(new_phen));
+    } else if (!static_cast<cPlasticPhenotype*>(*uit)->AddObservation(test_info)) {
+      cerr << "Error with this plastic phenotype. Abort." << endl;
+      exit(3);
+    }
+  }
+}
+
+
+void cPhenPlastGenotype::TrialWorker::Run()
+{
+  // Test CPUs on this thread record into the snapshot, never into the live stats
+  cWorld::SetThreadStats(m_stats);
+  
+  cCPUTestInfo test_info(m_settings.GetGenerationTests());
+  test_info.CopySettings(m_settings);
+  RunBlocks(test_info);
+  
+  cWorld::SetThreadStats(NULL);
+}
+
+void cPhenPlastGenotype::TrialWorker::RunBlocks(cCPUTestInfo& test_info)
+{
+  // Each worker reseeds its own generator before every trial, leaving the caller's untouched
+  Apto::RNG::AvidaRNG rng;
+  cAvidaContext ctx((m_ctx.HasDriver()) ? &m_ctx.Driver() : NULL, rng);
+  if (m_ctx.GetAnalyzeMode()) ctx.SetAnalyzeMode();
+  if (m_ctx.OrgFaultReporting()) ctx.EnableOrgFaultReporting();
+  
+  cTestCPU* test_cpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  
+  while (true) {
+    m_mutex.Lock();
+    const int block = m_next_block++;
+    m_mutex.Unlock();
+    if (block >= m_blocks.GetSize()) break;
+    
+    m_blocks[block]->Run(ctx, rng, test_cpu, test_info, m_genome, m_seeds);
+  }
+  
+  delete test_cpu;
+}
+
+
+// Upper tail quantile of the standard normal distribution (Abramowitz & Stegun 26.2.23, error < 4.5e-4)
+static double NormalQuantile(double tail)
+{
+  if (tail >= 0.5) return 0.0;
+  if (tail <= 0.0) return DBL_MAX;
+  const double t = sqrt(-2.0 * log(tail));
+  return t - (2.515517 + 0.802853 * t + 0.010328 * t * t) / (1.0 + 1.432788 * t + 0.189269 * t * t + 0.001308 * t * t * t);
+}
+
+
+void cPhenPlastGenotype::Process(cCPUTestInfo& test_info, cWorld* world, cAvidaContext& ctx, cTestCPU* testcpu)
+{
+  if (m_num_trials > 1) {
+    test_info.UseRandomInputs(true);
+    
+    int num_workers = m_world->GetConfig().PHENPLAST_CONCURRENCY.Get();
+    if (num_workers < 1 || num_workers > Apto::Platform::AvailableCPUs()) num_workers = Apto::Platform::AvailableCPUs();
+    if (test_info.GetTracer()) num_workers = 1;  // A tracer cannot follow several organisms at once
+    if (cAnalyzeJobWorker::InWorkerThread()) num_workers = 1;  // Analyze jobs already run one per CPU
+    
+    const double tolerance = m_world->GetConfig().PHENPLAST_TOLERANCE.Get();
+    const double confidence = m_world->GetConfig().PHENPLAST_CONFIDENCE.Get();
+    
+    // Every trial gets its own seed, drawn in trial order from a generator seeded once from the caller's context.
+    // This holds even with a single worker, so the phenotypes found are the same for any PHENPLAST_CONCURRENCY.
+    Apto::RNG::AvidaRNG seed_rng(ctx.GetRandom().GetInt(ctx.GetRandom().MaxSeed()));
+    Apto::Array<int> seeds(m_num_trials);
+    for (int k = 0; k < m_num_trials; k++) seeds[k] = seed_rng.GetInt(seed_rng.MaxSeed());
+    
+    int trials_run = 0;
+    while (trials_run < m_num_trials) {
+      int round_trials = m_num_trials - trials_run;
+      if (tolerance > 0.0 && round_trials > PHENPLAST_ROUND_SIZE) round_trials = PHENPLAST_ROUND_SIZE;
+      
+      runTrials(test_info, ctx, seeds, trials_run, round_trials, num_workers);
+      trials_run += round_trials;
+      
+      if (tolerance > 0.0 && frequenciesConverged(trials_run, confidence, tolerance)) break;
+    }
+    
+    // Frequencies are relative to the trials actually run
+    m_num_trials = trials_run;
+    tListIterator<cPlasticPhenotype> ppit(m_plastic_phenotypes);
+    while (ppit.Next()) ppit.Get()->SetNumTrials(m_num_trials);
+  } else {
+    cTestCPU* test_cpu = (testcpu) ? testcpu : m_world->GetHardwareManager().CreateTestCPU(ctx);
+    
+    for (int k = 0; k < m_num_trials; k++){
+      test_cpu->TestGenome(ctx, test_info, m_genome);
+      //Is this a new phenotype?
+      UniquePhenotypes::iterator uit = m_unique.find(&test_info.GetTestPhenotype());
+      if (uit == m_unique.end()){  // Yes, make a new entry for it
+        cPlasticPhenotype* new_phen = new cPlasticPhenotype(test_info, m_num_trials);
+        m_plastic_phenotypes.Push(new_phen);
+        m_unique.insert( static_cast<cPhenotype*>(new_phen) );
+      } else{   // No, add an observation to existing entry, make sure it is equivalent
+        if (!static_cast<cPlasticPhenotype*>((*uit))->AddObservation(test_info)){
+          cerr << "Error with this plastic phenotype. Abort." << endl;
+          exit(3);
+        }
       }
     }
+    
+    if (test_cpu != testcpu) delete test_cpu;
   }
   
   // Update statistics
@@ -105,8 +266,76 @@ void cPhenPlastGenotype::Process(cCPUTestInfo& test_info, cWorld* world, cAvidaC
     m_viable_probability += (this_phen->IsViable() > 0) ? freq : 0;
     ++uit;
   }
+}
+
+
+void cPhenPlastGenotype::runTrials(cCPUTestInfo& test_info, cAvidaContext& ctx, const Apto::Array<int>& seeds,
+                                   int first_trial, int num_trials, int num_workers)
+{
+  Apto::Array<TrialBlock*> blocks;
+  for (int k = first_trial; k < first_trial + num_trials; k += PHENPLAST_BLOCK_SIZE) {
+    const int block_trials = (first_trial + num_trials - k < PHENPLAST_BLOCK_SIZE) ? first_trial + num_trials - k : PHENPLAST_BLOCK_SIZE;
+    blocks.Push(new TrialBlock(k, block_trials));
+  }
+  if (num_workers > blocks.GetSize()) num_workers = blocks.GetSize();
+  
+  Apto::Mutex mutex;
+  int next_block = 0;
+  if (num_workers <= 1) {
+    // Run on the calling thread, with the caller's own test info (and tracer)
+    TrialWorker worker(m_world, ctx, m_genome, test_info, seeds, blocks, mutex, next_block);
+    worker.RunBlocks(test_info);
+  } else {
+    Apto::Array<TrialWorker*> workers(num_workers);
+    for (int i = 0; i < num_workers; i++) {
+      // The stats snapshot is taken here, on the calling thread
+      workers[i] = new TrialWorker(m_world, ctx, m_genome, test_info, seeds, blocks, mutex, next_block,
+                                   m_world->GetStats().NewTestCPUSnapshot());
+      workers[i]->Start();
+    }
+    for (int i = 0; i < num_workers; i++) {
+      workers[i]->Join();
+      delete workers[i];
+    }
+  }
+  
+  for (int i = 0; i < blocks.GetSize(); i++) {
+    mergeBlock(*blocks[i]);
+    delete blocks[i];
+  }
+}
+
+
+void cPhenPlastGenotype::mergeBlock(TrialBlock& block)
+{
+  cPlasticPhenotype* block_phen = NULL;
+  while ((block_phen = block.m_phenotypes.Pop())) {
+    UniquePhenotypes::iterator uit = m_unique.find(static_cast<cPhenotype*>(block_phen));
+    if (uit == m_unique.end()) {
+      m_plastic_phenotypes.Push(block_phen);
+      m_unique.insert(static_cast<cPhenotype*>(block_phen));
+    } else {
+      static_cast<cPlasticPhenotype*>(*uit)->MergeObservations(*block_phen);
+      delete block_phen;
+    }
+  }
+}
+
+
+// Sampling has converged once the normal approximation confidence interval of every observed frequency, and the upper
+// bound on the frequency of any phenotype not yet seen (-ln(1 - confidence) / n, the "rule of three" at 95%), are all
+// within the tolerance.
+bool cPhenPlastGenotype::frequenciesConverged(int num_trials, double confidence, double tolerance) const
+{
+  if (confidence >= 1.0) return false;
+  if (-log(1.0 - confidence) / num_trials > tolerance) return false;
   
-  if (test_cpu) delete test_cpu;
+  const double z = NormalQuantile((1.0 - confidence) / 2.0);
+  for (UniquePhenotypes::const_iterator uit = m_unique.begin(); uit != m_unique.end(); ++uit) {
+    const double freq = static_cast<double>(static_cast<cPlasticPhenotype*>(*uit)->GetNumObservations()) / num_trials;
+    if (z * sqrt(freq * (1.0 - freq) / num_trials) > tolerance) return false;
+  }
+  return true;
 }
 
 
@@ -47,12 +47,14 @@ using namespace Avida;
 class cPhenPlastGenotype
 {
 private:
+  class TrialBlock;
+  class TrialWorker;
 
   typedef set<cPhenotype*, cPhenotype::PhenotypeCompare  > UniquePhenotypes;  //Actually, these are cPlasticPhenotypes*
   tList<cPlasticPhenotype> m_plastic_phenotypes;  //This will store a list of our unique plastic phenotype pointers  
   Genome m_genome;
   
-  int m_num_trials;  
+  int m_num_trials;  // Trials actually run, which may be fewer than requested when sampling adaptively
   UniquePhenotypes m_unique;
   cWorld* m_world;
     
@@ -69,10 +71,16 @@ private:
     
     
   
-  void Process(cCPUTestInfo& test_info, cWorld* world, cAvidaContext& ctx);
+  void Process(cCPUTestInfo& test_info, cWorld* world, cAvidaContext& ctx, cTestCPU* testcpu);
+  void runTrials(cCPUTestInfo& test_info, cAvidaContext& ctx, const Apto::Array<int>& seeds, int first_trial, int num_trials,
+                 int num_workers);
+  void mergeBlock(TrialBlock& block);
+  bool frequenciesConverged(int num_trials, double confidence, double tolerance) const;
   
 public:
-  cPhenPlastGenotype(const Genome& in_genome, int num_trails, cCPUTestInfo& test_info,  cWorld* world, cAvidaContext& ctx);
+  // A single trial runs on testcpu when one is given, rather than on a test CPU of its own
+  cPhenPlastGenotype(const Genome& in_genome, int num_trails, cCPUTestInfo& test_info,  cWorld* world, cAvidaContext& ctx,
+                     cTestCPU* testcpu = NULL);
   ~cPhenPlastGenotype();
     
   // Accessors
@@ -109,38 +109,45 @@ private:
   int cur_num_errors;                         // Total instructions executed illeagally.
   int cur_num_donates;                        // Number of donations so far
 
-  Apto::Array<int> cur_task_count;                 // Total times each task was performed
+  // Per-gestation counters.  The current and last sets trade places on divide, so locking in the current counts is a
+  // swap followed by a clear rather than a copy of every array.
+  struct sGestationCounters {
+    Apto::Array<int> task_count;                 // Total times each task was performed
+    Apto::Array<int> host_tasks;                 // Total times each task was done by JUST the host @LZ
+    Apto::Array<int> internal_task_count;        // Total times each task was performed using internal resources
+    Apto::Array<double> task_quality;            // Average (total?) quality with which each task was performed
+    Apto::Array<double> task_value;              // Value with which this phenotype performs task
+    Apto::Array<double> internal_task_quality;   // Average (total?) quaility with which each task using internal resources was performed
+    Apto::Array<int> collect_spec_counts;        // How many times each nop-specification was used in a collect-type instruction
+    Apto::Array<int> reaction_count;             // Total times each reaction was triggered.
+    Apto::Array<double> reaction_add_reward;     // Bonus change from triggering each reaction.
+    Apto::Array<int> inst_count;                 // Instruction exection counter
+    Apto::Array<int> from_sensor_count;          // Use of inputs that originated from sensory data were used in execution of this instruction.
+    Apto::Array<int> from_message_count;         // Use of inputs that originated from messages were used in execution of this instruction.
+    Apto::Array< Apto::Array<int> > group_attack_count;
+    Apto::Array< Apto::Array<int> > top_pred_group_attack_count;
+    Apto::Array<int> killed_targets;
+    Apto::Array<int> sense_count;                // Total times resource combinations have been sensed; @JEB
+  };
+  sGestationCounters m_counters[2];
+  int m_cur_counters;                            // Which of m_counters holds the current gestation
+
   Apto::Array<int> cur_para_tasks;                 // Total times each task was performed by the parasite @LZ
-  Apto::Array<int> cur_host_tasks;                 // Total times each task was done by JUST the host @LZ
-  Apto::Array<int> cur_internal_task_count;        // Total times each task was performed using internal resources
   Apto::Array<int> eff_task_count;                 // Total times each task was performed (resetable during the life of the organism)
-  Apto::Array<double> cur_task_quality;            // Average (total?) quality with which each task was performed
-  Apto::Array<double> cur_task_value;              // Value with which this phenotype performs task
-  Apto::Array<double> cur_internal_task_quality;   // Average (total?) quaility with which each task using internal resources was performed
   Apto::Array<double> cur_rbins_total;             // Total amount of resources collected over the organism's life
   Apto::Array<double> cur_rbins_avail;             // Amount of internal resources available
-  Apto::Array<int> cur_collect_spec_counts;        // How many times each nop-specification was used in a collect-type instruction
-  Apto::Array<int> cur_reaction_count;             // Total times each reaction was triggered.
   Apto::Array<int> first_reaction_cycles;          // CPU cycles of first time reaction was triggered.
   Apto::Array<int> first_reaction_execs;            // Execution count at first time reaction was triggered (will be > cycles in parallel exec multithreaded orgs).
   Apto::Array<int> cur_stolen_reaction_count;      // Total counts of reactions stolen by predators.
-  Apto::Array<double> cur_reaction_add_reward;     // Bonus change from triggering each reaction.
-  Apto::Array<int> cur_inst_count;                 // Instruction exection counter
-  Apto::Array<int> cur_from_sensor_count;           // Use of inputs that originated from sensory data were used in execution of this instruction.
-  Apto::Array< Apto::Array<int> > cur_group_attack_count;
-  Apto::Array< Apto::Array<int> > cur_top_pred_group_attack_count;
-  Apto::Array<int> cur_killed_targets;
   int cur_attacks;
   int cur_kills;
   
-  Apto::Array<int> cur_sense_count;                // Total times resource combinations have been sensed; @JEB
   Apto::Array<double> sensed_resources;            // Resources which the organism has sensed; @JEB
   Apto::Array<double> cur_task_time;               // Time at which each task was last performed; WRE 03-18-07
   Apto::Map<void*, cTaskState*> m_task_states;
   Apto::Array<double> cur_trial_fitnesses;         // Fitnesses of various trials.; @JEB
   Apto::Array<double> cur_trial_bonuses;           // Bonuses of various trials.; @JEB
   Apto::Array<int> cur_trial_times_used;           // Time used in of various trials.; @JEB
-  Apto::Array<int> cur_from_message_count;           // Use of inputs that originated from messages were used in execution of this instruction.
 
   int trial_time_used;                        // like time_used, but reset every trial; @JEB
   int trial_cpu_cycles_used;                  // like cpu_cycles_used, but reset every trial; @JEB
@@ -167,28 +174,12 @@ private:
   int last_num_errors;
   int last_num_donates;
 
-  Apto::Array<int> last_task_count;
   Apto::Array<int> last_para_tasks;
-  Apto::Array<int> last_host_tasks;                // Last task counts from hosts only, before last divide @LZ
-  Apto::Array<int> last_internal_task_count;
-  Apto::Array<double> last_task_quality;
-  Apto::Array<double> last_task_value;
-  Apto::Array<double> last_internal_task_quality;
   Apto::Array<double> last_rbins_total;
   Apto::Array<double> last_rbins_avail;
-  Apto::Array<int> last_collect_spec_counts;
-  Apto::Array<int> last_reaction_count;
-  Apto::Array<double> last_reaction_add_reward;
-  Apto::Array<int> last_inst_count;	  // Instruction exection counter
-  Apto::Array<int> last_from_sensor_count;
-  Apto::Array<int> last_sense_count;   // Total times resource combinations have been sensed; @JEB
-  Apto::Array< Apto::Array<int> > last_group_attack_count;
-  Apto::Array< Apto::Array<int> > last_top_pred_group_attack_count;
-  Apto::Array<int> last_killed_targets;
   int last_attacks;
   int last_kills;
 
-  Apto::Array<int> last_from_message_count;
 
   double last_fitness;            // Used to determine sterilization.
   int last_cpu_cycles_used;
@@ -312,9 +303,15 @@ private:
 
   inline void SetInstSetSize(int inst_set_size);
   inline void SetGroupAttackInstSetSize(int num_group_attack_inst);
+
+  inline sGestationCounters& curCounters() { return m_counters[m_cur_counters]; }
+  inline const sGestationCounters& curCounters() const { return m_counters[m_cur_counters]; }
+  inline sGestationCounters& lastCounters() { return m_counters[1 - m_cur_counters]; }
+  inline const sGestationCounters& lastCounters() const { return m_counters[1 - m_cur_counters]; }
+  void swapCounters();
   
 public:
-  cPhenotype() : m_world(NULL), m_reaction_result(NULL) { ; } // Will not construct a valid cPhenotype! Only exists to support incorrect cDeme Apto::Array usage.
+  cPhenotype() : m_world(NULL), m_cur_counters(0), m_reaction_result(NULL) { ; } // Will not construct a valid cPhenotype! Only exists to support incorrect cDeme Apto::Array usage.
   cPhenotype(cWorld* world, int parent_generation, int num_nops);
 
 
@@ -365,8 +362,8 @@ public:
   }
   int CalcID() const {
     int phen_id = 0;
-    for (int i = 0; i < last_task_count.GetSize(); i++) {
-      if (last_task_count[i] > 0) phen_id += (1 << i);
+    for (int i = 0; i < lastCounters().task_count.GetSize(); i++) {
+      if (lastCounters().task_count[i] > 0) phen_id += (1 << i);
     }
     return phen_id;
   }
@@ -419,34 +416,34 @@ public:
   bool GetToDelete() const { assert(initialized == true); return to_delete; }
   int GetCurNumErrors() const { assert(initialized == true); return cur_num_errors; }
   int GetCurNumDonates() const { assert(initialized == true); return cur_num_donates; }
-  int GetCurCountForTask(int idx) const { assert(initialized == true); return cur_task_count[idx]; }
-  const Apto::Array<int>& GetCurTaskCount() const { assert(initialized == true); return cur_task_count; }
-  const Apto::Array<int>& GetCurHostTaskCount() const { assert(initialized == true); return cur_host_tasks; }
+  int GetCurCountForTask(int idx) const { assert(initialized == true); return curCounters().task_count[idx]; }
+  const Apto::Array<int>& GetCurTaskCount() const { assert(initialized == true); return curCounters().task_count; }
+  const Apto::Array<int>& GetCurHostTaskCount() const { assert(initialized == true); return curCounters().host_tasks; }
   const Apto::Array<int>& GetCurParasiteTaskCount() const { assert(initialized == true); return cur_para_tasks; }
-  const Apto::Array<int>& GetCurInternalTaskCount() const { assert(initialized == true); return cur_internal_task_count; }
+  const Apto::Array<int>& GetCurInternalTaskCount() const { assert(initialized == true); return curCounters().internal_task_count; }
   void ClearEffTaskCount() { assert(initialized == true); eff_task_count.SetAll(0); }
-  const Apto::Array<double> & GetCurTaskQuality() const { assert(initialized == true); return cur_task_quality; }
-  const Apto::Array<double> & GetCurTaskValue() const { assert(initialized == true); return cur_task_value; }
-  const Apto::Array<double> & GetCurInternalTaskQuality() const { assert(initialized == true); return cur_internal_task_quality; }
+  const Apto::Array<double> & GetCurTaskQuality() const { assert(initialized == true); return curCounters().task_quality; }
+  const Apto::Array<double> & GetCurTaskValue() const { assert(initialized == true); return curCounters().task_value; }
+  const Apto::Array<double> & GetCurInternalTaskQuality() const { assert(initialized == true); return curCounters().internal_task_quality; }
   const Apto::Array<double>& GetCurRBinsTotal() const { assert(initialized == true); return cur_rbins_total; }
   double GetCurRBinTotal(int index) const { assert(initialized == true); return cur_rbins_total[index]; }
   const Apto::Array<double>& GetCurRBinsAvail() const { assert(initialized == true); return cur_rbins_avail; }
   double GetCurRBinAvail(int index) const { assert(initialized == true); return cur_rbins_avail[index]; }
 
-  const Apto::Array<int>& GetCurReactionCount() const { assert(initialized == true); return cur_reaction_count;}
+  const Apto::Array<int>& GetCurReactionCount() const { assert(initialized == true); return curCounters().reaction_count;}
   const Apto::Array<int>& GetFirstReactionCycles() const { assert(initialized == true); return first_reaction_cycles;}
   void SetFirstReactionCycle(int idx) { if (first_reaction_cycles[idx] < 0) first_reaction_cycles[idx] = time_used; }
   const Apto::Array<int>& GetFirstReactionExecs() const { assert(initialized == true); return first_reaction_execs;}
   void SetFirstReactionExec(int idx) { if (first_reaction_execs[idx] < 0) first_reaction_execs[idx] = num_execs; }
 
   const Apto::Array<int>& GetStolenReactionCount() const { assert(initialized == true); return cur_stolen_reaction_count;}
-  const Apto::Array<double>& GetCurReactionAddReward() const { assert(initialized == true); return cur_reaction_add_reward;}
-  const Apto::Array<int>& GetCurInstCount() const { assert(initialized == true); return cur_inst_count; }
-  const Apto::Array<int>& GetCurSenseCount() const { assert(initialized == true); return cur_sense_count; }
+  const Apto::Array<double>& GetCurReactionAddReward() const { assert(initialized == true); return curCounters().reaction_add_reward;}
+  const Apto::Array<int>& GetCurInstCount() const { assert(initialized == true); return curCounters().inst_count; }
+  const Apto::Array<int>& GetCurSenseCount() const { assert(initialized == true); return curCounters().sense_count; }
 
   double GetSensedResource(int _in) { assert(initialized == true); return sensed_resources[_in]; }
-  const Apto::Array<int>& GetCurCollectSpecCounts() const { assert(initialized == true); return cur_collect_spec_counts; }
-  int GetCurCollectSpecCount(int spec_id) const { assert(initialized == true); return cur_collect_spec_counts[spec_id]; }
+  const Apto::Array<int>& GetCurCollectSpecCounts() const { assert(initialized == true); return curCounters().collect_spec_counts; }
+  int GetCurCollectSpecCount(int spec_id) const { assert(initialized == true); return curCounters().collect_spec_counts[spec_id]; }
   const Apto::Array<int>& GetTestCPUInstCount() const { assert(initialized == true); return testCPU_inst_count; }
 
   void  NewTrial(); //Save the current fitness, and reset the bonus. @JEB
@@ -470,32 +467,32 @@ public:
   int GetLastNumErrors() const { assert(initialized == true); return last_num_errors; }
   int GetLastNumDonates() const { assert(initialized == true); return last_num_donates; }
 
-  int GetLastCountForTask(int idx) const { assert(initialized == true); return last_task_count[idx]; }
-  const Apto::Array<int>& GetLastTaskCount() const { assert(initialized == true); return last_task_count; }
-  void SetLastTaskCount(Apto::Array<int> tasks) { assert(initialized == true); last_task_count = tasks; }
-  const Apto::Array<int>& GetLastHostTaskCount() const { assert(initialized == true); return last_host_tasks; }
+  int GetLastCountForTask(int idx) const { assert(initialized == true); return lastCounters().task_count[idx]; }
+  const Apto::Array<int>& GetLastTaskCount() const { assert(initialized == true); return lastCounters().task_count; }
+  void SetLastTaskCount(Apto::Array<int> tasks) { assert(initialized == true); lastCounters().task_count = tasks; }
+  const Apto::Array<int>& GetLastHostTaskCount() const { assert(initialized == true); return lastCounters().host_tasks; }
   const Apto::Array<int>& GetLastParasiteTaskCount() const { assert(initialized == true); return last_para_tasks; }
   void  SetLastParasiteTaskCount(Apto::Array<int>  oldParaPhenotype);
-  const Apto::Array<int>& GetLastInternalTaskCount() const { assert(initialized == true); return last_internal_task_count; }
-  const Apto::Array<double>& GetLastTaskQuality() const { assert(initialized == true); return last_task_quality; }
-  const Apto::Array<double>& GetLastTaskValue() const { assert(initialized == true); return last_task_value; }
-  const Apto::Array<double>& GetLastInternalTaskQuality() const { assert(initialized == true); return last_internal_task_quality; }
+  const Apto::Array<int>& GetLastInternalTaskCount() const { assert(initialized == true); return lastCounters().internal_task_count; }
+  const Apto::Array<double>& GetLastTaskQuality() const { assert(initialized == true); return lastCounters().task_quality; }
+  const Apto::Array<double>& GetLastTaskValue() const { assert(initialized == true); return lastCounters().task_value; }
+  const Apto::Array<double>& GetLastInternalTaskQuality() const { assert(initialized == true); return lastCounters().internal_task_quality; }
   const Apto::Array<double>& GetLastRBinsTotal() const { assert(initialized == true); return last_rbins_total; }
   const Apto::Array<double>& GetLastRBinsAvail() const { assert(initialized == true); return last_rbins_avail; }
-  const Apto::Array<int>& GetLastReactionCount() const { assert(initialized == true); return last_reaction_count; }
-  const Apto::Array<double>& GetLastReactionAddReward() const { assert(initialized == true); return last_reaction_add_reward; }
-  const Apto::Array<int>& GetLastInstCount() const { assert(initialized == true); return last_inst_count; }
-  const Apto::Array<int>& GetLastFromSensorInstCount() const { assert(initialized == true); return last_from_sensor_count; }
-  const Apto::Array<int>& GetLastSenseCount() const { assert(initialized == true); return last_sense_count; }
-  const Apto::Array< Apto::Array<int> >& GetLastGroupAttackInstCount() const { assert(initialized == true); return last_group_attack_count; }
-  const Apto::Array< Apto::Array<int> >& GetLastTopPredGroupAttackInstCount() const { assert(initialized == true); return last_top_pred_group_attack_count; }
+  const Apto::Array<int>& GetLastReactionCount() const { assert(initialized == true); return lastCounters().reaction_count; }
+  const Apto::Array<double>& GetLastReactionAddReward() const { assert(initialized == true); return lastCounters().reaction_add_reward; }
+  const Apto::Array<int>& GetLastInstCount() const { assert(initialized == true); return lastCounters().inst_count; }
+  const Apto::Array<int>& GetLastFromSensorInstCount() const { assert(initialized == true); return lastCounters().from_sensor_count; }
+  const Apto::Array<int>& GetLastSenseCount() const { assert(initialized == true); return lastCounters().sense_count; }
+  const Apto::Array< Apto::Array<int> >& GetLastGroupAttackInstCount() const { assert(initialized == true); return lastCounters().group_attack_count; }
+  const Apto::Array< Apto::Array<int> >& GetLastTopPredGroupAttackInstCount() const { assert(initialized == true); return lastCounters().top_pred_group_attack_count; }
 
-  const Apto::Array<int>& GetLastFromMessageInstCount() const { assert(initialized == true); return last_from_message_count; }
+  const Apto::Array<int>& GetLastFromMessageInstCount() const { assert(initialized == true); return lastCounters().from_message_count; }
 
   double GetLastFitness() const { assert(initialized == true); return last_fitness; }
   double GetPermanentGermlinePropensity() const { assert(initialized == true); return permanent_germline_propensity; }
-  const Apto::Array<int>& GetLastCollectSpecCounts() const { assert(initialized == true); return last_collect_spec_counts; }
-  int GetLastCollectSpecCount(int spec_id) const { assert(initialized == true); return last_collect_spec_counts[spec_id]; }
+  const Apto::Array<int>& GetLastCollectSpecCounts() const { assert(initialized == true); return lastCounters().collect_spec_counts; }
+  int GetLastCollectSpecCount(int spec_id) const { assert(initialized == true); return lastCounters().collect_spec_counts[spec_id]; }
 
   int GetNumDivides() const { assert(initialized == true); return num_divides;}
   int GetNumDivideFailed() const { assert(initialized == true); return num_divides_failed;}
@@ -619,7 +616,7 @@ public:
   int GetNumEnergyReceptions() { return num_energy_receptions; }
   int GetNumEnergyApplications() { return num_energy_applications; }
   
-  void SetReactionCount(int index, int val) { cur_reaction_count[index] = val; }
+  void SetReactionCount(int index, int val) { curCounters().reaction_count[index] = val; }
   void SetStolenReactionCount(int index, int val) { cur_stolen_reaction_count[index] = val; }
   
   bool GetKaboomExecuted() {return kaboom_executed;} //@AEJ
@@ -634,7 +631,7 @@ public:
   void SetCurRBinTotal(int index, double val) { cur_rbins_total[index] = val; }
   void AddToCurRBinAvail(int index, double val) { cur_rbins_avail[index] += val; }
   void AddToCurRBinTotal(int index, double val) { cur_rbins_total[index] += val; }
-  void SetCurCollectSpecCount(int spec_id, int val) { cur_collect_spec_counts[spec_id] = val; }
+  void SetCurCollectSpecCount(int spec_id, int val) { curCounters().collect_spec_counts[spec_id] = val; }
 
   void SetMatingType(int _mating_type) { mating_type = _mating_type; } //@CHC
   void SetMatePreference(int _mate_preference) { mate_preference = _mate_preference; } //@CHC
@@ -673,13 +670,13 @@ public:
   void SetCurBonus(double _bonus) { cur_bonus = _bonus; }
   void SetCurBonusInstCount(int _num_bonus_inst) {bonus_instruction_count = _num_bonus_inst;}
 
-  void IncCurInstCount(int _inst_num)  { assert(initialized == true); cur_inst_count[_inst_num]++; } 
-  void DecCurInstCount(int _inst_num)  { assert(initialized == true); cur_inst_count[_inst_num]--; }
-  void IncCurFromSensorInstCount(int _inst_num)  { assert(initialized == true); cur_from_sensor_count[_inst_num]++; }
-  void IncCurGroupAttackInstCount(int _inst_num, int pack_size_idx)  { assert(initialized == true); cur_group_attack_count[_inst_num][pack_size_idx]++; }
-  void IncCurTopPredGroupAttackInstCount(int _inst_num, int pack_size_idx)  { assert(initialized == true); cur_top_pred_group_attack_count[_inst_num][pack_size_idx]++; }
+  void IncCurInstCount(int _inst_num)  { assert(initialized == true); curCounters().inst_count[_inst_num]++; } 
+  void DecCurInstCount(int _inst_num)  { assert(initialized == true); curCounters().inst_count[_inst_num]--; }
+  void IncCurFromSensorInstCount(int _inst_num)  { assert(initialized == true); curCounters().from_sensor_count[_inst_num]++; }
+  void IncCurGroupAttackInstCount(int _inst_num, int pack_size_idx)  { assert(initialized == true); curCounters().group_attack_count[_inst_num][pack_size_idx]++; }
+  void IncCurTopPredGroupAttackInstCount(int _inst_num, int pack_size_idx)  { assert(initialized == true); curCounters().top_pred_group_attack_count[_inst_num][pack_size_idx]++; }
   void IncAttackedPreyFTData(int target_ft);
-  Apto::Array<int> GetKilledPreyFTData() { return cur_killed_targets; }
+  Apto::Array<int> GetKilledPreyFTData() { return curCounters().killed_targets; }
   void IncAttacks() { cur_attacks++; }
   void IncKills() { cur_kills++; }
   int GetLastAttacks() const { return last_attacks; }
@@ -696,7 +693,7 @@ public:
   void IncNumExecs() { assert(initialized == true); num_execs++; }
   void IncErrors()   { assert(initialized == true); cur_num_errors++; }
   void IncDonates()   { assert(initialized == true); cur_num_donates++; }
-  void IncSenseCount(const int) { /*assert(initialized == true); cur_sense_count[i]++;*/ }  
+  void IncSenseCount(const int) { /*assert(initialized == true); curCounters().sense_count[i]++;*/ }  
   
   void SetCurMatingDisplayA(int _cur_mating_display_a) { cur_mating_display_a = _cur_mating_display_a; } //@CHC
   void SetCurMatingDisplayB(int _cur_mating_display_b) { cur_mating_display_b = _cur_mating_display_b; } //@CHC
@@ -729,7 +726,7 @@ public:
   void  ResetNumNewUniqueReactions()  {num_new_unique_reactions =0; }
   double GetResourcesConsumed(); 
   Apto::Array<int> GetCumulativeReactionCount();
-  void IncCurFromMessageInstCount(int _inst_num)  { assert(initialized == true); cur_from_message_count[_inst_num]++; }
+  void IncCurFromMessageInstCount(int _inst_num)  { assert(initialized == true); curCounters().from_message_count[_inst_num]++; }
  
 
   // @LZ - Parasite Etc. Helpers
@@ -756,25 +753,25 @@ public:
 
 inline void cPhenotype::SetInstSetSize(int inst_set_size)
 {
-  cur_inst_count.Resize(inst_set_size, 0);
-  cur_from_sensor_count.Resize(inst_set_size, 0);
-  cur_from_message_count.Resize(inst_set_size, 0);
-  last_inst_count.Resize(inst_set_size, 0);
-  last_from_sensor_count.Resize(inst_set_size, 0);
-  last_from_message_count.Resize(inst_set_size, 0);
+  curCounters().inst_count.Resize(inst_set_size, 0);
+  curCounters().from_sensor_count.Resize(inst_set_size, 0);
+  curCounters().from_message_count.Resize(inst_set_size, 0);
+  lastCounters().inst_count.Resize(inst_set_size, 0);
+  lastCounters().from_sensor_count.Resize(inst_set_size, 0);
+  lastCounters().from_message_count.Resize(inst_set_size, 0);
 }
 
 inline void cPhenotype::SetGroupAttackInstSetSize(int num_group_attack_inst)
 {
-  last_group_attack_count.Resize(num_group_attack_inst);
-  last_top_pred_group_attack_count.Resize(num_group_attack_inst);
-  cur_group_attack_count.Resize(num_group_attack_inst);
-  cur_top_pred_group_attack_count.Resize(num_group_attack_inst);
-  for (int i = 0; i < last_group_attack_count.GetSize(); i++) {
-    last_group_attack_count[i].Resize(20, 0);
-    last_top_pred_group_attack_count[i].Resize(20, 0);
-    cur_group_attack_count[i].Resize(20, 0);
-    cur_top_pred_group_attack_count[i].Resize(20, 0);
+  lastCounters().group_attack_count.Resize(num_group_attack_inst);
+  lastCounters().top_pred_group_attack_count.Resize(num_group_attack_inst);
+  curCounters().group_attack_count.Resize(num_group_attack_inst);
+  curCounters().top_pred_group_attack_count.Resize(num_group_attack_inst);
+  for (int i = 0; i < lastCounters().group_attack_count.GetSize(); i++) {
+    lastCounters().group_attack_count[i].Resize(20, 0);
+    lastCounters().top_pred_group_attack_count[i].Resize(20, 0);
+    curCounters().group_attack_count[i].Resize(20, 0);
+    curCounters().top_pred_group_attack_count[i].Resize(20, 0);
   }
 }
 
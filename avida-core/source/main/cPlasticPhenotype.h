@@ -51,6 +51,8 @@ class cPlasticPhenotype : public cPhenotype{
     
     //Modifiers
     bool AddObservation(  cCPUTestInfo& test_info );
+    void MergeObservations(const cPlasticPhenotype& other) { m_num_observations += other.m_num_observations; }
+    void SetNumTrials(int num_trials) { assert(num_trials > 0); m_num_trials = num_trials; }
     
     //Accessors
     int GetNumObservations()      const { return m_num_observations; }
@@ -277,6 +277,9 @@ cPopulation::cPopulation(cWorld* world)
 , num_top_pred_organisms(0)
 , sync_events(false)
 , m_hgt_resid(-1)
+, m_death_prob_checked(false)
+, m_death_prob_uniform(false)
+, m_track_cell_changes(false)
 {
   world_x = world->GetConfig().WORLD_X.Get();
   world_y = world->GetConfig().WORLD_Y.Get();
@@ -333,7 +336,10 @@ void cPopulation::SetupCellGrid()
   assert(num_demes == 1 || m_world->GetConfig().BIRTH_METHOD.Get() != POSITION_OFFSPRING_FULL_SOUP_ELDEST);
   
   // Allocate the cells, resources, and market.
-  cell_array.ResizeClear(num_cells);
+  cell_array.ResizeClear(world_x, world_y, (cCellArray::Ordering)m_world->GetConfig().CELL_ORDERING.Get());
+  m_org_occupancy.Resize(world_x, world_y);
+  m_pred_av_occupancy.Resize(world_x, world_y);
+  m_prey_av_occupancy.Resize(world_x, world_y);
   empty_cell_id_array.ResizeClear(cell_array.GetSize());
   for (int i = 0; i < empty_cell_id_array.GetSize(); i++) {
     empty_cell_id_array[i] = i;
@@ -612,6 +618,30 @@ inline void cPopulation::AdjustSchedule(const cPopulationCell& cell, const cMeri
   const int deme_id = cell.GetDemeID();
   const cDeme& deme = deme_array[deme_id];
   m_scheduler->AdjustPriority(cell.GetID(), deme.HasDemeMerit() ? (merit.GetDouble() * deme.GetDemeMerit().GetDouble()) : merit.GetDouble());
+  
+  // Every birth, death, move, and merit change passes through here, so it doubles as the cell change notification
+  if (m_track_cell_changes) markCellChanged(cell.GetID());
+}
+
+inline void cPopulation::markCellChanged(int cell_id)
+{
+  if (m_cell_changed[cell_id]) return;
+  m_cell_changed[cell_id] = true;
+  m_changed_cells.Push(cell_id);
+}
+
+void cPopulation::SetCellChangeTracking(bool enabled)
+{
+  m_track_cell_changes = enabled;
+  m_cell_changed.Resize(enabled ? cell_array.GetSize() : 0);
+  m_cell_changed.SetAll(false);
+  m_changed_cells.Resize(0);
+}
+
+void cPopulation::ClearChangedCells()
+{
+  for (int i = 0; i < m_changed_cells.GetSize(); i++) m_cell_changed[m_changed_cells[i]] = false;
+  m_changed_cells.Resize(0);
 }
 
 
@@ -1914,6 +1944,18 @@ void cPopulation::SetTopNavQ()
   }
 }
 
+// Resolve the property once and read it straight out of every occupied cell; empty cells receive empty_value
+void cPopulation::GatherOrganismProperty(const PropertyID& prop_id, Apto::Array<double>& values, double empty_value)
+{
+  const cOrganism::PropertyAccessor accessor = cOrganism::ResolveProperty(prop_id);
+  
+  values.Resize(cell_array.GetSize());
+  for (int i = 0; i < cell_array.GetSize(); i++) {
+    cOrganism* org = cell_array[i].GetOrganism();
+    values[i] = (org) ? accessor.DoubleValue(org) : empty_value;
+  }
+}
+
 void cPopulation::AppendRecordReproQ(cOrganism* new_org) 
 { 
   repro_q.Push(new_org); 
@@ -5620,6 +5662,55 @@ void cPopulation::ProcessStep(cAvidaContext& ctx, double step_size, int cell_id)
 }
 
 
+// Execute up to max_steps consecutive instructions of the organism in cell_id.  The burst ends early if the organism
+// dies or leaves the cell.  Resource time, organism deletion, and implicit deme replication are all settled once at
+// the end of the burst rather than after every instruction.  Returns the number of time steps consumed.
+int cPopulation::ProcessBurst(cAvidaContext& ctx, double step_size, int cell_id, int max_steps)
+{
+  assert(step_size > 0.0);
+  assert(max_steps > 0);
+  assert(cell_id < cell_array.GetSize());
+  
+  // If cell_id is negative, no cell could be found -- the step is consumed without executing anything.
+  if (cell_id < 0) return 1;
+  
+  cPopulationCell& cell = GetCell(cell_id);
+  assert(cell.IsOccupied()); // Unoccupied cell getting processor time!
+  cOrganism* cur_org = cell.GetOrganism();
+  cHardwareBase* hw = cell.GetHardware();
+  cDeme& deme = GetDeme(cell.GetDemeID());
+  
+  int executed = 0;
+  while (executed < max_steps) {
+    hw->SingleProcess(ctx);
+    executed++;
+    
+    deme.IncTimeUsed(cur_org->GetPhenotype().GetMerit().GetDouble());
+    
+    if (cur_org->GetPhenotype().GetToDelete() || cell.GetOrganism() != cur_org) break;
+  }
+  
+  if (cur_org->GetPhenotype().GetToDelete() == true) {
+    cur_org->GetHardware().DeleteMiniTrace(print_mini_trace_reacs);
+    delete cur_org;
+  }
+  
+  m_world->GetStats().AddExecuted(executed);
+  resource_count.Update(step_size * executed);
+  
+  // These must be done even if there is only one deme.
+  for(int i = 0; i < GetNumDemes(); i++) {
+    GetDeme(i).Update(step_size * executed);
+  }
+  
+  if (GetNumDemes() >= 1) {
+    CheckImplicitDemeRepro(deme, ctx); 
+  }
+  
+  return executed;
+}
+
+
 void cPopulation::ProcessStepSpeculative(cAvidaContext& ctx, double step_size, int cell_id)
 {
   assert(step_size > 0.0);
@@ -6138,9 +6229,34 @@ void cPopulation::ProcessPostUpdate(cAvidaContext& ctx)
 
 void cPopulation::ProcessUpdateCellActions(cAvidaContext& ctx)
 {
-  for (int i = 0; i < cell_array.GetSize(); i++) {
-    if (cell_array[i].MutationRates().TestDeath(ctx)) KillOrganism(cell_array[i], ctx); 
+  const int num_cells = cell_array.GetSize();
+  if (num_cells == 0) return;
+  
+  if (!m_death_prob_checked) {
+    m_death_prob_uniform = true;
+    const double death_prob = cell_array[0].MutationRates().GetDeathProb();
+    for (int i = 1; i < num_cells && m_death_prob_uniform; i++) {
+      if (cell_array[i].MutationRates().GetDeathProb() != death_prob) m_death_prob_uniform = false;
+    }
+    m_death_prob_checked = true;
+  }
+  
+  const double death_prob = cell_array[0].MutationRates().GetDeathProb();
+  
+  // Cells with their own death probabilities, or deaths common enough that most cells get hit anyway, are tested one by one
+  if (!m_death_prob_uniform || death_prob > 0.1) {
+    for (int i = 0; i < num_cells; i++) {
+      if (cell_array[i].MutationRates().TestDeath(ctx)) KillOrganism(cell_array[i], ctx); 
+    }
+    return;
   }
+  if (death_prob == 0.0) return;
+  
+  // Otherwise only the cells that die are drawn, which gives each cell the same independent chance of death as testing
+  // every cell; they come back in cell order, as the full sweep would kill them
+  m_death_sampler.Sample(ctx.GetRandom(), num_cells, death_prob, m_death_cells);
+  
+  for (int i = 0; i < m_death_cells.GetSize(); i++) KillOrganism(cell_array[m_death_cells[i]], ctx);
 }
 
 
@@ -6791,7 +6907,7 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
       
       assert(tmp.bg->Properties().Has("genome"));
       Genome mg(tmp.bg->Properties().Get("genome"));
-      cOrganism* new_organism = new cOrganism(m_world, ctx, mg, -1, Systematics::Source(Systematics::DIVISION, (const char*)filename, true));
+      cOrganism* new_organism = new (m_world) cOrganism(m_world, ctx, mg, -1, Systematics::Source(Systematics::DIVISION, (const char*)filename, true));
       
       // Setup the phenotype...
       cPhenotype& phenotype = new_organism->GetPhenotype();
@@ -7258,7 +7374,7 @@ void cPopulation::InjectClone(int cell_id, cOrganism& orig_org, Systematics::Sou
   
   cAvidaContext& ctx = m_world->GetDefaultContext();
   
-  cOrganism* new_organism = new cOrganism(m_world, ctx, orig_org.GetGenome(), orig_org.GetPhenotype().GetGeneration(), src);
+  cOrganism* new_organism = new (m_world) cOrganism(m_world, ctx, orig_org.GetGenome(), orig_org.GetPhenotype().GetGeneration(), src);
   Systematics::UnitPtr unit(new_organism);
   new_organism->AddReference(); // creating new smart pointer to new_organism, explicitly add reference
   
@@ -7322,7 +7438,7 @@ void cPopulation::CompeteOrganisms_ConstructOffspring(int cell_id, cOrganism& pa
   Genome child_genome = parent.OffspringGenome();
   parent.GetHardware().Divide_TestFitnessMeasures(ctx);
   parent.OffspringGenome() = save_child;
-  cOrganism* new_organism = new cOrganism(m_world, ctx, child_genome, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DUPLICATION, ""));
+  cOrganism* new_organism = new (m_world) cOrganism(m_world, ctx, child_genome, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DUPLICATION, ""));
   
   // Classify the offspring
   Systematics::ConstParentGroupsPtr pgrps(new Systematics::ConstParentGroups(1));
@@ -7365,7 +7481,7 @@ void cPopulation::InjectGenome(int cell_id, Systematics::Source src, const Genom
   }
   
   
-  cOrganism* new_organism = new cOrganism(m_world, ctx, genome, -1, src);
+  cOrganism* new_organism = new (m_world) cOrganism(m_world, ctx, genome, -1, src);
   
   // Setup the phenotype...
   cPhenotype& phenotype = new_organism->GetPhenotype();
@@ -25,8 +25,11 @@
 
 #include "avida/data/Provider.h"
 
+#include "cBernoulliSampler.h"
 #include "cBirthChamber.h"
+#include "cCellArray.h"
 #include "cDeme.h"
+#include "cOccupancyIndex.h"
 #include "cOrgInterface.h"
 #include "cPopulationInterface.h"
 #include "cResourceCount.h"
@@ -66,7 +69,7 @@ private:
   // Components...
   cWorld* m_world;
   Apto::PriorityScheduler* m_scheduler;                // Handles allocation of CPU cycles
-  Apto::Array<cPopulationCell> cell_array;  // Local cells composing the population
+  cCellArray cell_array;                    // Local cells composing the population, indexed by cell id
   Apto::Array<int> empty_cell_id_array;     // Used for PREFER_EMPTY birth methods
   cResourceCount resource_count;       // Global resources available
   cBirthChamber birth_chamber;         // Global birth chamber.
@@ -80,6 +83,22 @@ private:
   // Keep list of live organisms
   Apto::Array<cOrganism*, Apto::Smart> live_org_list;
   
+  // Spatial occupancy indices, used to prune the look instruction walks
+  cOccupancyIndex m_org_occupancy;
+  cOccupancyIndex m_pred_av_occupancy;
+  cOccupancyIndex m_prey_av_occupancy;
+
+  // Per-cell death sampling: valid while every cell shares the same death probability
+  bool m_death_prob_checked;
+  bool m_death_prob_uniform;
+  cBernoulliSampler m_death_sampler;
+  Apto::Array<int> m_death_cells;
+  
+  // Cell change tracking: cells whose occupant, merit, or phenotype changed since the last ClearChangedCells()
+  bool m_track_cell_changes;
+  Apto::Array<bool> m_cell_changed;
+  Apto::Array<int> m_changed_cells;
+  
   Apto::Array<cPopulationOrgStatProviderPtr> m_org_stat_providers;
   
   
@@ -258,12 +277,14 @@ public:
   int ScheduleOrganism();          // Determine next organism to be processed.
   void ProcessStep(cAvidaContext& ctx, double step_size, int cell_id);
   void ProcessStepSpeculative(cAvidaContext& ctx, double step_size, int cell_id);
+  int ProcessBurst(cAvidaContext& ctx, double step_size, int cell_id, int max_steps);
 
   // Calculate the statistics from the most recent update.
   void ProcessPostUpdate(cAvidaContext& ctx);
   void ProcessPreUpdate();
   void UpdateResStats(cAvidaContext& ctx);
   void ProcessUpdateCellActions(cAvidaContext& ctx);
+  void CellDeathProbsChanged() { m_death_prob_checked = false; }
 
   // Clear all but a subset of cells...
   void SerialTransfer(int transfer_size, bool ignore_deads, cAvidaContext& ctx); 
@@ -294,6 +315,13 @@ public:
   void SetTopNavQ();
   Apto::Array<cOrganism*, Apto::Smart>& GetTopNavQ() { return topnav_q; }
   
+  void GatherOrganismProperty(const PropertyID& prop_id, Apto::Array<double>& values, double empty_value = 0.0);
+  
+  void SetCellChangeTracking(bool enabled);
+  bool GetCellChangeTracking() const { return m_track_cell_changes; }
+  const Apto::Array<int>& GetChangedCells() const { return m_changed_cells; }
+  void ClearChangedCells();
+  
   int GetSize() const { return cell_array.GetSize(); }
   int GetWorldX() const { return world_x; }
   int GetWorldY() const { return world_y; }
@@ -399,6 +427,10 @@ public:
   // Remove an org from live org list
   void RemoveLiveOrg(cOrganism* org); 
   const Apto::Array<cOrganism*, Apto::Smart>& GetLiveOrgList() const { return live_org_list; }
+  
+  cOccupancyIndex& GetOrgOccupancy() { return m_org_occupancy; }
+  cOccupancyIndex& GetPredAVOccupancy() { return m_pred_av_occupancy; }
+  cOccupancyIndex& GetPreyAVOccupancy() { return m_prey_av_occupancy; }
 	
   // Adds an organism to a group  
   void JoinGroup(cOrganism* org, int group_id);
@@ -488,6 +520,7 @@ private:
   int PlaceAvatar(cAvidaContext& ctx, cOrganism* parent);
   
   inline void AdjustSchedule(const cPopulationCell& cell, const cMerit& merit);
+  inline void markCellChanged(int cell_id);
   
   bool LoadGenotypeList(const cString& filename, cAvidaContext& ctx, Apto::Array<GeneticRepresentationPtr>& list_obj);
 };
@@ -267,6 +267,7 @@ void cPopulationCell::InsertOrganism(cOrganism* new_org, cAvidaContext& ctx)
   // Adjust this cell's attributes to account for the new organism.
   m_organism = new_org;
   m_hardware = &new_org->GetHardware();
+  m_world->GetPopulation().GetOrgOccupancy().Adjust(m_cell_id, 1);
   m_world->GetStats().AddSpeculativeWaste(m_spec_state);
   m_spec_state = 0;
 	
@@ -303,6 +304,7 @@ cOrganism * cPopulationCell::RemoveOrganism(cAvidaContext& ctx)
   }
   m_organism = NULL;
   m_hardware = NULL;
+  m_world->GetPopulation().GetOrgOccupancy().Adjust(m_cell_id, -1);
   return out_organism;
 }
 
@@ -330,6 +332,7 @@ double cPopulationCell::UptakeCellEnergy(double frac_to_uptake, cAvidaContext& c
 void cPopulationCell::AddPredAV(cAvidaContext& ctx, cOrganism* org)
 {
   m_av_pred.Push(org);
+  m_world->GetPopulation().GetPredAVOccupancy().Adjust(m_cell_id, 1);
   // Swaps the added avatar into a random position in the array
   int loc = ctx.GetRandom().GetUInt(0, m_av_pred.GetSize());
   cOrganism* exist_org = m_av_pred[loc];
@@ -342,6 +345,7 @@ void cPopulationCell::AddPredAV(cAvidaContext& ctx, cOrganism* org)
 void cPopulationCell::AddPreyAV(cAvidaContext& ctx, cOrganism* org)
 {
   m_av_prey.Push(org);
+  m_world->GetPopulation().GetPreyAVOccupancy().Adjust(m_cell_id, 1);
   // Swaps the added avatar into a random position in the array
   int loc = ctx.GetRandom().GetUInt(0, m_av_prey.GetSize());
   cOrganism* exist_org = m_av_prey[loc];
@@ -360,6 +364,7 @@ void cPopulationCell::RemovePredAV(cOrganism* org)
   exist_org->SetAVInIndex(org->GetAVInIndex());
   m_av_pred.Swap(org->GetAVInIndex(), last);
   m_av_pred.Pop();
+  m_world->GetPopulation().GetPredAVOccupancy().Adjust(m_cell_id, -1);
 }
 
 // Removes the organism from the cell's output avatars (prey)
@@ -372,6 +377,7 @@ void cPopulationCell::RemovePreyAV(cOrganism* org)
   exist_org->SetAVOutIndex(org->GetAVOutIndex());
   m_av_prey.Swap(org->GetAVOutIndex(), last);
   m_av_prey.Pop();
+  m_world->GetPopulation().GetPreyAVOccupancy().Adjust(m_cell_id, -1);
 }
 
 // Returns whether a cell has an output AV that the org will be able to receive messages from.
@@ -37,6 +37,7 @@
 #include "cPopulationCell.h"
 #include "cDeme.h"
 #include "cMigrationMatrix.h"
+#include "cObjectPool.h"
 #include "cStringUtil.h"
 #include "cWorld.h"
 #include "tDataEntry.h"
@@ -56,7 +57,7 @@ using namespace Avida;
 using namespace AvidaTools;
 
 
-cStats::cStats(cWorld* world)
+cStats::cStats(cWorld* world, bool provide_data)
 : m_world(world)
 , m_data_manager(this, "population_data")
 , m_num_genotypes(0)
@@ -257,7 +258,18 @@ cStats::cStats(cWorld* world)
   // End sense tracking initialization
   
   
-  setupProvidedData();
+  if (provide_data) setupProvidedData();
+}
+
+
+cStats* cStats::NewTestCPUSnapshot() const
+{
+  // The snapshot registers no data with the world, it only stands in for these stats on another thread
+  cStats* snapshot = new cStats(m_world, false);
+  snapshot->m_update = m_update;
+  snapshot->m_is_inst_names_map = m_is_inst_names_map;
+  snapshot->m_group_attack_names = m_group_attack_names;
+  return snapshot;
 }
 
 
@@ -2322,6 +2334,14 @@ void cStats::SetGroupAttackInstNames(const cString& inst_set) {
   }
 }
 
+Apto::Array<cString> cStats::GetGroupAttackInsts(const cString& inst_set) const
+{
+  // Looked up without inserting, an unknown instruction set has no attack instructions
+  Apto::Array<cString> names;
+  m_group_attack_names.Get(inst_set, names);
+  return names;
+}
+
 void cStats::PrintGroupAttackData(const cString& filename, const cString& inst_set) {
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
   
@@ -2434,6 +2454,34 @@ void cStats::PrintKilledPreyFTData(const cString& filename)
   df->Endl();
 }
 
+void cStats::PrintMemoryPoolData(const cString& filename)
+{
+  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
+  
+  df->WriteComment("Organism and hardware storage pool usage.");
+  df->WriteComment("Recycle rate is the fraction of all allocations served from released storage.");
+  df->WriteTimeStamp();
+  
+  df->Write(m_update, "Update");
+  
+  Apto::Array<const cObjectPool*> pools;
+  pools.Push(&m_world->GetOrganismPool());
+  cHardwareManager& hw_mgr = m_world->GetHardwareManager();
+  for (int i = 0; i < hw_mgr.GetNumHardwarePools(); i++) {
+    if (hw_mgr.GetHardwarePool(i)) pools.Push(hw_mgr.GetHardwarePool(i));
+  }
+  
+  for (int i = 0; i < pools.GetSize(); i++) {
+    const cObjectPool& pool = *pools[i];
+    const cString& name = pool.GetName();
+    df->Write(pool.GetNumLive(), cStringUtil::Stringf("%s live", (const char*)name));
+    df->Write(pool.GetNumFree(), cStringUtil::Stringf("%s free", (const char*)name));
+    df->Write((long)pool.GetTotalAllocations(), cStringUtil::Stringf("%s total allocations", (const char*)name));
+    df->Write(pool.GetRecycleRate(), cStringUtil::Stringf("%s recycle rate", (const char*)name));
+  }
+  df->Endl();
+}
+
 void cStats::PrintAttacks(const cString& filename)
 {
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
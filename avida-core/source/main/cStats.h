@@ -410,9 +410,12 @@ private:
   Genome topgenome;
     
 public:
-  cStats(cWorld* world);
+  cStats(cWorld* world, bool provide_data = true);
   ~cStats() { ; }
 
+  // Stats for a thread that runs test CPUs on its own, holding the state they read (update, instruction names)
+  cStats* NewTestCPUSnapshot() const;
+
   
   // Data::Provider
   Data::ConstDataSetPtr Provides() const;
@@ -645,6 +648,7 @@ public:
   void RecordDeath() { num_deaths++; }
 
   void IncExecuted() { num_executed++; }
+  void AddExecuted(int count) { num_executed += count; }
 
   void AddNumOrgsKilled(long num) { sum_orgs_killed.Add(num); }
 	void AddNumUnoccupiedCellAttemptedToKill(long num) { sum_unoccupied_cell_kill_attempts.Add(num); }
@@ -817,7 +821,7 @@ public:
   int GetNumTopPredCreatures() const;
   int GetNumTotalPredCreatures() const;
   void SetGroupAttackInstNames(const cString& inst_set);
-  Apto::Array<cString>& GetGroupAttackInsts(const cString& inst_set) { return m_group_attack_names[inst_set]; }
+  Apto::Array<cString> GetGroupAttackInsts(const cString& inst_set) const;
   
   // this value gets recorded when a creature with the particular
   // fitness value gets born. It will never change to a smaller value,
@@ -855,6 +859,7 @@ public:
   void PrintGroupAttackBits(unsigned char raw_bits);
   void PrintGroupAttackString(cString& raw_bits);
   void PrintKilledPreyFTData(const cString& filename);
+  void PrintMemoryPoolData(const cString& filename);
   void PrintAttacks(const cString& filename);
   void PrintBirthLocData(int org_idx);
   void PrintLookData(cString& string);
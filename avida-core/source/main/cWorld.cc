@@ -30,6 +30,7 @@
 #include "avida/systematics/Arbiter.h"
 #include "avida/systematics/Manager.h"
 
+#include "avida/private/systematics/GenomeTestQueue.h"
 #include "avida/private/systematics/GenotypeArbiter.h"
 
 #include "cAnalyze.h"
@@ -39,6 +40,8 @@
 #include "cHardwareManager.h"
 #include "cMigrationMatrix.h"  
 #include "cInstSet.h"
+#include "cObjectPool.h"
+#include "cOrganism.h"
 #include "cPopulation.h"
 #include "cStats.h"
 #include "cTestCPU.h"
@@ -49,9 +52,12 @@
 using namespace AvidaTools;
 
 
+OBJECT_POOL_THREAD_LOCAL cStats* cWorld::s_thread_stats = NULL;
+
+
 cWorld::cWorld(cAvidaConfig* cfg, const cString& wd)
   : m_working_dir(wd), m_analyze(NULL), m_conf(cfg), m_ctx(NULL)
-  , m_env(NULL), m_event_list(NULL), m_hw_mgr(NULL), m_pop(NULL), m_stats(NULL), m_mig_mat(NULL), m_driver(NULL), m_data_mgr(NULL)
+  , m_env(NULL), m_event_list(NULL), m_hw_mgr(NULL), m_org_pool(NULL), m_genome_tests(NULL), m_pop(NULL), m_stats(NULL), m_mig_mat(NULL), m_driver(NULL), m_data_mgr(NULL)
   , m_own_driver(false)
 {
 }
@@ -71,14 +77,27 @@ cWorld::~cWorld()
   // m_actlib is not owned by cWorld, DO NOT DELETE
   
   // These must be deleted first
+  if (m_genome_tests) {
+    Systematics::Manager::Of(m_new_world)->ArbiterForRole("genotype")->DetachListener(m_genome_tests);
+    delete m_genome_tests;
+    m_genome_tests = NULL;
+  }
   delete m_analyze; m_analyze = NULL;
   
+  // The data manager holds the population as a provider, so release it first; otherwise the population (and the
+  // organisms and hardware it owns) would outlive the pools below that they are allocated from
+  if (m_new_world) {
+    Data::ManagerPtr data_mgr = Data::Manager::Of(m_new_world);
+    if (data_mgr) data_mgr->ReleaseProviders();
+  }
+  
   // Forcefully clean up population before classification manager
   m_pop = Apto::SmartPtr<cPopulation, Apto::InternalRCObject>();
   
   delete m_env; m_env = NULL;
   delete m_event_list; m_event_list = NULL;
   delete m_hw_mgr; m_hw_mgr = NULL;
+  delete m_org_pool; m_org_pool = NULL;
 
   delete m_mig_mat; 
   
@@ -108,6 +127,7 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
     // Data Manager
     m_data_mgr = Data::ManagerPtr(new Data::Manager);
     m_data_mgr->AttachTo(new_world);
+    m_data_mgr->SetConcurrentNotification(m_conf->CONCURRENT_DATA_RECORDING.Get());
     
     // Environment
     Environment::ManagerPtr(new Environment::Manager)->AttachTo(new_world);
@@ -153,6 +173,9 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
   Data::Manager::Of(m_new_world)->AttachRecorder(m_stats);
 
   
+  // Organism storage is recycled through a per-world pool (hardware pools are owned by the hardware manager)
+  m_org_pool = new cObjectPool("organism", sizeof(cOrganism), m_conf->POOL_ALLOCATION.Get());
+  
   // Initialize the hardware manager, loading all of the instruction sets
   m_hw_mgr = new cHardwareManager(this);
   if (m_conf->INST_SET_LOAD_LEGACY.Get()) {
@@ -193,6 +216,12 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
   const bool sterilize_taskloss = m_conf->STERILIZE_TASKLOSS.Get() > 0.0;
   m_test_sterilize = (sterilize_fatal || sterilize_neg || sterilize_neut || sterilize_pos || sterilize_taskloss);
 
+  // Threshold genotypes may be evaluated on test CPUs in the background, ahead of any request for their metrics
+  if (m_conf->THRESHOLD_TEST_THREADS.Get() > 0) {
+    m_genome_tests = new Systematics::GenomeTestQueue(this, m_conf->THRESHOLD_TEST_THREADS.Get());
+    systematics->ArbiterForRole("genotype")->AttachListener(m_genome_tests);
+  }
+  
   m_pop = Apto::SmartPtr<cPopulation, Apto::InternalRCObject>(new cPopulation(this));
   
   // Setup Event List
@@ -29,6 +29,7 @@
 
 #include "cAvidaConfig.h"
 #include "cAvidaContext.h"
+#include "cObjectPool.h"
 
 #include <cassert>
 
@@ -38,6 +39,7 @@ class cEnvironment;
 class cEventList;
 class cHardwareManager;
 class cMigrationMatrix; 
+class cObjectPool;
 class cOrganism;
 class cPopulation;
 class cMerit;
@@ -47,6 +49,12 @@ class cTestCPU;
 class cUserFeedback;
 template<class T> class tDataEntry;
 
+namespace Avida {
+  namespace Systematics {
+    class GenomeTestQueue;
+  };
+};
+
 using namespace Avida;
 
 
@@ -62,6 +70,8 @@ protected:
   cEnvironment* m_env;
   cEventList* m_event_list;
   cHardwareManager* m_hw_mgr;
+  cObjectPool* m_org_pool;
+  Systematics::GenomeTestQueue* m_genome_tests;
   Apto::SmartPtr<cPopulation, Apto::InternalRCObject> m_pop;
   Apto::SmartPtr<cStats, Apto::InternalRCObject> m_stats;
   cMigrationMatrix* m_mig_mat;  
@@ -75,6 +85,8 @@ protected:
   bool m_test_sterilize;  // flag derived from a collection of configuration settings
   
   bool m_own_driver;      // specifies whether this world object should manage its driver object
+  
+  static OBJECT_POOL_THREAD_LOCAL cStats* s_thread_stats;  // Stands in for m_stats on a test CPU worker thread
 
   cWorld(cAvidaConfig* cfg, const cString& wd);
   
@@ -93,15 +105,21 @@ public:
   cAvidaContext& GetDefaultContext() { return *m_ctx; }
   cEnvironment& GetEnvironment() { return *m_env; }
   cHardwareManager& GetHardwareManager() { return *m_hw_mgr; }
+  cObjectPool& GetOrganismPool() { return *m_org_pool; }
+  Systematics::GenomeTestQueue* GetGenomeTestQueue() { return m_genome_tests; }  // NULL unless enabled
   cMigrationMatrix& GetMigrationMatrix(){ return *m_mig_mat; };
   cPopulation& GetPopulation() { return *m_pop; }
   Apto::Random& GetRandom() { return m_rng; }
-  cStats& GetStats() { return *m_stats; }
+  cStats& GetStats() { return (s_thread_stats) ? *s_thread_stats : *m_stats; }
   WorldDriver& GetDriver() { return *m_driver; }
   World* GetNewWorld() { return m_new_world; }
   
   Data::ManagerPtr& GetDataManager() { return m_data_mgr; }
   
+  // Stats returned by GetStats() on the calling thread only, so that a thread running test CPUs off the simulation
+  // thread never reads or writes the live stats (NULL restores them)
+  static void SetThreadStats(cStats* stats) { s_thread_stats = stats; }
+  
   Data::ProviderPtr GetStatsProvider(World*);
   Data::ArgumentedProviderPtr GetPopulationProvider(World*);
   
@@ -24,6 +24,7 @@
 #include "avida/private/systematics/GenomeTestMetrics.h"
 
 #include "avida/core/Genome.h"
+#include "avida/private/systematics/GenomeTestQueue.h"
 
 #include "cAvidaContext.h"
 #include "cHardwareManager.h"
@@ -35,12 +36,10 @@ const Apto::String Avida::Systematics::GenomeTestMetrics::ObjectKey("Avida::Syst
 
 
 
-Avida::Systematics::GenomeTestMetrics::GenomeTestMetrics(cWorld* world, cAvidaContext& ctx, GroupPtr g)
+Avida::Systematics::GenomeTestMetrics::GenomeTestMetrics(cAvidaContext& ctx, cTestCPU* testcpu, const Genome& genome)
 {
-  Apto::SmartPtr<cTestCPU> testcpu(world->GetHardwareManager().CreateTestCPU(ctx));
-  
   cCPUTestInfo test_info;
-  testcpu->TestGenome(ctx, test_info, Genome(g->Properties().Get("genome").StringValue()));
+  testcpu->TestGenome(ctx, test_info, genome);
   
   m_is_viable = test_info.IsViable();
   
@@ -70,7 +69,15 @@ Avida::Systematics::GenomeTestMetricsPtr Avida::Systematics::GenomeTestMetrics::
 {
   GenomeTestMetricsPtr metrics = g->GetData<GenomeTestMetrics>();
   if (!metrics && g->Properties().Has("genome")) {
-    metrics = GenomeTestMetricsPtr(new GenomeTestMetrics(world, ctx, g));
+    // With background evaluation on, the queue evaluates every genotype (waiting only on that genotype if it is running)
+    GenomeTestQueue* queue = world->GetGenomeTestQueue();
+    if (queue) {
+      metrics = queue->Claim(g);
+    } else {
+      cTestCPU* testcpu = world->GetHardwareManager().CreateTestCPU(ctx);
+      metrics = GenomeTestMetricsPtr(new GenomeTestMetrics(ctx, testcpu, Genome(g->Properties().Get("genome").StringValue())));
+      delete testcpu;
+    }
     assert(metrics);
     g->AttachData(metrics);
   }
@@ -0,0 +1,220 @@
+/*
+ *  systematics/GenomeTestQueue.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/private/systematics/GenomeTestQueue.h"
+
+#include "apto/core/Thread.h"
+#include "avida/core/WorldDriver.h"
+
+#include "avida/private/systematics/GenotypeArbiter.h"
+
+#include "cAvidaContext.h"
+#include "cHardwareManager.h"
+#include "cStats.h"
+#include "cTestCPU.h"
+#include "cWorld.h"
+
+
+class Avida::Systematics::GenomeTestQueue::Worker : public Apto::Thread
+{
+private:
+  GenomeTestQueue* m_queue;
+  cStats* m_stats;
+
+  void Run();
+
+public:
+  // The stats snapshot is taken here, on the simulation thread
+  Worker(GenomeTestQueue* queue) : m_queue(queue), m_stats(queue->m_world->GetStats().NewTestCPUSnapshot()) { ; }
+  ~Worker() { delete m_stats; }
+};
+
+
+Avida::Systematics::GenomeTestQueue::GenomeTestQueue(cWorld* world, int num_workers)
+  : m_world(world), m_seed_rng(world->GetConfig().RANDOM_SEED.Get()), m_next_waiting(0), m_stopping(false)
+  , m_workers(num_workers)
+{
+  // Job seeds come from their own generator, so that queueing never draws on the world's random number stream
+  for (int i = 0; i < m_workers.GetSize(); i++) {
+    m_workers[i] = new Worker(this);
+    m_workers[i]->Start();
+  }
+}
+
+Avida::Systematics::GenomeTestQueue::~GenomeTestQueue()
+{
+  m_mutex.Lock();
+  m_stopping = true;
+  m_job_cond.Broadcast();
+  m_mutex.Unlock();
+
+  for (int i = 0; i < m_workers.GetSize(); i++) {
+    m_workers[i]->Join();
+    delete m_workers[i];
+  }
+
+  for (Apto::Map<GroupID, Job*>::ValueIterator it = m_jobs.Values(); it.Next();) {
+    delete (*it.Get())->result;
+    delete *it.Get();
+  }
+}
+
+
+void Avida::Systematics::GenomeTestQueue::Notify(GroupPtr g, EventType t, UnitPtr)
+{
+  Collect();
+
+  if (t != GenotypeArbiter::EVENT_ADD_THRESHOLD || !g->Properties().Has("genome")) return;
+  if (g->GetData<GenomeTestMetrics>()) return;
+
+  Apto::MutexAutoLock lock(m_mutex);
+  if (m_jobs.Has(g->ID())) return;
+
+  const int seed = m_seed_rng.GetInt(m_seed_rng.MaxSeed());
+  const int update = m_world->GetStats().GetUpdate();
+  m_jobs.Set(g->ID(), new Job(g, Genome(g->Properties().Get("genome").StringValue()), seed, update));
+  m_waiting.Push(g->ID());
+  m_job_cond.Signal();
+}
+
+
+void Avida::Systematics::GenomeTestQueue::Collect()
+{
+  Apto::Array<Job*> finished;
+
+  m_mutex.Lock();
+  for (int i = 0; i < m_finished.GetSize(); i++) {
+    Job* job = NULL;
+    if (m_jobs.Get(m_finished[i], job)) {
+      finished.Push(job);
+      m_jobs.Remove(m_finished[i]);
+    }
+  }
+  m_finished.Resize(0);
+  m_mutex.Unlock();
+
+  for (int i = 0; i < finished.GetSize(); i++) {
+    finished[i]->group->AttachData(GenomeTestMetricsPtr(finished[i]->result));
+    delete finished[i];
+  }
+}
+
+
+Avida::Systematics::GenomeTestMetricsPtr Avida::Systematics::GenomeTestQueue::Claim(GroupPtr g)
+{
+  int seed = 0;
+  
+  m_mutex.Lock();
+  Job* job = NULL;
+  if (m_jobs.Get(g->ID(), job)) {
+    m_jobs.Remove(g->ID());  // Any entry left in m_waiting or m_finished is skipped once the job is gone
+    
+    if (job->started) {
+      while (!job->result) m_done_cond.Wait(m_mutex);
+      m_mutex.Unlock();
+      
+      GenomeTestMetricsPtr metrics(job->result);
+      delete job;
+      return metrics;
+    }
+    
+    seed = job->seed;
+    delete job;
+  } else {
+    seed = m_seed_rng.GetInt(m_seed_rng.MaxSeed());
+  }
+  m_mutex.Unlock();
+
+  // Not started by any worker, evaluate here on the simulation thread (and so against the live stats)
+  return GenomeTestMetricsPtr(evaluate(seed, Genome(g->Properties().Get("genome").StringValue())));
+}
+
+
+Avida::Systematics::GenomeTestMetrics* Avida::Systematics::GenomeTestQueue::evaluate(cAvidaContext& ctx, cTestCPU* testcpu,
+                                                                                   const Genome& genome)
+{
+  return new GenomeTestMetrics(ctx, testcpu, genome);
+}
+
+
+Avida::Systematics::GenomeTestMetrics* Avida::Systematics::GenomeTestQueue::evaluate(int seed, const Genome& genome)
+{
+  Apto::RNG::AvidaRNG rng(seed);
+  cAvidaContext ctx(NULL, rng);
+  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  
+  GenomeTestMetrics* metrics = evaluate(ctx, testcpu, genome);
+  
+  delete testcpu;
+  return metrics;
+}
+
+
+Avida::Systematics::GenomeTestQueue::Job* Avida::Systematics::GenomeTestQueue::nextJob()
+{
+  // Must be called with the mutex held
+  while (true) {
+    while (m_next_waiting < m_waiting.GetSize()) {
+      Job* job = NULL;
+      const GroupID group_id = m_waiting[m_next_waiting++];
+      if (m_jobs.Get(group_id, job) && !job->started) {
+        job->started = true;
+        return job;
+      }
+    }
+    m_waiting.Resize(0);
+    m_next_waiting = 0;
+
+    if (m_stopping) return NULL;
+    m_job_cond.Wait(m_mutex);
+  }
+}
+
+
+void Avida::Systematics::GenomeTestQueue::Worker::Run()
+{
+  cWorld* world = m_queue->m_world;
+  cWorld::SetThreadStats(m_stats);
+
+  Apto::RNG::AvidaRNG rng;
+  cAvidaContext ctx(NULL, rng);
+  cTestCPU* testcpu = world->GetHardwareManager().CreateTestCPU(ctx);
+
+  m_queue->m_mutex.Lock();
+  Job* job = NULL;
+  while ((job = m_queue->nextJob())) {
+    m_queue->m_mutex.Unlock();
+
+    // A started job is never deleted before its result is in, so it is safe to use unlocked
+    rng.ResetSeed(job->seed);
+    m_stats->SetCurrentUpdate(job->update);
+    GenomeTestMetrics* result = evaluate(ctx, testcpu, job->genome);
+
+    m_queue->m_mutex.Lock();
+    job->result = result;
+    m_queue->m_finished.Push(job->group->ID());
+    m_queue->m_done_cond.Broadcast();
+  }
+  m_queue->m_mutex.Unlock();
+
+  delete testcpu;
+  cWorld::SetThreadStats(NULL);
+}
@@ -470,13 +470,7 @@ void Avida::Systematics::GenotypeArbiter::setupProvidedData(World* world)
 
 unsigned int Avida::Systematics::GenotypeArbiter::hashGenome(const InstructionSequence& genome) const
 {
-  unsigned int total = 0;
-  
-  for (int i = 0; i < genome.GetSize(); i++) {
-    total += (genome[i].GetOp() + 3) * i;
-  }
-  
-  return total % HASH_SIZE;
+  return (unsigned int)(genome.Hash() % HASH_SIZE);
 }
 
 Apto::String Avida::Systematics::GenotypeArbiter::nameGenotype(int size)
@@ -85,6 +85,9 @@ void Avida2Driver::Run()
     ActiveProcessStep = &cPopulation::ProcessStepSpeculative;
   }
   
+  // Burst execution replaces per-instruction interleaving (and speculative execution) when BURST_SIZE > 1
+  const int burst_size = m_world->GetConfig().BURST_SIZE.Get();
+  
   cAvidaContext& ctx = m_world->GetDefaultContext();
   Avida::Context new_ctx(this, &m_world->GetRandom());
   
@@ -108,11 +111,21 @@ void Avida2Driver::Run()
     const int UD_size = m_world->CalculateUpdateSize();
     const double step_size = 1.0 / (double) UD_size;
     
-    for (int i = 0; i < UD_size; i++) {
-      if(population.GetNumOrganisms() == 0) {
-        break;
+    if (burst_size > 1) {
+      for (int i = 0; i < UD_size;) {
+        if(population.GetNumOrganisms() == 0) {
+          break;
+        }
+        const int max_steps = (UD_size - i < burst_size) ? (UD_size - i) : burst_size;
+        i += population.ProcessBurst(ctx, step_size, population.ScheduleOrganism(), max_steps);
+      }
+    } else {
+      for (int i = 0; i < UD_size; i++) {
+        if(population.GetNumOrganisms() == 0) {
+          break;
+        }
+        (population.*ActiveProcessStep)(ctx, step_size, population.ScheduleOrganism());
       }
-      (population.*ActiveProcessStep)(ctx, step_size, population.ScheduleOrganism());
     }
     
     // end of update stats...
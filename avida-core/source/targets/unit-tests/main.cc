@@ -19,6 +19,9 @@
  *
  */
 
+#include <cmath>
+#include <cstring>
+#include <ctime>
 #include <iostream>
 #include <iomanip>
 
@@ -266,6 +269,21 @@ protected:
     bit_array9.SHIFT(66, -65);
     ReportTestResult("Shift Right (multiple bit fields)", (bit_array9.GetBit(0) && bit_array9.CountBits(66) == 1));
     
+    
+    cRawBitArray bit_array12(130);
+    bit_array12.SetBit(0, true);
+    bit_array12.SetBit(59, true);
+    bit_array12.SetBit(64, true);
+    
+    bit_array12.SHIFT(130, 70);
+    ReportTestResult("Shift Left (partial field past end)",
+                     (bit_array12.GetBit(70) && bit_array12.GetBit(129) && bit_array12.CountBits(130) == 2));
+    
+    
+    bit_array12.SHIFT(130, -70);
+    ReportTestResult("Shift Right (partial field past end)",
+                     (bit_array12.GetBit(0) && bit_array12.GetBit(59) && bit_array12.CountBits(130) == 2));
+    
     // INCREMENT
     
     cRawBitArray bit_array10(1);
@@ -308,6 +326,460 @@ protected:
     ReportTestResult("Chained Bitwise Operations", ((~ba & ~ba2).CountBits() == 31));
     ReportTestResult("++operator", ((++(~ba & ~ba2)).CountBits() == 30));
     ReportTestResult("operator++", (((~ba & ~ba2)++).CountBits() == 31));
+    ReportTestResult("ANDNOT", (ba.ANDNOT(ba2).CountBits() == 7 && (ba.ANDNOT(ba2) | (ba & ba2)) == ba));
+    ReportTestResult("CountBitsAND", (ba.CountBitsAND(ba2) == (ba & ba2).CountBits() && ba.CountBitsAND(ba) == 15));
+    
+    bool result = true;
+    Apto::Array<int> ones = ba.GetOnes();
+    int pos = ba.FindBit1();
+    for (int i = 0; i < ones.GetSize(); i++) {
+      if (ones[i] != pos || ones[i] % 5 != 3) result = false;
+      pos = ba.FindBit1(pos + 1);
+    }
+    ReportTestResult("FindBit1 / GetOnes", (result && pos == -1 && ones.GetSize() == 15));
+    
+    // Crossing the in-object storage limit (256 bits) in both directions
+    cBitArray ba3(ba);
+    ba3.Resize(300);
+    ba3[299] = true;
+    result = (ba3.CountBits() == 16 && ba3.FindBit1(74) == 299);
+    ba3.Resize(74);
+    ReportTestResult("Resize (large and back)", (result && ba3 == ba));
+    
+    cBitArray ba4(1000);
+    for (int i = 0; i < 1000; i += 7) ba4[i] = true;
+    cBitArray ba5(1000);
+    ba5.SetAll();
+    ReportTestResult("Large arrays", ((ba4 & ba5) == ba4 && (~ba4).CountBits() == 1000 - 143 && ba5.CountBits() == 1000 &&
+                                      ba4.CountBitsAND(ba5) == 143));
+  }
+};
+
+
+
+#include "avida/core/InstructionSequence.h"
+#include "apto/rng.h"
+#include "cAvidaContext.h"
+#include "cCPUMemory.h"
+#include "cHardwareBase.h"
+
+using namespace Avida;
+
+class cInstructionSequenceTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "InstructionSequence"; }
+protected:
+  void RunTests()
+  {
+    InstructionSequence alpha1("abcdefghijklmnopqrstuvwxyz");
+    InstructionSequence alpha2("abcdefghijklmnopqrstuvwxyz");
+    InstructionSequence alpha3("abcdefghijklmnopqrstuvwxyA");
+    ReportTestResult("operator==", (alpha1 == alpha2 && !(alpha1 == alpha3)));
+    ReportTestResult("Hash", (alpha1.Hash() == alpha2.Hash() && alpha1.Hash() != alpha3.Hash()));
+    
+    // operator< must order sequences exactly as their symbol strings compare
+    const char* symbols[] = { "abc", "abcd", "abC", "ab0", "ab+a", "ab-a", "ab~a", "ab?a", "ab_", "b", "" };
+    const int num_symbols = sizeof(symbols) / sizeof(symbols[0]);
+    bool result = true;
+    for (int i = 0; i < num_symbols; i++) {
+      for (int j = 0; j < num_symbols; j++) {
+        InstructionSequence sym1((Apto::String(symbols[i])));
+        InstructionSequence sym2((Apto::String(symbols[j])));
+        if ((sym1.AsString() < sym2.AsString()) != (sym1 < sym2)) result = false;
+      }
+    }
+    ReportTestResult("operator< (matches AsString ordering)", result);
+    
+    InstructionSequence prefix1("aaaaaaaaaaaabbbbbbbbbbbbbcccccccccc");
+    InstructionSequence prefix2("aaaaaaaaaaaadbbbbbbbbbbbbdcccccccccc");
+    ReportTestResult("CommonPrefixLength / CommonSuffixLength",
+                     (InstructionSequence::CommonPrefixLength(prefix1, prefix2) == 12 &&
+                      InstructionSequence::CommonSuffixLength(prefix1, prefix2) == 10 &&
+                      InstructionSequence::CommonPrefixLength(prefix1, prefix1) == prefix1.GetSize()));
+    
+    alpha2[3] = Instruction(0);
+    alpha2[11] = Instruction(0);
+    alpha2[25] = Instruction(0);
+    ReportTestResult("FindHammingDistance / CountMismatches",
+                     (InstructionSequence::FindHammingDistance(alpha1, alpha2) == 3 &&
+                      InstructionSequence::CountMismatches(alpha1, 0, alpha2, 0, alpha1.GetSize()) == 3 &&
+                      InstructionSequence::CountMismatches(alpha1, 8, alpha2, 8, 8) == 1));
+    
+    
+    InstructionSequence base(40);
+    for (int i = 0; i < base.GetSize(); i++) base[i] = Instruction(i);
+    
+    // Batch insertion must match inserting one site at a time, working backwards from the end of the list
+    const int ins_sites[] = { 0, 3, 3, 3, 17, 39, 40, 40 };
+    const int num_ins = sizeof(ins_sites) / sizeof(int);
+    Apto::Array<int> positions(num_ins);
+    Apto::Array<Instruction> insts(num_ins);
+    for (int i = 0; i < num_ins; i++) {
+      positions[i] = ins_sites[i];
+      insts[i] = Instruction(100 + i);
+    }
+    
+    InstructionSequence seq1(base);
+    seq1.InsertSorted(positions, insts);
+    InstructionSequence seq2(base);
+    for (int i = num_ins - 1; i >= 0; i--) seq2.Insert(positions[i], insts[i]);
+    ReportTestResult("InsertSorted (duplicate positions)", (seq1.GetSize() == base.GetSize() + num_ins && seq1 == seq2));
+    
+    // Batch removal must match removing the same sites one at a time, from the end of the list
+    const int del_sites[] = { 0, 1, 5, 20, 38, 39 };
+    const int num_del = sizeof(del_sites) / sizeof(int);
+    positions.Resize(num_del);
+    for (int i = 0; i < num_del; i++) positions[i] = del_sites[i];
+    
+    seq1 = base;
+    seq1.RemoveSorted(positions);
+    seq2 = base;
+    for (int i = num_del - 1; i >= 0; i--) seq2.Remove(positions[i]);
+    ReportTestResult("RemoveSorted", (seq1.GetSize() == base.GetSize() - num_del && seq1 == seq2));
+    
+    positions.Resize(0);
+    insts.Resize(0);
+    seq1 = base;
+    seq1.InsertSorted(positions, insts);
+    seq1.RemoveSorted(positions);
+    ReportTestResult("InsertSorted / RemoveSorted (no sites)", (seq1 == base));
+    
+    // Random insertion site sets, which routinely contain repeats in a short sequence
+    result = true;
+    Apto::RNG::AvidaRNG rng(101);
+    for (int trial = 0; trial < 200 && result; trial++) {
+      InstructionSequence short_base(5 + trial % 7);
+      for (int i = 0; i < short_base.GetSize(); i++) short_base[i] = Instruction(i);
+      const int num_sites = 1 + trial % 9;
+      positions.Resize(num_sites);
+      insts.Resize(num_sites);
+      for (int i = 0; i < num_sites; i++) positions[i] = rng.GetUInt(short_base.GetSize() + 1);
+      Apto::QSort(positions);
+      for (int i = 0; i < num_sites; i++) insts[i] = Instruction(100 + i);
+      
+      seq1 = short_base;
+      seq1.InsertSorted(positions, insts);
+      seq2 = short_base;
+      for (int i = num_sites - 1; i >= 0; i--) seq2.Insert(positions[i], insts[i]);
+      if (!(seq1 == seq2)) result = false;
+    }
+    ReportTestResult("InsertSorted (random sites)", result);
+  }
+};
+
+class cCPUMemoryTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cCPUMemory"; }
+protected:
+  static bool flagsMatch(const cCPUMemory& mem1, const cCPUMemory& mem2)
+  {
+    if (mem1.GetSize() != mem2.GetSize()) return false;
+    for (int i = 0; i < mem1.GetSize(); i++) {
+      if (mem1.FlagCopied(i) != mem2.FlagCopied(i) || mem1.FlagMutated(i) != mem2.FlagMutated(i) ||
+          mem1.FlagExecuted(i) != mem2.FlagExecuted(i)) return false;
+    }
+    return true;
+  }
+  
+  void RunTests()
+  {
+    cCPUMemory base(30);
+    for (int i = 0; i < base.GetSize(); i++) {
+      base.SetInst(i, Instruction(i));
+      if (i % 2 == 0) base.SetFlagCopied(i);
+      if (i % 3 == 0) base.SetFlagExecuted(i);
+    }
+    
+    const int ins_sites[] = { 0, 0, 4, 4, 4, 29, 30 };
+    const int num_ins = sizeof(ins_sites) / sizeof(int);
+    Apto::Array<int> positions(num_ins);
+    Apto::Array<Instruction> insts(num_ins);
+    for (int i = 0; i < num_ins; i++) {
+      positions[i] = ins_sites[i];
+      insts[i] = Instruction(100 + i);
+    }
+    
+    cCPUMemory mem1(base);
+    mem1.InsertSorted(positions, insts);
+    cCPUMemory mem2(base);
+    for (int i = num_ins - 1; i >= 0; i--) mem2.Insert(positions[i], insts[i]);
+    ReportTestResult("InsertSorted (duplicate positions)", (mem1 == mem2 && flagsMatch(mem1, mem2)));
+    
+    const int del_sites[] = { 0, 2, 3, 4, 28, 29 };
+    const int num_del = sizeof(del_sites) / sizeof(int);
+    positions.Resize(num_del);
+    for (int i = 0; i < num_del; i++) positions[i] = del_sites[i];
+    
+    mem1 = base;
+    mem1.RemoveSorted(positions);
+    mem2 = base;
+    for (int i = num_del - 1; i >= 0; i--) mem2.Remove(positions[i]);
+    ReportTestResult("RemoveSorted", (mem1 == mem2 && flagsMatch(mem1, mem2)));
+  }
+};
+
+class cHardwareBaseTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cHardwareBase"; }
+protected:
+  void RunTests()
+  {
+    // SelectDeletionSites followed by RemoveSorted must leave the same offspring as the same number of successive
+    // single site deletions drawn from the same random number stream
+    bool result = true;
+    for (int trial = 0; trial < 200 && result; trial++) {
+      InstructionSequence base(10 + trial % 50);
+      for (int i = 0; i < base.GetSize(); i++) base[i] = Instruction(i);
+      const int num_del = 1 + trial % (base.GetSize() - 1);
+      
+      Apto::RNG::AvidaRNG rng1(trial);
+      cAvidaContext ctx1(NULL, rng1);
+      Apto::Array<int> sites;
+      cHardwareBase::SelectDeletionSites(ctx1, base.GetSize(), num_del, sites);
+      InstructionSequence seq1(base);
+      seq1.RemoveSorted(sites);
+      
+      Apto::RNG::AvidaRNG rng2(trial);
+      cAvidaContext ctx2(NULL, rng2);
+      InstructionSequence seq2(base);
+      for (int i = 0; i < num_del; i++) seq2.Remove(ctx2.GetRandom().GetUInt(seq2.GetSize()));
+      
+      for (int i = 1; i < sites.GetSize(); i++) if (sites[i - 1] >= sites[i]) result = false;
+      if (sites.GetSize() != num_del || !(seq1 == seq2)) result = false;
+    }
+    ReportTestResult("SelectDeletionSites (matches successive Remove)", result);
+  }
+};
+
+
+#include "cCellArray.h"
+
+class cCellArrayTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cCellArray"; }
+protected:
+  static bool isPermutation(const Apto::Array<int>& order, int num_cells)
+  {
+    if (order.GetSize() != num_cells) return false;
+    Apto::Array<int> seen(num_cells);
+    seen.SetAll(0);
+    for (int i = 0; i < order.GetSize(); i++) {
+      if (order[i] < 0 || order[i] >= num_cells || seen[order[i]]++) return false;
+    }
+    return true;
+  }
+  
+  void RunTests()
+  {
+    // Every ordering must visit each cell exactly once, including non-square and non power of two worlds
+    const int sizes[][2] = { {1, 1}, {2, 2}, {3, 5}, {7, 4}, {8, 8}, {60, 60}, {100, 33} };
+    const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    bool result = true;
+    for (int i = 0; i < num_sizes; i++) {
+      const int num_cells = sizes[i][0] * sizes[i][1];
+      if (!isPermutation(cCellArray::CurveOrder(sizes[i][0], sizes[i][1], cCellArray::ROW_MAJOR), num_cells) ||
+          !isPermutation(cCellArray::CurveOrder(sizes[i][0], sizes[i][1], cCellArray::MORTON), num_cells) ||
+          !isPermutation(cCellArray::CurveOrder(sizes[i][0], sizes[i][1], cCellArray::HILBERT), num_cells)) {
+        result = false;
+      }
+    }
+    ReportTestResult("CurveOrder (permutation)", result);
+    
+    Apto::Array<int> order = cCellArray::CurveOrder(5, 3, cCellArray::ROW_MAJOR);
+    result = true;
+    for (int i = 0; i < order.GetSize(); i++) if (order[i] != i) result = false;
+    ReportTestResult("CurveOrder (row-major)", result);
+    
+    // Z-order over a 4x4 grid, cell id = y * 4 + x
+    const int morton[] = { 0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15 };
+    order = cCellArray::CurveOrder(4, 4, cCellArray::MORTON);
+    result = true;
+    for (int i = 0; i < 16; i++) if (order[i] != morton[i]) result = false;
+    ReportTestResult("CurveOrder (Morton 4x4)", result);
+    
+    const int hilbert[] = { 0, 1, 5, 4, 8, 12, 13, 9, 10, 14, 15, 11, 7, 6, 2, 3 };
+    order = cCellArray::CurveOrder(4, 4, cCellArray::HILBERT);
+    result = true;
+    for (int i = 0; i < 16; i++) if (order[i] != hilbert[i]) result = false;
+    ReportTestResult("CurveOrder (Hilbert 4x4)", result);
+    
+    // On power of two squares, successive Hilbert cells are always grid neighbors
+    result = true;
+    for (int side = 2; side <= 64; side *= 2) {
+      order = cCellArray::CurveOrder(side, side, cCellArray::HILBERT);
+      for (int i = 1; i < order.GetSize(); i++) {
+        const int dx = order[i] % side - order[i - 1] % side;
+        const int dy = order[i] / side - order[i - 1] / side;
+        if (dx * dx + dy * dy != 1) result = false;
+      }
+    }
+    ReportTestResult("CurveOrder (Hilbert adjacency)", result);
+    
+    // Cells must be stored in curve order, while still being looked up by row-major id
+    cCellArray cells;
+    cells.ResizeClear(6, 5, cCellArray::HILBERT);
+    order = cCellArray::CurveOrder(6, 5, cCellArray::HILBERT);
+    result = (cells.GetSize() == 30);
+    for (int i = 1; i < order.GetSize(); i++) if (&cells[order[i]] != &cells[order[i - 1]] + 1) result = false;
+    ReportTestResult("ResizeClear (storage follows curve order)", result);
+  }
+};
+
+
+
+#include "cBernoulliSampler.h"
+#include "cStringUtil.h"
+
+class cBernoulliSamplerTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cBernoulliSampler"; }
+protected:
+  // Draws repeatedly and checks the picks against independent per-index trials, each statistic within 5 standard
+  // deviations of its expected value (the seed is fixed, so the outcome is the same on every run)
+  void checkDistribution(cBernoulliSampler& sampler, Apto::Random& rng, int size, double prob, int draws)
+  {
+    Apto::Array<int> picked;
+    Apto::Array<int> counts(size);
+    counts.SetAll(0);
+    
+    bool ordered = true;
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    double adjacent = 0.0;
+    for (int d = 0; d < draws; d++) {
+      sampler.Sample(rng, size, prob, picked);
+      for (int i = 0; i < picked.GetSize(); i++) {
+        if (picked[i] < 0 || picked[i] >= size || (i > 0 && picked[i] <= picked[i - 1])) ordered = false;
+        else counts[picked[i]]++;
+        if (i > 0 && picked[i] == picked[i - 1] + 1) adjacent++;
+      }
+      sum += picked.GetSize();
+      sum_sq += (double)picked.GetSize() * picked.GetSize();
+    }
+    
+    cString name = cStringUtil::Stringf("(%d, %g)", size, prob);
+    ReportTestResult(name + " Distinct, in range and ordered", ordered);
+    
+    // The number picked per draw is binomial
+    const double var = size * prob * (1.0 - prob);
+    const double mean = sum / draws;
+    const double sample_var = (sum_sq - sum * mean) / (draws - 1);
+    ReportTestResult(name + " Number picked, mean", fabs(mean - size * prob) < 5.0 * sqrt(var / draws));
+    ReportTestResult(name + " Number picked, variance", fabs(sample_var - var) < 5.0 * var * sqrt(2.0 / (draws - 1)));
+    
+    // Every index is picked with the same probability: the per-index counts are independent binomials, so their
+    // normalized squared deviations sum to a chi-square with size degrees of freedom
+    const double expected = draws * prob;
+    double chi_sq = 0.0;
+    for (int i = 0; i < size; i++) chi_sq += (counts[i] - expected) * (counts[i] - expected) / (expected * (1.0 - prob));
+    ReportTestResult(name + " Uniform over indices", fabs(chi_sq - size) < 5.0 * sqrt(2.0 * size));
+    
+    // Picks are independent of each other, so neighbouring indices are picked together at the rate of prob squared
+    const double pair_rate = draws * (size - 1) * prob * prob;
+    ReportTestResult(name + " Neighbours independent", fabs(adjacent - pair_rate) < 5.0 * sqrt(pair_rate));
+  }
+  
+  void RunTests()
+  {
+    Apto::RNG::AvidaRNG rng(1001);
+    cBernoulliSampler sampler;
+    
+    // From a sparse range, and from a small one where the same index is often drawn twice
+    checkDistribution(sampler, rng, 1000, 0.02, 5000);
+    checkDistribution(sampler, rng, 64, 0.1, 20000);
+    
+    Apto::Array<int> picked;
+    picked.Push(3);
+    sampler.Sample(rng, 500, 0.0, picked);
+    ReportTestResult("Zero probability", picked.GetSize() == 0);
+    sampler.Sample(rng, 0, 0.5, picked);
+    ReportTestResult("Empty range", picked.GetSize() == 0);
+  }
+};
+
+
+// Microbenchmarks, run with the 'bench' argument.  Each reports the time per
+// operation over a set of arrays of the given size.
+
+class cBitArrayBenchmark
+{
+private:
+  int m_size;
+  Apto::Array<cBitArray> m_arrays;
+
+  static const int NUM_ARRAYS = 1024;
+  
+public:
+  cBitArrayBenchmark(int size) : m_size(size), m_arrays(NUM_ARRAYS)
+  {
+    unsigned int state = 12345;
+    for (int i = 0; i < NUM_ARRAYS; i++) {
+      m_arrays[i].ResizeClear(size);
+      for (int j = 0; j < size; j++) {
+        state = state * 1103515245 + 12345;
+        if ((state >> 16) & 1) m_arrays[i][j] = true;
+      }
+    }
+  }
+  
+  void Run()
+  {
+    const int reps = Apto::Max(1, 20000000 / (NUM_ARRAYS * Apto::Max(64, m_size)));
+    unsigned int checksum = 0;
+    clock_t start;
+    
+    start = clock();
+    for (int r = 0; r < reps; r++) {
+      for (int i = 0; i < NUM_ARRAYS; i++) checksum += m_arrays[i].CountBits();
+    }
+    report("CountBits", start, reps, checksum);
+    
+    start = clock();
+    for (int r = 0; r < reps; r++) {
+      for (int i = 1; i < NUM_ARRAYS; i++) checksum += m_arrays[i - 1].CountBitsAND(m_arrays[i]);
+    }
+    report("CountBitsAND", start, reps, checksum);
+    
+    cBitArray accum(m_arrays[0]);
+    start = clock();
+    for (int r = 0; r < reps; r++) {
+      for (int i = 1; i < NUM_ARRAYS; i++) {
+        accum.ORSELF(m_arrays[i]);
+        accum.XORSELF(m_arrays[i - 1]);
+        accum.ANDNOTSELF(m_arrays[i]);
+      }
+    }
+    report("ORSELF/XORSELF/ANDNOTSELF", start, reps, accum.CountBits());
+    
+    start = clock();
+    for (int r = 0; r < reps; r++) {
+      for (int i = 0; i < NUM_ARRAYS; i++) {
+        for (int b = m_arrays[i].FindBit1(); b >= 0; b = m_arrays[i].FindBit1(b + 1)) checksum += b;
+      }
+    }
+    report("FindBit1 iteration", start, reps, checksum);
+    
+    start = clock();
+    for (int r = 0; r < reps; r++) {
+      for (int i = 0; i < NUM_ARRAYS; i++) {
+        cBitArray copy(m_arrays[i]);
+        checksum += copy.GetSize();
+      }
+    }
+    report("Copy", start, reps, checksum);
+  }
+  
+private:
+  void report(const char* name, clock_t start, int reps, unsigned int checksum)
+  {
+    const double ns = 1.0e9 * (double)(clock() - start) / CLOCKS_PER_SEC / ((double)reps * NUM_ARRAYS);
+    cout << "  " << setw(4) << right << m_size << " bits  " << setw(30) << left << name
+         << setw(10) << right << fixed << setprecision(2) << ns << " ns/op  (" << checksum << ")" << endl;
   }
 };
 
@@ -328,11 +800,26 @@ int main(int argc, const char* argv[])
   
   cUnitTest* tester = NULL;
   
+  if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+    cout << "Avida Tools Microbenchmarks" << endl;
+    const int sizes[] = { 32, 256, 1024, 8192 };
+    for (int i = 0; i < 4; i++) {
+      cBitArrayBenchmark bench(sizes[i]);
+      bench.Run();
+    }
+    return 0;
+  }
+  
   cout << "Avida Tools Unit Tests" << endl;
   cout << endl;
   
   TEST(cRawBitArray);
   TEST(cBitArray);
+  TEST(cInstructionSequence);
+  TEST(cCPUMemory);
+  TEST(cHardwareBase);
+  TEST(cCellArray);
+  TEST(cBernoulliSampler);
   
   if (failed == 0)
     cout << "All unit tests passed." << endl;
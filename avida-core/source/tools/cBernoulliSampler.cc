@@ -0,0 +1,51 @@
+/*
+ *  cBernoulliSampler.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cBernoulliSampler.h"
+
+#include "apto/rng.h"
+
+
+void cBernoulliSampler::Sample(Apto::Random& rng, int size, double prob, Apto::Array<int>& indices)
+{
+  indices.Resize(0);
+  if (size <= 0 || prob <= 0.0) return;
+  
+  const int num_picked = rng.GetRandBinomial(size, prob);
+  if (num_picked == 0) return;
+  
+  if (m_picked.GetSize() < size) {
+    m_picked.Resize(size);
+    m_picked.SetAll(false);
+  }
+  
+  // Each step picks one more distinct index out of [0, j]; if the drawn index was already picked, j (which cannot
+  // have been) is taken in its place
+  for (int j = size - num_picked; j < size; j++) {
+    int idx = rng.GetUInt(j + 1);
+    if (m_picked[idx]) idx = j;
+    m_picked[idx] = true;
+    indices.Push(idx);
+  }
+  
+  for (int i = 0; i < indices.GetSize(); i++) m_picked[indices[i]] = false;
+  Apto::QSort(indices);
+}
@@ -0,0 +1,50 @@
+/*
+ *  cBernoulliSampler.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cBernoulliSampler_h
+#define cBernoulliSampler_h
+
+#include "avida/core/Types.h"
+
+
+// cBernoulliSampler - picks every index of a range independently with the same probability
+//
+// Rather than testing each index, the number picked is drawn from the binomial distribution and that many distinct
+// indices are then chosen uniformly (Floyd's algorithm), so the cost is proportional to the number of indices picked
+// rather than to the size of the range.  The outcome has the same distribution as testing every index.
+
+class cBernoulliSampler
+{
+private:
+  Apto::Array<bool> m_picked;   // Marks indices picked by the current draw, all cleared again before it returns
+
+  
+  cBernoulliSampler(const cBernoulliSampler&); // @not_implemented
+  cBernoulliSampler& operator=(const cBernoulliSampler&); // @not_implemented
+  
+public:
+  cBernoulliSampler() { ; }
+  
+  // Sets indices to the picked indices out of [0, size), in increasing order
+  void Sample(Apto::Random& rng, int size, double prob, Apto::Array<int>& indices);
+};
+
+#endif
@@ -1,14 +1,44 @@
 #include "cBitArray.h"
 
+void cRawBitArray::Allocate(const int new_fields)
+{
+  if (alloc_fields > INLINE_FIELDS) {
+    if (new_fields == alloc_fields) return;
+    delete [] heap_fields;
+  }
+  alloc_fields = new_fields;
+  if (alloc_fields > INLINE_FIELDS) heap_fields = new uint64_t[alloc_fields];
+}
+
+
+void cRawBitArray::Zero(const int num_bits)
+{
+  const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  for (int i = 0; i < num_fields; i++) {
+    bit_fields[i] = 0;
+  }    
+}
+
+void cRawBitArray::Ones(const int num_bits)
+{
+  const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  for (int i = 0; i < num_fields; i++) {
+    bit_fields[i] = ~((uint64_t)0);
+  }    
+  ClearTail(num_bits);
+}
+
+
 void cRawBitArray::Copy(const cRawBitArray & in_array, const int num_bits)
 {
   const int num_fields = GetNumFields(num_bits);
-  if (bit_fields != NULL) {
-    delete [] bit_fields;
-  }
-  bit_fields = new unsigned int[num_fields];
+  Allocate(num_fields);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* in_fields = in_array.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] = in_array.bit_fields[i];
+    bit_fields[i] = in_fields[i];
   }
 }
 
@@ -16,8 +46,10 @@ void cRawBitArray::Copy(const cRawBitArray & in_array, const int num_bits)
 bool cRawBitArray::IsEqual(const cRawBitArray & in_array, int num_bits) const
 {
   const int num_fields = GetNumFields(num_bits);
+  const uint64_t* bit_fields = Fields();
+  const uint64_t* in_fields = in_array.Fields();
   for (int i = 0; i < num_fields; i++) {
-    if (bit_fields[i] != in_array.bit_fields[i]) return false;
+    if (bit_fields[i] != in_fields[i]) return false;
   }
   return true;
 }
@@ -29,50 +61,44 @@ void cRawBitArray::Resize(const int old_bits, const int new_bits)
   const int num_new_fields = GetNumFields(new_bits);
   if (num_old_fields == num_new_fields) {
     // Clear all bits past the new end and stop.
-    unsigned int & last_field = bit_fields[num_new_fields - 1];
-    for (int i = new_bits; i < old_bits; i++) {
-      const unsigned int clear_bit = i & 31;
-      last_field &= ~(1 << clear_bit);
-    }
+    if (new_bits < old_bits) ClearTail(new_bits);
     return;
   }
 
   // If we made it this far, we have to change the number of fields.
-  // Create the new bit array and copy the old one into it.
-  unsigned int * new_bit_fields = new unsigned int[ num_new_fields ];
-  for (int i = 0; i < num_new_fields && i < num_old_fields; i++) {
-    new_bit_fields[i] = bit_fields[i];
+  // Save the old fields (they may live inside this object) and copy them
+  // into the new storage.
+  const int num_kept_fields = (num_old_fields < num_new_fields) ? num_old_fields : num_new_fields;
+  uint64_t kept_inline[INLINE_FIELDS];
+  uint64_t* kept_fields = kept_inline;
+  if (num_kept_fields > INLINE_FIELDS) kept_fields = new uint64_t[num_kept_fields];
+  const uint64_t* old_fields = Fields();
+  for (int i = 0; i < num_kept_fields; i++) {
+    kept_fields[i] = old_fields[i];
   }
+
+  Allocate(num_new_fields);
+  uint64_t* new_bit_fields = Fields();
+  for (int i = 0; i < num_kept_fields; i++) {
+    new_bit_fields[i] = kept_fields[i];
+  }
+  if (kept_fields != kept_inline) delete [] kept_fields;
   
   // If the old bits are longer, we need to clear the end of the last
   // bit field.
-  if (num_old_fields > num_new_fields) {
-    unsigned int & last_field = new_bit_fields[num_new_fields - 1];
-    for (int clear_bit=GetFieldPos(new_bits); clear_bit < 32; clear_bit++) {
-      last_field &= ~(1 << clear_bit);
-    }
-  }
+  if (num_old_fields > num_new_fields) ClearTail(new_bits);
   
   // If the new bits are longer, clear everything past the end of the old
   // bits.
   for (int i = num_old_fields; i < num_new_fields; i++) {
     new_bit_fields[i] = 0;
   }
-
-  if (bit_fields != NULL) {
-    delete [] bit_fields;
-  }
-  bit_fields = new_bit_fields;
 }
 
 
 void cRawBitArray::ResizeSloppy(const int new_bits)
 {
-  const int new_fields = GetNumFields(new_bits);
-  if (bit_fields != NULL) {
-    delete [] bit_fields;
-  }
-  bit_fields = new unsigned int[ new_fields ];
+  Allocate(GetNumFields(new_bits));
 }
 
 void cRawBitArray::ResizeClear(const int new_bits)
@@ -82,56 +108,60 @@ void cRawBitArray::ResizeClear(const int new_bits)
 }
 
 
-// This technique counts the number of bits; it loops through once for each
-// bit equal to 1.  This is reasonably fast for sparse arrays.
 int cRawBitArray::CountBits(const int num_bits) const
 {
   const int num_fields = GetNumFields(num_bits);
+  const uint64_t* bit_fields = Fields();
   int bit_count = 0;
   
   for (int i = 0; i < num_fields; i++) {
-    int temp = bit_fields[i];
-    while (temp != 0) {
-      temp = temp & (temp - 1);
-      bit_count++;
-    }
+    bit_count += PopCount(bit_fields[i]);
   }
   return bit_count;
 }
 
-// This technique is another way of counting bits; It does a bunch of
-// clever bit tricks to do it in parallel in each int.
-int cRawBitArray::CountBits2(const int num_bits) const
+int cRawBitArray::CountBitsAND(const cRawBitArray & array2, const int num_bits) const
 {
   const int num_fields = GetNumFields(num_bits);
+  const uint64_t* bit_fields = Fields();
+  const uint64_t* bit_fields2 = array2.Fields();
   int bit_count = 0;
   
   for (int i = 0; i < num_fields; i++) {
-    const int  v = bit_fields[i];
-    unsigned int const t1 = v - ((v >> 1) & 0x55555555);
-    unsigned int const t2 = (t1 & 0x33333333) + ((t1 >> 2) & 0x33333333);
-    bit_count += ((t2 + (t2 >> 4) & 0xF0F0F0F) * 0x1010101) >> 24;
+    bit_count += PopCount(bit_fields[i] & bit_fields2[i]);
   }
   return bit_count;
 }
 
 int cRawBitArray::FindBit1(const int num_bits, const int start_pos) const
 {
-  // @CAO -- There are probably better ways to do this with bit tricks.
-  for (int i = start_pos; i < num_bits; i++) {
-    if (GetBit(i) == true) return i;
+  if (start_pos >= num_bits) return -1;
+  
+  const int num_fields = GetNumFields(num_bits);
+  const uint64_t* bit_fields = Fields();
+  
+  // Mask off the bits before start_pos in its field, then skip empty fields.
+  int field_id = GetField(start_pos);
+  uint64_t field = bit_fields[field_id] & (~((uint64_t)0) << GetFieldPos(start_pos));
+  while (field == 0) {
+    if (++field_id == num_fields) return -1;
+    field = bit_fields[field_id];
   }
 
-  return -1;
+  return (field_id << 6) + LowBit(field);
 }
 
 Apto::Array<int> cRawBitArray::GetOnes(const int num_bits) const
 {
-  // @CAO -- There are probably better ways to do this with bit tricks.
-  Apto::Array<int> out_array(CountBits2(num_bits));
+  Apto::Array<int> out_array(CountBits(num_bits));
+  const int num_fields = GetNumFields(num_bits);
+  const uint64_t* bit_fields = Fields();
   int cur_pos = 0;
-  for (int i = 0; i < num_bits; i++) {
-    if (GetBit(i) == true) out_array[cur_pos++] = i;
+  for (int i = 0; i < num_fields; i++) {
+    // Peel off the lowest 1 until the field is empty
+    for (uint64_t field = bit_fields[i]; field != 0; field &= field - 1) {
+      out_array[cur_pos++] = (i << 6) + LowBit(field);
+    }
   }
 
   return out_array;
@@ -140,12 +170,17 @@ Apto::Array<int> cRawBitArray::GetOnes(const int num_bits) const
 void cRawBitArray::ShiftLeft(const int num_bits, const int shift_size)
 {
   assert(shift_size > 0);
-  int num_fields = GetNumFields(num_bits);
-  int field_shift = shift_size / 32;
-  int bit_shift = shift_size % 32;
+  const int num_fields = GetNumFields(num_bits);
+  const int field_shift = shift_size >> 6;
+  const int bit_shift = shift_size & 63;
+  uint64_t* bit_fields = Fields();
   
+  if (field_shift >= num_fields) {
+    Zero(num_bits);
+    return;
+  }
   
-  // acount for field_shift
+  // account for field_shift
   if (field_shift) {
     for (int i = num_fields - 1; i >= field_shift; i--) {
       bit_fields[i] = bit_fields[i - field_shift];
@@ -155,124 +190,135 @@ void cRawBitArray::ShiftLeft(const int num_bits, const int shift_size)
     }
   }
   
-  
-  // account for bit_shift
-  int temp = 0;
-  for (int i = 0; i < num_fields; i++) {
-    temp = bit_fields[i] >> (32 - bit_shift);
-    bit_fields[i] <<= bit_shift;
-    if (i > 0) bit_fields[i - 1] |= temp;  // same as += in this case since lower bit_shift bits of bit_fields[i - 1] are all 0 at this point -- any advantage?  
-    //could also check for temp != 0 here before assignment -- would that save any time for sparse arrays, or is it always going to be useless?
+  // account for bit_shift, carrying the high bits of each field into the next
+  if (bit_shift) {
+    for (int i = num_fields - 1; i > 0; i--) {
+      bit_fields[i] = (bit_fields[i] << bit_shift) | (bit_fields[i - 1] >> (64 - bit_shift));
+    }
+    bit_fields[0] <<= bit_shift;
   }
   
-  // mask out any bits that have left-shifted away, allowing CountBits and CountBits2 to work
-  // blw: if CountBits/CountBits2 are fixed, this code should be removed as it will be redundant
-  unsigned int shift_mask = 0xFFFFFFFF >> ((32 - (num_bits % 32)) & 0x1F);
-  bit_fields[num_fields - 1] &= shift_mask;
+  // mask out any bits that have left-shifted away, allowing CountBits to work
+  ClearTail(num_bits);
 }
 
-// ALWAYS shifts in zeroes, irrespective of sign bit (since fields are unsigned)
+// ALWAYS shifts in zeroes
 void cRawBitArray::ShiftRight(const int num_bits, const int shift_size)
 {
   assert(shift_size > 0);
-  int num_fields = GetNumFields(num_bits);
-  int field_shift = shift_size / 32;
-  int bit_shift = shift_size % 32;
+  const int num_fields = GetNumFields(num_bits);
+  const int field_shift = shift_size >> 6;
+  const int bit_shift = shift_size & 63;
+  uint64_t* bit_fields = Fields();
+  
+  if (field_shift >= num_fields) {
+    Zero(num_bits);
+    return;
+  }
   
   // account for field_shift
   if (field_shift) {
     for (int i = 0; i < num_fields - field_shift; i++) {
       bit_fields[i] = bit_fields[i + field_shift];
     }
-    for(int i = num_fields - field_shift; i < num_fields; i++) {
+    for (int i = num_fields - field_shift; i < num_fields; i++) {
       bit_fields[i] = 0;
     }
   }
   
-  // account for bit_shift
-  bit_fields[num_fields - 1] >>= bit_shift;  // drops off right end, may shift in ones if sign bit was set
-  int temp = 0;
-  for (int i = num_fields - 2; i >= 0; i--) {
-    temp = bit_fields[i] << (32 - bit_shift);
-    bit_fields[i] >>= bit_shift;
-    bit_fields[i + 1] |= temp;
+  // account for bit_shift, carrying the low bits of each field into the previous
+  if (bit_shift) {
+    for (int i = 0; i < num_fields - 1; i++) {
+      bit_fields[i] = (bit_fields[i] >> bit_shift) | (bit_fields[i + 1] << (64 - bit_shift));
+    }
+    bit_fields[num_fields - 1] >>= bit_shift;
   }
 }
 
+
+// The logical kernels below are simple loops over whole fields, which the
+// compiler can unroll and vectorize.
+
 void cRawBitArray::NOT(const int num_bits)
 {
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
   for (int i = 0; i < num_fields; i++) {
     bit_fields[i] = ~bit_fields[i];
   }
-
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
-  }
+  ClearTail(num_bits);
 }
 
 void cRawBitArray::AND(const cRawBitArray & array2, const int num_bits)
 {
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] &= array2.bit_fields[i];
+    bit_fields[i] &= fields2[i];
   }
 }
 
 void cRawBitArray::OR(const cRawBitArray & array2, const int num_bits)
 {
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] |= array2.bit_fields[i];
+    bit_fields[i] |= fields2[i];
   }
 }
 
 void cRawBitArray::NAND(const cRawBitArray & array2, const int num_bits)
 {
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] = ~(bit_fields[i] & array2.bit_fields[i]);
-  }
-
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
+    bit_fields[i] = ~(bit_fields[i] & fields2[i]);
   }
+  ClearTail(num_bits);
 }
 
 void cRawBitArray::NOR(const cRawBitArray & array2, const int num_bits)
 {
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] = ~(bit_fields[i] | array2.bit_fields[i]);
-  }
-
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
+    bit_fields[i] = ~(bit_fields[i] | fields2[i]);
   }
+  ClearTail(num_bits);
 }
 
 void cRawBitArray::XOR(const cRawBitArray & array2, const int num_bits)
 {
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] ^= array2.bit_fields[i];
+    bit_fields[i] ^= fields2[i];
   }
-
 }
 
 void cRawBitArray::EQU(const cRawBitArray & array2, const int num_bits)
 {
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] = ~(bit_fields[i] ^ array2.bit_fields[i]);
+    bit_fields[i] = ~(bit_fields[i] ^ fields2[i]);
   }
+  ClearTail(num_bits);
+}
 
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
+void cRawBitArray::ANDNOT(const cRawBitArray & array2, const int num_bits)
+{
+  const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields2 = array2.Fields();
+  for (int i = 0; i < num_fields; i++) {
+    bit_fields[i] &= ~fields2[i];
   }
 }
 
@@ -287,17 +333,14 @@ void cRawBitArray::SHIFT(const int num_bits, const int shift_size)
 void cRawBitArray::INCREMENT(const int num_bits)
 {
   const int num_fields = GetNumFields(num_bits);
-  int i = 0;
-  for (i = 0; i < num_fields; i++) {
+  uint64_t* bit_fields = Fields();
+  for (int i = 0; i < num_fields; i++) {
     bit_fields[i]++;
     if (bit_fields[i] != 0) { break; }  // no overflow, do not need to increment higher fields
   }
   
-  // if highest bit field was incremented, mask out any unused portions of the field so as not to confuse CountBits
-  if (i == num_fields - 1) {
-    unsigned int shift_mask = 0xffffffff >> (32 - (num_bits % 32));
-    bit_fields[num_fields - 1] &= shift_mask;
-  }
+  // mask out any unused portion of the highest field so as not to confuse CountBits
+  ClearTail(num_bits);
 }
 
 
@@ -309,14 +352,12 @@ void cRawBitArray::NOT(const cRawBitArray & array1, const int num_bits)
   ResizeSloppy(num_bits);
 
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields1 = array1.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] = ~array1.bit_fields[i];
-  }
-
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
+    bit_fields[i] = ~fields1[i];
   }
+  ClearTail(num_bits);
 }
 
 void cRawBitArray::AND(const cRawBitArray & array1,
@@ -325,8 +366,11 @@ void cRawBitArray::AND(const cRawBitArray & array1,
   ResizeSloppy(num_bits);
 
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields1 = array1.Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] = array1.bit_fields[i] & array2.bit_fields[i];
+    bit_fields[i] = fields1[i] & fields2[i];
   }
 }
 
@@ -336,8 +380,11 @@ void cRawBitArray::OR(const cRawBitArray & array1,
   ResizeSloppy(num_bits);
 
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields1 = array1.Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] = array1.bit_fields[i] | array2.bit_fields[i];
+    bit_fields[i] = fields1[i] | fields2[i];
   }
 }
 
@@ -347,14 +394,13 @@ void cRawBitArray::NAND(const cRawBitArray & array1,
   ResizeSloppy(num_bits);
 
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields1 = array1.Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] = ~(array1.bit_fields[i] & array2.bit_fields[i]);
-  }
-
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
+    bit_fields[i] = ~(fields1[i] & fields2[i]);
   }
+  ClearTail(num_bits);
 }
 
 void cRawBitArray::NOR(const cRawBitArray & array1,
@@ -363,14 +409,13 @@ void cRawBitArray::NOR(const cRawBitArray & array1,
   ResizeSloppy(num_bits);
 
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields1 = array1.Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] = ~(array1.bit_fields[i] | array2.bit_fields[i]);
-  }
-
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
+    bit_fields[i] = ~(fields1[i] | fields2[i]);
   }
+  ClearTail(num_bits);
 }
 
 void cRawBitArray::XOR(const cRawBitArray & array1,
@@ -379,10 +424,12 @@ void cRawBitArray::XOR(const cRawBitArray & array1,
   ResizeSloppy(num_bits);
 
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields1 = array1.Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] = array1.bit_fields[i] ^ array2.bit_fields[i];
+    bit_fields[i] = fields1[i] ^ fields2[i];
   }
-
 }
 
 void cRawBitArray::EQU(const cRawBitArray & array1, const cRawBitArray & array2, const int num_bits)
@@ -390,20 +437,31 @@ void cRawBitArray::EQU(const cRawBitArray & array1, const cRawBitArray & array2,
   ResizeSloppy(num_bits);
 
   const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields1 = array1.Fields();
+  const uint64_t* fields2 = array2.Fields();
   for (int i = 0; i < num_fields; i++) {
-    bit_fields[i] = ~(array1.bit_fields[i] ^ array2.bit_fields[i]);
+    bit_fields[i] = ~(fields1[i] ^ fields2[i]);
   }
+  ClearTail(num_bits);
+}
+
+void cRawBitArray::ANDNOT(const cRawBitArray & array1,
+			  const cRawBitArray & array2, const int num_bits)
+{
+  ResizeSloppy(num_bits);
 
-  const int last_bit = GetFieldPos(num_bits);
-  if (last_bit > 0) {
-    bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
+  const int num_fields = GetNumFields(num_bits);
+  uint64_t* bit_fields = Fields();
+  const uint64_t* fields1 = array1.Fields();
+  const uint64_t* fields2 = array2.Fields();
+  for (int i = 0; i < num_fields; i++) {
+    bit_fields[i] = fields1[i] & ~fields2[i];
   }
 }
 
 void cRawBitArray::SHIFT(const cRawBitArray & array1, const int num_bits, const int shift_size)
 {
-  if (shift_size == 0) return;
-  
   Copy(array1, num_bits);
   
   SHIFT(num_bits, shift_size);
@@ -42,9 +42,10 @@ using namespace std;
 //  void PrintOneIDs(ostream & out=cout) const
 
 // Bit play:
-//  int CountBits()   -- Count 1s -- fast for sparse arrays.
-//  int CountBits2()  -- Count 1s -- fast for arbitary arrays.
-//  int FindBit1(int start_bit)   -- Return pos of first 1 after start_bit 
+//  int CountBits()   -- Count 1s (hardware population count where available)
+//  int CountBits2()  -- Count 1s (same as CountBits, kept for older callers)
+//  int CountBitsAND(const cBitArray & array2)   -- Count 1s in (this & array2), without building it
+//  int FindBit1(int start_bit)   -- Return pos of first 1 at or after start_bit (-1 if none)
 
 // Boolean math functions:
 //  cBitArray NOT() const
@@ -54,6 +55,7 @@ using namespace std;
 //  cBitArray NOR(const cBitArray & array2) const
 //  cBitArray XOR(const cBitArray & array2) const
 //  cBitArray EQU(const cBitArray & array2) const
+//  cBitArray ANDNOT(const cBitArray & array2) const   -- this & ~array2
 //  cBitArray SHIFT(const int shift_size) const   -- positive for left shift, negative for right shift
 
 //  const cBitArray & NOTSELF()
@@ -63,6 +65,7 @@ using namespace std;
 //  const cBitArray & NORSELF(const cBitArray & array2)
 //  const cBitArray & XORSELF(const cBitArray & array2)
 //  const cBitArray & EQUSELF(const cBitArray & array2)
+//  const cBitArray & ANDNOTSELF(const cBitArray & array2)
 //  const cBitArray & SHIFTSELF(const int shift_size) const
 
 // Arithmetic:
@@ -89,48 +92,81 @@ using namespace std;
 // The following is an internal class used by cBitArray (and will be used in
 // cBitMatrix eventually....).  It does not keep track of size, so this value
 // must be passed in.
+//
+// Bits are stored in 64-bit fields.  Arrays of up to 256 bits are kept in the
+// object itself rather than on the heap, so small phenotype and task sets can
+// be created and copied without allocating.  All bits past the end of the
+// array are always kept at zero, which the counting and comparison methods
+// rely on.
 
 class cRawBitArray {
 private:
-  unsigned int * bit_fields;
+  static const int INLINE_FIELDS = 4;
+
+  int alloc_fields;             // number of fields currently allocated
+  union {
+    uint64_t* heap_fields;      // used when alloc_fields > INLINE_FIELDS
+    uint64_t inline_fields[INLINE_FIELDS];
+  };
   
   // Disallow default copy constructor and operator=
   // (we need to know the number of bits we're working with!)
   cRawBitArray(const cRawBitArray&);
   const cRawBitArray & operator=(const cRawBitArray&);
 
-  inline int GetNumFields(const int num_bits) const { return 1 + ((num_bits - 1) >> 5); }
-  inline int GetField(const int index) const { return index >> 5; }
-  inline int GetFieldPos(const int index) const { return index & 31; }
+  inline int GetNumFields(const int num_bits) const { return 1 + ((num_bits - 1) >> 6); }
+  inline int GetField(const int index) const { return index >> 6; }
+  inline int GetFieldPos(const int index) const { return index & 63; }
+
+  inline uint64_t* Fields() { return (alloc_fields > INLINE_FIELDS) ? heap_fields : inline_fields; }
+  inline const uint64_t* Fields() const { return (alloc_fields > INLINE_FIELDS) ? heap_fields : inline_fields; }
+
+  // Sets the number of fields, discarding their contents
+  void Allocate(const int new_fields);
+
+  // Clears any bits past num_bits in the last field
+  inline void ClearTail(const int num_bits) {
+    const int last_bit = GetFieldPos(num_bits);
+    if (last_bit > 0) Fields()[GetNumFields(num_bits) - 1] &= (((uint64_t)1) << last_bit) - 1;
+  }
+
 public:
-  cRawBitArray() : bit_fields(NULL) { ; }
-  ~cRawBitArray() {
-    if (bit_fields != NULL) {
-      delete [] bit_fields;
-    }
+  // The builtin is only used where it is a single instruction: on x86 without POPCNT enabled it is a library call,
+  // which is slower than counting in registers.
+  static inline int PopCount(uint64_t field) {
+#if defined(__GNUC__) && (defined(__POPCNT__) || !(defined(__x86_64__) || defined(__i386__)))
+    return __builtin_popcountll(field);
+#else
+    field = field - ((field >> 1) & 0x5555555555555555ULL);
+    field = (field & 0x3333333333333333ULL) + ((field >> 2) & 0x3333333333333333ULL);
+    field = (field + (field >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((field * 0x0101010101010101ULL) >> 56);
+#endif
   }
 
-  void Zero(const int num_bits) {
-    const int num_fields = GetNumFields(num_bits);
-    for (int i = 0; i < num_fields; i++) {
-      bit_fields[i] = 0;
-    }    
+  // Position of the lowest 1 in a non-zero field
+  static inline int LowBit(uint64_t field) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(field);
+#else
+    int pos = 0;
+    while ((field & 1) == 0) { field >>= 1; pos++; }
+    return pos;
+#endif
   }
 
-  void Ones(const int num_bits) {
-    const int num_fields = GetNumFields(num_bits);
-    for (int i = 0; i < num_fields; i++) {
-      bit_fields[i] = ~0;
-    }    
-    const int last_bit = GetFieldPos(num_bits);
-    if (last_bit > 0) {
-      bit_fields[num_fields - 1] &= (1 << last_bit) - 1;
+  cRawBitArray() : alloc_fields(0) { ; }
+  ~cRawBitArray() {
+    if (alloc_fields > INLINE_FIELDS) {
+      delete [] heap_fields;
     }
   }
 
-  cRawBitArray(const int num_bits) {
-    const int num_fields = GetNumFields(num_bits);
-    bit_fields = new unsigned int[ num_fields ];
+  void Zero(const int num_bits);
+  void Ones(const int num_bits);
+
+  cRawBitArray(const int num_bits) : alloc_fields(0) {
+    Allocate(GetNumFields(num_bits));
     Zero(num_bits);
   }
 
@@ -138,7 +174,7 @@ public:
   // bits they are working with.
   void Copy(const cRawBitArray & in_array, const int num_bits);
   cRawBitArray(const cRawBitArray & in_array, const int num_bits)
-    : bit_fields(NULL)
+    : alloc_fields(0)
   {
     Copy(in_array, num_bits);
   }
@@ -150,18 +186,18 @@ public:
   bool GetBit(const int index) const{
     const int field_id = GetField(index);
     const int pos_id = GetFieldPos(index);
-    return (bit_fields[field_id] & (1 << pos_id)) != 0;
+    return (Fields()[field_id] & (((uint64_t)1) << pos_id)) != 0;
   }
 
   void SetBit(const int index, const bool value) {
     const int field_id = GetField(index);
     const int pos_id = GetFieldPos(index);
-    const int pos_mask = 1 << pos_id;
+    const uint64_t pos_mask = ((uint64_t)1) << pos_id;
 
     if (value == false) {
-      bit_fields[field_id] &= ~pos_mask;
+      Fields()[field_id] &= ~pos_mask;
     } else {
-      bit_fields[field_id] |= pos_mask;
+      Fields()[field_id] |= pos_mask;
     }
   }
 
@@ -171,9 +207,9 @@ public:
   void ResizeSloppy(const int new_bits);
   void ResizeClear(const int new_bits);
 
-  // Two different technique of bit counting...
-  int CountBits(const int num_bits) const; // Better for sparse arrays
-  int CountBits2(const int num_bits) const; // Better for dense arrays
+  int CountBits(const int num_bits) const;
+  int CountBits2(const int num_bits) const { return CountBits(num_bits); }
+  int CountBitsAND(const cRawBitArray & array2, const int num_bits) const;
 
   // Other bit-play
   int FindBit1(const int num_bits, const int start_pos) const;
@@ -211,6 +247,7 @@ public:
   void NOR(const cRawBitArray & array2, const int num_bits);
   void XOR(const cRawBitArray & array2, const int num_bits);
   void EQU(const cRawBitArray & array2, const int num_bits);
+  void ANDNOT(const cRawBitArray & array2, const int num_bits);
   void SHIFT(const int num_bits, const int shift_size);  // positive numbers for left and negative for right (0 does nothing)
   void INCREMENT(const int num_bits);
 
@@ -229,6 +266,8 @@ public:
 	   const int num_bits);
   void EQU(const cRawBitArray & array1, const cRawBitArray & array2,
 	   const int num_bits);
+  void ANDNOT(const cRawBitArray & array1, const cRawBitArray & array2,
+	      const int num_bits);
   void SHIFT(const cRawBitArray & array1, const int num_bits, const int shift_size);
   void INCREMENT(const cRawBitArray & array1, const int num_bits);  // implemented for completeness, but unused by cBitArray
 };
@@ -304,6 +343,10 @@ public:
   }
   int CountBits() const { return bit_array.CountBits(array_size); }
   int CountBits2() const { return bit_array.CountBits2(array_size); }
+  int CountBitsAND(const cBitArray & array2) const {
+    assert(array_size == array2.array_size);
+    return bit_array.CountBitsAND(array2.bit_array, array_size);
+  }
 
   int FindBit1(int start_bit=0) const
     { return bit_array.FindBit1(array_size, start_bit); }
@@ -364,6 +407,14 @@ public:
     out_array.array_size = array_size;
     return out_array;
   }
+
+  cBitArray ANDNOT(const cBitArray & array2) const {
+    assert(array_size == array2.array_size);
+    cBitArray out_array;
+    out_array.bit_array.ANDNOT(bit_array, array2.bit_array, array_size);
+    out_array.array_size = array_size;
+    return out_array;
+  }
   
   cBitArray SHIFT(const int shift_size) const {
     cBitArray out_array;
@@ -412,6 +463,12 @@ public:
     bit_array.EQU(array2.bit_array, array_size);
     return *this;
   }
+
+  const cBitArray & ANDNOTSELF(const cBitArray & array2) {
+    assert(array_size == array2.array_size);
+    bit_array.ANDNOT(array2.bit_array, array_size);
+    return *this;
+  }
   
   const cBitArray & SHIFTSELF(const int shift_size) {
     bit_array.SHIFT(array_size, shift_size);
@@ -477,9 +534,7 @@ namespace Apto {
     static int Hash(const cBitArray& key)
     {
       unsigned int out_hash = 0;
-      for (int i = 0; i < key.GetSize(); i++) {
-        if (key.Get(i)) { out_hash += i*i; }
-      }
+      for (int i = key.FindBit1(); i >= 0; i = key.FindBit1(i + 1)) out_hash += i*i;
       return out_hash % HashFactor;
     }
   };
@@ -0,0 +1,337 @@
+/*
+ *  cObjectPool.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cObjectPool.h"
+
+#include <cassert>
+#include <new>
+
+#if APTO_PLATFORM(WINDOWS)
+# include <windows.h>
+#else
+# include <pthread.h>
+#endif
+
+
+struct cObjectPool::sThreadCache
+{
+  cObjectPool* pool;             // NULL once the pool has been destroyed
+  int pool_id;
+  sFreeBlock* free_list;
+  int num_free;
+  long long allocs;
+  long long recycled;
+  long long releases;
+  sThreadCache* next_in_thread;
+  sThreadCache* next_in_pool;
+};
+
+OBJECT_POOL_THREAD_LOCAL cObjectPool::sThreadCache* cObjectPool::s_thread_caches = NULL;
+Apto::Mutex cObjectPool::s_id_mutex;
+int cObjectPool::s_next_id = 0;
+
+
+// Thread exit hook, returning the caches of any thread that used a pool when it exits.  The key is created along with
+// the first pool, and set on a thread whenever it goes from having no caches to having one.
+#if APTO_PLATFORM(WINDOWS)
+static DWORD s_exit_key = FLS_OUT_OF_INDEXES;
+static void WINAPI threadExit(void*) { cObjectPool::ReleaseThreadCaches(); }
+static void createExitKey() { s_exit_key = FlsAlloc(threadExit); }
+static void armExitKey() { if (s_exit_key != FLS_OUT_OF_INDEXES) FlsSetValue(s_exit_key, &s_exit_key); }
+#else
+static pthread_key_t s_exit_key;
+static bool s_exit_key_valid = false;
+static void threadExit(void*) { cObjectPool::ReleaseThreadCaches(); }
+static void createExitKey() { s_exit_key_valid = (pthread_key_create(&s_exit_key, threadExit) == 0); }
+static void armExitKey() { if (s_exit_key_valid) pthread_setspecific(s_exit_key, &s_exit_key); }
+#endif
+static bool s_exit_key_created = false;
+
+
+cObjectPool::cObjectPool(const cString& name, size_t object_size, bool enabled, int blocks_per_slab)
+  : m_name(name)
+  , m_object_size(object_size)
+  , m_blocks_per_slab(blocks_per_slab)
+  , m_enabled(enabled)
+  , m_slab_next(NULL)
+  , m_slab_end(NULL)
+  , m_free_list(NULL)
+  , m_num_free(0)
+  , m_caches(NULL)
+  , m_total_allocs(0)
+  , m_total_recycled(0)
+  , m_total_releases(0)
+{
+  assert(m_blocks_per_slab > 0);
+  
+  s_id_mutex.Lock();
+  m_id = s_next_id++;
+  if (!s_exit_key_created) {
+    createExitKey();
+    s_exit_key_created = true;
+  }
+  s_id_mutex.Unlock();
+  
+  // Round the object up to a whole number of headers, so that every block (and the object following its header)
+  // stays maximally aligned within the slab
+  const size_t header_size = sizeof(uBlockHeader);
+  if (m_object_size < sizeof(sFreeBlock)) m_object_size = sizeof(sFreeBlock);
+  m_block_size = header_size + ((m_object_size + header_size - 1) / header_size) * header_size;
+}
+
+cObjectPool::~cObjectPool()
+{
+  // Objects still alive would be left pointing into freed slabs
+  assert(GetNumLive() == 0);
+  
+  // Caches still listed by other threads are marked dead, and are deleted the next time their thread looks one up
+  m_mutex.Lock();
+  for (sThreadCache* cache = m_caches; cache; cache = cache->next_in_pool) {
+    cache->pool = NULL;
+    cache->free_list = NULL;
+    cache->num_free = 0;
+  }
+  m_caches = NULL;
+  m_mutex.Unlock();
+  
+  for (int i = 0; i < m_slabs.GetSize(); i++) delete [] m_slabs[i];
+}
+
+
+void cObjectPool::addSlab()
+{
+  char* slab = new char[m_block_size * m_blocks_per_slab];
+  m_slabs.Push(slab);
+  m_slab_next = slab;
+  m_slab_end = slab + m_block_size * m_blocks_per_slab;
+}
+
+
+cObjectPool::sThreadCache* cObjectPool::threadCache()
+{
+  for (sThreadCache* cache = s_thread_caches; cache; cache = cache->next_in_thread) {
+    if (cache->pool_id == m_id) return cache;
+  }
+  
+  // First use of this pool on this thread, drop any caches of destroyed pools while walking the list anyway
+  sThreadCache** link = &s_thread_caches;
+  while (*link) {
+    sThreadCache* cache = *link;
+    if (cache->pool) {
+      link = &cache->next_in_thread;
+    } else {
+      *link = cache->next_in_thread;
+      delete cache;
+    }
+  }
+  
+  if (!s_thread_caches) armExitKey();
+  
+  sThreadCache* cache = new sThreadCache;
+  cache->pool = this;
+  cache->pool_id = m_id;
+  cache->free_list = NULL;
+  cache->num_free = 0;
+  cache->allocs = 0;
+  cache->recycled = 0;
+  cache->releases = 0;
+  cache->next_in_thread = s_thread_caches;
+  s_thread_caches = cache;
+  
+  Apto::MutexAutoLock lock(m_mutex);
+  cache->next_in_pool = m_caches;
+  m_caches = cache;
+  
+  return cache;
+}
+
+
+// Move a batch of released blocks from the shared list to the cache.  If there are none, a fresh block is carved from
+// the current slab and returned directly instead.
+cObjectPool::uBlockHeader* cObjectPool::refill(sThreadCache* cache)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  
+  if (m_free_list) {
+    for (int i = 0; i < THREAD_CACHE_BATCH && m_free_list; i++) {
+      sFreeBlock* block = m_free_list;
+      m_free_list = block->next;
+      m_num_free--;
+      block->next = cache->free_list;
+      cache->free_list = block;
+      cache->num_free++;
+    }
+    return NULL;
+  }
+  
+  if (m_slab_next == m_slab_end) addSlab();
+  uBlockHeader* header = reinterpret_cast<uBlockHeader*>(m_slab_next);
+  m_slab_next += m_block_size;
+  return header;
+}
+
+
+void cObjectPool::spill(sThreadCache* cache, int num_blocks)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  
+  for (int i = 0; i < num_blocks && cache->free_list; i++) {
+    sFreeBlock* block = cache->free_list;
+    cache->free_list = block->next;
+    cache->num_free--;
+    block->next = m_free_list;
+    m_free_list = block;
+    m_num_free++;
+  }
+}
+
+
+void* cObjectPool::Allocate(size_t size)
+{
+  assert(size <= m_object_size);
+  (void)size;
+  
+  uBlockHeader* header = NULL;
+  if (!m_enabled) {
+    header = static_cast<uBlockHeader*>(::operator new(m_block_size));
+    Apto::MutexAutoLock lock(m_mutex);
+    m_total_allocs++;
+  } else {
+    sThreadCache* cache = threadCache();
+    if (!cache->free_list) header = refill(cache);
+    if (!header) {
+      header = reinterpret_cast<uBlockHeader*>(cache->free_list);
+      cache->free_list = cache->free_list->next;
+      cache->num_free--;
+      cache->recycled++;
+    }
+    cache->allocs++;
+  }
+  
+  header->owner = this;
+  return header + 1;
+}
+
+
+void cObjectPool::Release(void* ptr)
+{
+  if (ptr == NULL) return;
+  
+  uBlockHeader* header = static_cast<uBlockHeader*>(ptr) - 1;
+  cObjectPool* pool = header->owner;
+  assert(pool != NULL);
+  
+  if (!pool->m_enabled) {
+    ::operator delete(header);
+    Apto::MutexAutoLock lock(pool->m_mutex);
+    pool->m_total_releases++;
+    return;
+  }
+  
+  sThreadCache* cache = pool->threadCache();
+  sFreeBlock* block = reinterpret_cast<sFreeBlock*>(header);
+  block->next = cache->free_list;
+  cache->free_list = block;
+  cache->num_free++;
+  cache->releases++;
+  
+  if (cache->num_free > THREAD_CACHE_LIMIT) pool->spill(cache, THREAD_CACHE_BATCH);
+}
+
+
+void cObjectPool::ReleaseThreadCaches()
+{
+  while (s_thread_caches) {
+    sThreadCache* cache = s_thread_caches;
+    s_thread_caches = cache->next_in_thread;
+    
+    cObjectPool* pool = cache->pool;
+    if (pool) {
+      pool->spill(cache, cache->num_free);
+      
+      Apto::MutexAutoLock lock(pool->m_mutex);
+      pool->m_total_allocs += cache->allocs;
+      pool->m_total_recycled += cache->recycled;
+      pool->m_total_releases += cache->releases;
+      sThreadCache** link = &pool->m_caches;
+      while (*link != cache) link = &(*link)->next_in_pool;
+      *link = cache->next_in_pool;
+    }
+    delete cache;
+  }
+}
+
+
+void cObjectPool::collectCounts(long long& allocs, long long& recycled, long long& releases, int& num_free) const
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  
+  allocs = m_total_allocs;
+  recycled = m_total_recycled;
+  releases = m_total_releases;
+  num_free = m_num_free + (int)((m_slab_end - m_slab_next) / m_block_size);
+  for (sThreadCache* cache = m_caches; cache; cache = cache->next_in_pool) {
+    allocs += cache->allocs;
+    recycled += cache->recycled;
+    releases += cache->releases;
+    num_free += cache->num_free;
+  }
+}
+
+int cObjectPool::GetNumLive() const
+{
+  long long allocs, recycled, releases;
+  int num_free;
+  collectCounts(allocs, recycled, releases, num_free);
+  return (int)(allocs - releases);
+}
+
+int cObjectPool::GetNumFree() const
+{
+  long long allocs, recycled, releases;
+  int num_free;
+  collectCounts(allocs, recycled, releases, num_free);
+  return num_free;
+}
+
+long long cObjectPool::GetTotalAllocations() const
+{
+  long long allocs, recycled, releases;
+  int num_free;
+  collectCounts(allocs, recycled, releases, num_free);
+  return allocs;
+}
+
+long long cObjectPool::GetTotalRecycled() const
+{
+  long long allocs, recycled, releases;
+  int num_free;
+  collectCounts(allocs, recycled, releases, num_free);
+  return recycled;
+}
+
+double cObjectPool::GetRecycleRate() const
+{
+  long long allocs, recycled, releases;
+  int num_free;
+  collectCounts(allocs, recycled, releases, num_free);
+  return (allocs) ? (double)recycled / (double)allocs : 0.0;
+}
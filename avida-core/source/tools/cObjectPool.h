@@ -0,0 +1,131 @@
+/*
+ *  cObjectPool.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cObjectPool_h
+#define cObjectPool_h
+
+#include "avida/core/Types.h"
+
+#include "apto/core/Mutex.h"
+#include "apto/platform.h"
+
+#include "cString.h"
+
+#include <cstddef>
+
+#if APTO_PLATFORM(WINDOWS)
+# define OBJECT_POOL_THREAD_LOCAL __declspec(thread)
+#else
+# define OBJECT_POOL_THREAD_LOCAL __thread
+#endif
+
+
+// cObjectPool - fixed size block allocator with a free list, for objects that are created and destroyed constantly
+//
+// Blocks are carved out of large slabs and handed back to the free list on release, so a steady stream of births and
+// deaths reuses the same storage instead of going through the general purpose allocator.  Every block carries a
+// pointer to the pool that owns it, which lets Release() be called with nothing but the object's address.
+//
+// Each thread keeps its own free list for every pool it uses, so the analyze and test CPU threads allocate and release
+// without contending for a lock.  The pool's mutex is only taken to move blocks in batches between a thread's list and
+// the shared one, or to carve a new block.  A thread's blocks are returned to the shared list when it exits, through a
+// thread exit hook, or earlier by calling ReleaseThreadCaches().
+//
+// A disabled pool allocates and frees every block individually, keeping each object visible to memory checkers.
+
+class cObjectPool
+{
+private:
+  struct sFreeBlock
+  {
+    sFreeBlock* next;
+  };
+  
+  union uBlockHeader
+  {
+    cObjectPool* owner;
+    double align_double;
+    long double align_long_double;
+    void* align_ptr;
+  };
+  
+  struct sThreadCache;
+  
+  static const int THREAD_CACHE_BATCH = 32;                      // Blocks moved to or from the shared list at a time
+  static const int THREAD_CACHE_LIMIT = 2 * THREAD_CACHE_BATCH;  // Largest per-thread free list before spilling
+
+  static OBJECT_POOL_THREAD_LOCAL sThreadCache* s_thread_caches;  // Calling thread's caches, one per pool used
+  static Apto::Mutex s_id_mutex;
+  static int s_next_id;
+
+  cString m_name;
+  int m_id;                      // Unique for the life of the program, never reused by a later pool
+  mutable Apto::Mutex m_mutex;
+  size_t m_object_size;
+  size_t m_block_size;
+  int m_blocks_per_slab;
+  bool m_enabled;
+  
+  Apto::Array<char*> m_slabs;
+  char* m_slab_next;             // Untouched blocks remaining in the newest slab
+  char* m_slab_end;
+  sFreeBlock* m_free_list;       // Released blocks shared by all threads, ready to be recycled
+  int m_num_free;
+  
+  sThreadCache* m_caches;        // Caches of all threads using this pool
+  long long m_total_allocs;      // Counts from the disabled path and from caches already released
+  long long m_total_recycled;
+  long long m_total_releases;
+
+  
+  cObjectPool(); // @not_implemented
+  cObjectPool(const cObjectPool&); // @not_implemented
+  cObjectPool& operator=(const cObjectPool&); // @not_implemented
+  
+  void addSlab();
+  sThreadCache* threadCache();
+  uBlockHeader* refill(sThreadCache* cache);
+  void spill(sThreadCache* cache, int num_blocks);
+  void collectCounts(long long& allocs, long long& recycled, long long& releases, int& num_free) const;
+  
+public:
+  cObjectPool(const cString& name, size_t object_size, bool enabled = true, int blocks_per_slab = 256);
+  ~cObjectPool();
+  
+  void* Allocate(size_t size);
+  static void Release(void* ptr);
+  
+  static void ReleaseThreadCaches();
+  
+  const cString& GetName() const { return m_name; }
+  size_t GetObjectSize() const { return m_object_size; }
+  bool IsEnabled() const { return m_enabled; }
+  
+  // Statistics are summed over all threads' caches, and are only exact while no other thread is using the pool
+  int GetNumLive() const;
+  int GetNumFree() const;
+  int GetCapacity() const { return GetNumLive() + GetNumFree(); }
+  long long GetTotalAllocations() const;
+  long long GetTotalRecycled() const;
+  double GetRecycleRate() const;
+};
+
+#endif
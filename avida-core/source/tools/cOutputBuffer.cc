@@ -0,0 +1,119 @@
+/*
+ *  cOutputBuffer.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cOutputBuffer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+
+cOutputBuffer::cOutputBuffer(int capacity) : m_data(NULL), m_size(0), m_capacity(0)
+{
+  grow((capacity > 0) ? capacity : 1);
+}
+
+
+void cOutputBuffer::Append(int value)
+{
+  char digits[12];
+  int num_digits = 0;
+
+  // Work in unsigned, so that the most negative int does not overflow on negation
+  unsigned int magnitude = (value < 0) ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+  do {
+    digits[num_digits++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude);
+
+  reserve(num_digits + 1);
+  if (value < 0) m_data[m_size++] = '-';
+  while (num_digits) m_data[m_size++] = digits[--num_digits];
+}
+
+
+void cOutputBuffer::Append(double value)
+{
+  // Whole numbers below 10^6 print under %g exactly as the integer would, save for negative zero ("-0")
+  if (value == 0.0) {
+    const double positive_zero = 0.0;
+    if (memcmp(&value, &positive_zero, sizeof(double)) == 0) {
+      Append('0');
+      return;
+    }
+  } else if (value > -1000000.0 && value < 1000000.0 && value == std::floor(value)) {
+    Append(static_cast<int>(value));
+    return;
+  }
+
+  char formatted[32];
+  sprintf(formatted, "%g", value);
+  Append(formatted, static_cast<int>(strlen(formatted)));
+}
+
+
+void cOutputBuffer::Append(const cString& value)
+{
+  const char* str = value;
+  Append(str, static_cast<int>(strlen(str)));
+}
+
+
+void cOutputBuffer::Append(const char* value, int length)
+{
+  reserve(length);
+  memcpy(m_data + m_size, value, length);
+  m_size += length;
+}
+
+
+void cOutputBuffer::Append(const cFlexVar& value)
+{
+  switch (value.GetType()) {
+    case cFlexVar::TYPE_BOOL:   Append(value.AsBool()); break;
+    case cFlexVar::TYPE_INT:    Append(value.AsInt()); break;
+    case cFlexVar::TYPE_CHAR:   Append(value.AsChar()); break;
+    case cFlexVar::TYPE_DOUBLE: Append(value.AsDouble()); break;
+    case cFlexVar::TYPE_STRING: Append(value.AsString()); break;
+    default: break;
+  }
+}
+
+
+void cOutputBuffer::Write(std::ostream& out)
+{
+  if (m_size) out.write(m_data, m_size);
+  m_size = 0;
+}
+
+
+void cOutputBuffer::grow(int min_capacity)
+{
+  int capacity = (m_capacity > 0) ? m_capacity : 1;
+  while (capacity < min_capacity) capacity *= 2;
+
+  char* data = new char[capacity];
+  if (m_size) memcpy(data, m_data, m_size);
+  delete [] m_data;
+
+  m_data = data;
+  m_capacity = capacity;
+}
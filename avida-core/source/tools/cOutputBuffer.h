@@ -0,0 +1,74 @@
+/*
+ *  cOutputBuffer.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cOutputBuffer_h
+#define cOutputBuffer_h
+
+#include "cFlexVar.h"
+#include "cString.h"
+
+#include <iostream>
+
+
+// cOutputBuffer - growable character buffer for building large blocks of text output
+//
+// Values are formatted exactly as a default formatted std::ostream would print them (doubles as %g with a precision of
+// six, bools as 1 or 0, strings up to their first null), so text built here is byte for byte what streaming the same
+// values would have produced.
+
+class cOutputBuffer
+{
+private:
+  char* m_data;
+  int m_size;
+  int m_capacity;
+
+  cOutputBuffer(const cOutputBuffer&); // @not_implemented
+  cOutputBuffer& operator=(const cOutputBuffer&); // @not_implemented
+
+public:
+  explicit cOutputBuffer(int capacity = 65536);
+  ~cOutputBuffer() { delete [] m_data; }
+
+  inline int GetSize() const { return m_size; }
+  inline const char* GetData() const { return m_data; }
+  inline void Clear() { m_size = 0; }
+
+  inline void Append(char value) { reserve(1); m_data[m_size++] = value; }
+  inline void Append(bool value) { Append(value ? '1' : '0'); }
+  void Append(int value);
+  void Append(double value);
+  void Append(const cString& value);
+  void Append(const char* value, int length);
+  void Append(const cFlexVar& value);
+
+  // Any other value type is formatted through cFlexVar
+  template <class T> inline void Append(const T& value) { Append(cFlexVar(value)); }
+
+  // Writes out the contents and empties the buffer
+  void Write(std::ostream& out);
+
+private:
+  inline void reserve(int length) { if (m_size + length > m_capacity) grow(m_size + length); }
+  void grow(int min_capacity);
+};
+
+#endif
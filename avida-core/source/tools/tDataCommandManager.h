@@ -50,6 +50,12 @@ public:
   
   const Apto::Array<cString>& GetEntryNames() const { return m_entry_names; }
 
+  void SetConcurrent(const cString& name, bool concurrent)
+  {
+    tDataEntry<TargetType>* data_entry = NULL;
+    if (m_entry_dict.Get((const char*)name, data_entry)) data_entry->SetConcurrent(concurrent);
+  }
+
   tDataEntryCommand<TargetType>* GetDataCommand(const cString& cmd, cString* error_str = NULL) const
   {
     cString arg_list = cmd;
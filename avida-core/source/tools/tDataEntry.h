@@ -28,6 +28,9 @@
 #ifndef cFlexVar_h
 #include "cFlexVar.h"
 #endif
+#ifndef cOutputBuffer_h
+#include "cOutputBuffer.h"
+#endif
 #ifndef cString_h
 #include "cString.h"
 #endif
@@ -48,11 +51,13 @@ private:
   cString m_null_value;      // Value when "off", such as "0", "Inf.", or "N/A"
   cString m_html_table_flags; // String to include in <td> entry in html mode.
   cStringList m_default_args;
+  bool m_concurrent;         // Safe to read from several threads at once (no lazy recalculation of the target)
   
 public:
   tDataEntry(const cString& name, const cString& desc, int compare_type = 0,
              const cString& null = "0", const cString& html_cell = "align=center")
-  : m_name(name), m_desc(desc), m_compare_type(compare_type), m_null_value(null), m_html_table_flags(html_cell) { ; }
+  : m_name(name), m_desc(desc), m_compare_type(compare_type), m_null_value(null), m_html_table_flags(html_cell)
+  , m_concurrent(true) { ; }
   virtual ~tDataEntry() { ; }
   
   const cString& GetName() const { return m_name; }
@@ -60,10 +65,18 @@ public:
   int GetCompareType() const { return m_compare_type; }
   const cString& GetNull() const { return m_null_value; }
   const cString& GetHtmlCellFlags() const { return m_html_table_flags; }
+  bool IsConcurrent() const { return m_concurrent; }
+  void SetConcurrent(bool concurrent) { m_concurrent = concurrent; }
   
   virtual bool Set(TargetType*, const cFlexVar&, const cStringList&, const cString&) const { return false; }
   virtual cFlexVar Get(const TargetType* target, const cFlexVar& idx, const cStringList& args) const = 0;
   virtual cFlexVar Get(const TargetType* target) const { return Get(target, 0, m_default_args); }
+
+  // Formats the value straight into an output buffer; typed entries override this to skip the cFlexVar
+  virtual void Append(cOutputBuffer& buf, const TargetType* target, const cFlexVar& idx, const cStringList& args) const
+  {
+    buf.Append(Get(target, idx, args));
+  }
 };
 
 template <class TargetType, class EntryType> class tDataEntryOfType;
@@ -95,6 +108,12 @@ public:
     assert(target != NULL);
     return cFlexVar((target->*DataGet)());
   }
+
+  void Append(cOutputBuffer& buf, const TargetType* target, const cFlexVar&, const cStringList&) const
+  {
+    assert(target != NULL);
+    buf.Append((target->*DataGet)());
+  }
 };
 
 
@@ -123,6 +142,12 @@ public:
     assert(target != NULL);
     return cFlexVar((target->*DataRetrieval)(idx.As<IdxType>()));
   }
+
+  void Append(cOutputBuffer& buf, const TargetType* target, const cFlexVar& idx, const cStringList&) const
+  {
+    assert(target != NULL);
+    buf.Append((target->*DataRetrieval)(idx.As<IdxType>()));
+  }
 };
 
 
@@ -150,6 +175,12 @@ public:
     assert(target != NULL);
     return cFlexVar((target->*DataRetrieval)(idx.As<IdxType>(), args));
   }
+
+  void Append(cOutputBuffer& buf, const TargetType* target, const cFlexVar& idx, const cStringList& args) const
+  {
+    assert(target != NULL);
+    buf.Append((target->*DataRetrieval)(idx.As<IdxType>(), args));
+  }
 };
 
 
@@ -61,6 +61,8 @@ public:
   
   bool SetValue(T* target, const cString& value) const { return m_data_entry->Set(target, m_idx, m_args, value); }
   cFlexVar GetValue(const T* target) const { return m_data_entry->Get(target, m_idx, m_args); }
+  void AppendValue(cOutputBuffer& buf, const T* target) const { m_data_entry->Append(buf, target, m_idx, m_args); }
+  bool IsConcurrent() const { return m_data_entry->IsConcurrent(); }
 };
 
 #endif
@@ -0,0 +1,200 @@
+/*
+ *  tDataEntryFormatter.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef tDataEntryFormatter_h
+#define tDataEntryFormatter_h
+
+#include "apto/core.h"
+#include "apto/core/Thread.h"
+
+#include "cOutputBuffer.h"
+#include "tDataEntryCommand.h"
+#include "tList.h"
+
+#include <iostream>
+
+
+// tDataEntryFormatter - a list of data entry commands compiled into a text row formatter
+//
+// Each row is every column's value followed by a space, then a newline, matching what streaming the values through
+// GetValue() would produce.  Values go straight from the typed getters into an output buffer, and rows are written out
+// in blocks of FORMAT_CHUNK_SIZE.  When every column is safe to read concurrently, blocks may be formatted on several
+// threads at once; they are still written in order.
+
+const int FORMAT_CHUNK_SIZE = 512;
+
+
+template <class TargetType> class tDataEntryFormatter
+{
+private:
+  class FormatThread;
+  struct ChunkQueue;
+
+  Apto::Array<const tDataEntryCommand<TargetType>*> m_columns;
+  bool m_concurrent;
+
+  tDataEntryFormatter(const tDataEntryFormatter&); // @not_implemented
+  tDataEntryFormatter& operator=(const tDataEntryFormatter&); // @not_implemented
+
+public:
+  tDataEntryFormatter(tListIterator<tDataEntryCommand<TargetType> >& column_it) : m_concurrent(true)
+  {
+    column_it.Reset();
+    while (column_it.Next() != NULL) {
+      m_columns.Push(column_it.Get());
+      if (!column_it.Get()->IsConcurrent()) m_concurrent = false;
+    }
+  }
+
+  int GetNumColumns() const { return m_columns.GetSize(); }
+  bool IsConcurrent() const { return m_concurrent; }
+
+  inline void AppendRow(cOutputBuffer& buf, const TargetType* target) const
+  {
+    for (int i = 0; i < m_columns.GetSize(); i++) {
+      m_columns[i]->AppendValue(buf, target);
+      buf.Append(' ');
+    }
+    buf.Append('\n');
+  }
+
+  // Writes a row for every target, in order; num_threads only applies if every column is concurrent
+  void Write(std::ostream& out, const Apto::Array<TargetType*>& targets, int num_threads = 1) const;
+
+private:
+  void appendChunk(cOutputBuffer& buf, const Apto::Array<TargetType*>& targets, int chunk) const
+  {
+    int end = (chunk + 1) * FORMAT_CHUNK_SIZE;
+    if (end > targets.GetSize()) end = targets.GetSize();
+    for (int i = chunk * FORMAT_CHUNK_SIZE; i < end; i++) AppendRow(buf, targets[i]);
+  }
+};
+
+
+template <class TargetType> struct tDataEntryFormatter<TargetType>::ChunkQueue
+{
+  const tDataEntryFormatter<TargetType>* formatter;
+  const Apto::Array<TargetType*>* targets;
+  int num_chunks;
+  int next_chunk;       // Next chunk to be claimed by a thread
+  int num_written;      // Chunks written out so far; chunk c is held in slot c % buffers.GetSize()
+
+  Apto::Array<cOutputBuffer*> buffers;
+  Apto::Array<bool> formatted;
+
+  Apto::Mutex mutex;
+  Apto::ConditionVariable cond;
+};
+
+
+template <class TargetType> class tDataEntryFormatter<TargetType>::FormatThread : public Apto::Thread
+{
+private:
+  ChunkQueue* m_queue;
+
+  void Run()
+  {
+    ChunkQueue& queue = *m_queue;
+    const int num_slots = queue.buffers.GetSize();
+
+    queue.mutex.Lock();
+    while (true) {
+      // Stay at most one window of slots ahead of the writer
+      while (queue.next_chunk < queue.num_chunks && queue.next_chunk >= queue.num_written + num_slots) {
+        queue.cond.Wait(queue.mutex);
+      }
+      if (queue.next_chunk >= queue.num_chunks) break;
+      const int chunk = queue.next_chunk++;
+      queue.mutex.Unlock();
+
+      queue.formatter->appendChunk(*queue.buffers[chunk % num_slots], *queue.targets, chunk);
+
+      queue.mutex.Lock();
+      queue.formatted[chunk % num_slots] = true;
+      queue.cond.Broadcast();
+    }
+    queue.mutex.Unlock();
+  }
+
+public:
+  FormatThread(ChunkQueue* queue) : m_queue(queue) { ; }
+};
+
+
+template <class TargetType>
+void tDataEntryFormatter<TargetType>::Write(std::ostream& out, const Apto::Array<TargetType*>& targets,
+                                            int num_threads) const
+{
+  const int num_chunks = (targets.GetSize() + FORMAT_CHUNK_SIZE - 1) / FORMAT_CHUNK_SIZE;
+  if (!m_concurrent || num_threads > num_chunks) num_threads = (m_concurrent) ? num_chunks : 1;
+
+  if (num_threads <= 1) {
+    cOutputBuffer buf;
+    for (int chunk = 0; chunk < num_chunks; chunk++) {
+      appendChunk(buf, targets, chunk);
+      buf.Write(out);
+    }
+    return;
+  }
+
+  ChunkQueue queue;
+  queue.formatter = this;
+  queue.targets = &targets;
+  queue.num_chunks = num_chunks;
+  queue.next_chunk = 0;
+  queue.num_written = 0;
+  queue.buffers.Resize(2 * num_threads);
+  queue.formatted.Resize(2 * num_threads);
+  for (int i = 0; i < queue.buffers.GetSize(); i++) {
+    queue.buffers[i] = new cOutputBuffer;
+    queue.formatted[i] = false;
+  }
+
+  Apto::Array<FormatThread*> threads(num_threads);
+  for (int i = 0; i < threads.GetSize(); i++) {
+    threads[i] = new FormatThread(&queue);
+    threads[i]->Start();
+  }
+
+  // Write each chunk as soon as it is ready, freeing its slot for the chunk one window later
+  for (int chunk = 0; chunk < num_chunks; chunk++) {
+    const int slot = chunk % queue.buffers.GetSize();
+    queue.mutex.Lock();
+    while (!queue.formatted[slot]) queue.cond.Wait(queue.mutex);
+    queue.mutex.Unlock();
+
+    queue.buffers[slot]->Write(out);
+
+    queue.mutex.Lock();
+    queue.formatted[slot] = false;
+    queue.num_written++;
+    queue.cond.Broadcast();
+    queue.mutex.Unlock();
+  }
+
+  for (int i = 0; i < threads.GetSize(); i++) {
+    threads[i]->Join();
+    delete threads[i];
+  }
+  for (int i = 0; i < queue.buffers.GetSize(); i++) delete queue.buffers[i];
+}
+
+#endif
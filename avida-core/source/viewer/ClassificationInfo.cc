@@ -56,8 +56,9 @@ Avida::Viewer::ClassificationInfo::ClassificationInfo(World* in_world, const Sys
 }
 
 
-void Avida::Viewer::ClassificationInfo::Update()
+bool Avida::Viewer::ClassificationInfo::Update()
 {
+  bool changed = false;
   const int num_colors = m_color_chart_id.GetSize();
   cBitArray free_color(num_colors);   // Keep track of genotypes still using their color.
   free_color.SetAll();
@@ -78,7 +79,10 @@ void Avida::Viewer::ClassificationInfo::Update()
 
   // Clear out colors for genotypes below threshold.
   while (it->Next()) {
-    if (MapColorOf(it->Get())->color >= 0) MapColorOf(it->Get())->color = -1;
+    if (MapColorOf(it->Get())->color >= 0) {
+      MapColorOf(it->Get())->color = -1;
+      changed = true;
+    }
   }
 
   // Setup genotypes above threshold.
@@ -95,9 +99,12 @@ void Avida::Viewer::ClassificationInfo::Update()
       m_color_chart_ptr[new_color] = it->Get();
       free_color[new_color] = false;
       MapColorOf(it->Get())->color = new_color;
+      changed = true;
     }
     count++;
   }
+  
+  return changed;
 }
 
 
@@ -454,11 +454,14 @@ void Avida::Viewer::Driver::Run()
       }
       
       m_mutex.Lock();
+      Map* idle_map = (m_pause_state != DRIVER_UNPAUSED) ? m_map : NULL;
+      if (idle_map) idle_map->BeginIdle(population);
       while (!m_done && m_pause_state != DRIVER_UNPAUSED) {
         m_paused = true;
         m_pause_cv.Wait(m_mutex);
       }
       m_paused = false;
+      if (idle_map) idle_map->EndIdle();
     }
     m_mutex.Unlock();
   } catch (Avida::AbortCondition condition) {
@@ -57,6 +57,8 @@ private:
   Apto::Array<int> m_color_grid;
   Apto::Array<int> m_color_count;
   Apto::Array<DiscreteScale::Entry> m_scale_labels;
+  Apto::Array<double> m_prop_values;
+  cOrganism::PropertyAccessor m_accessor;
   
   double m_cur_min;
   double m_cur_max;
@@ -67,6 +69,7 @@ private:
 public:
   DoublePropMapMode(cWorld* world, const Apto::String& prop_id, const Apto::String& prop_desc)
   : m_prop_id(prop_id), m_prop_desc(prop_desc), m_color_count(SCALE_MAX + Avida::Viewer::MAP_RESERVED_COLORS), m_scale_labels(SCALE_LABELS)
+  , m_accessor(cOrganism::ResolveProperty(prop_id))
   , m_cur_min(0.0), m_cur_max(0.0), m_target_max(0.0), m_rescale_rate_min(0.0), m_rescale_rate_max(0.0)
   {
     m_color_grid.Resize(world->GetPopulation().GetSize());
@@ -93,12 +96,22 @@ public:
   Apto::String GetProperty(const Apto::String&) const { return ""; }
   
   void Update(cPopulation& pop);
+  void UpdateCells(cPopulation& pop, const Apto::Array<int>& changed_cells);
   
   
   // DiscreteScale Interface
   int GetScaleRange() const { return m_color_count.GetSize() - Avida::Viewer::MAP_RESERVED_COLORS; }
   int GetNumLabeledEntries() const { return m_scale_labels.GetSize(); }
   DiscreteScale::Entry GetEntry(int index) const { return m_scale_labels[index]; }
+  
+private:
+  bool updateScale();
+  void recolorAll(cPopulation& pop);
+  int colorOf(cPopulation& pop, int cell_id) const;
+  static inline int countIndex(int color)
+  {
+    return (color < 0) ? (Avida::Viewer::MAP_RESERVED_COLORS - color) : (color + Avida::Viewer::MAP_RESERVED_COLORS);
+  }
 };
 
 const double DoublePropMapMode::RESCALE_TOLERANCE = 0.1;
@@ -106,19 +119,47 @@ const double DoublePropMapMode::MAX_RESCALE_FACTOR = 0.03;
 
 void DoublePropMapMode::Update(cPopulation& pop)
 {
-  m_color_grid.Resize(pop.GetSize());
+  pop.GatherOrganismProperty(m_prop_id, m_prop_values);
+  updateScale();
+  recolorAll(pop);
+}
+
+void DoublePropMapMode::UpdateCells(cPopulation& pop, const Apto::Array<int>& changed_cells)
+{
+  if (m_prop_values.GetSize() != pop.GetSize()) {
+    Update(pop);
+    return;
+  }
   
-  // Keep track of how many times each color was assigned.
-  m_color_count.SetAll(0);
+  for (int i = 0; i < changed_cells.GetSize(); i++) {
+    cOrganism* org = pop.GetCell(changed_cells[i]).GetOrganism();
+    m_prop_values[changed_cells[i]] = (org) ? m_accessor.DoubleValue(org) : 0.0;
+  }
+  
+  // A scale change shifts the color of every cell, otherwise only the changed cells need new colors
+  if (updateScale()) {
+    recolorAll(pop);
+    return;
+  }
+  
+  for (int i = 0; i < changed_cells.GetSize(); i++) {
+    const int cell_id = changed_cells[i];
+    m_color_count[countIndex(m_color_grid[cell_id])]--;
+    m_color_grid[cell_id] = colorOf(pop, cell_id);
+    m_color_count[countIndex(m_color_grid[cell_id])]++;
+  }
+}
+
+bool DoublePropMapMode::updateScale()
+{
+  const double prev_max = m_cur_max;
   
   // Determine the max and min in the population.
   double max_fit = 0.0;
   double min_fit = 0.0;
   
-  for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) continue;
-    double fit = org->Properties().Get(m_prop_id);
+  for (int i = 0; i < m_prop_values.GetSize(); i++) {
+    double fit = m_prop_values[i];
     if (fit == 0.0) continue;
     if (fit > max_fit) max_fit = fit;
     if (fit < min_fit) min_fit = fit;
@@ -165,36 +206,37 @@ void DoublePropMapMode::Update(cPopulation& pop)
     }
   }
   
-  // Now fill out the color grid.
+  return m_cur_max != prev_max;
+}
+
+void DoublePropMapMode::recolorAll(cPopulation& pop)
+{
+  m_color_grid.Resize(pop.GetSize());
+  
+  // Keep track of how many times each color was assigned.
+  m_color_count.SetAll(0);
+  
   for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) {
-      m_color_grid[i] = Avida::Viewer::MAP_RESERVED_COLOR_BLACK;
-      m_color_count[Avida::Viewer::MAP_RESERVED_COLORS - Avida::Viewer::MAP_RESERVED_COLOR_BLACK]++;
-      continue;
-    }
-    
-    double fit = org->Properties().Get(m_prop_id);
-    if (fit == 0.0) {
-      m_color_grid[i] = Avida::Viewer::MAP_RESERVED_COLOR_DARK_GRAY;
-      m_color_count[Avida::Viewer::MAP_RESERVED_COLORS - Avida::Viewer::MAP_RESERVED_COLOR_DARK_GRAY]++;
-      continue;
-    }
-    
-    //    fit = log2(fit);
-    
-    fit = (fit - m_cur_min) / (m_cur_max - m_cur_min);
-    if (fit > 1.0) {
-      m_color_grid[i] = Avida::Viewer::MAP_RESERVED_COLOR_WHITE;
-      m_color_count[Avida::Viewer::MAP_RESERVED_COLORS - Avida::Viewer::MAP_RESERVED_COLOR_WHITE]++;
-    } else {
-      int color = fit * static_cast<double>(SCALE_MAX - 1);
-      m_color_grid[i] = color;
-      m_color_count[color + Avida::Viewer::MAP_RESERVED_COLORS]++;
-    }
+    m_color_grid[i] = colorOf(pop, i);
+    m_color_count[countIndex(m_color_grid[i])]++;
   }
 }
 
+int DoublePropMapMode::colorOf(cPopulation& pop, int cell_id) const
+{
+  if (!pop.GetCell(cell_id).IsOccupied()) return Avida::Viewer::MAP_RESERVED_COLOR_BLACK;
+  
+  double fit = m_prop_values[cell_id];
+  if (fit == 0.0) return Avida::Viewer::MAP_RESERVED_COLOR_DARK_GRAY;
+  
+  //    fit = log2(fit);
+  
+  fit = (fit - m_cur_min) / (m_cur_max - m_cur_min);
+  if (fit > 1.0) return Avida::Viewer::MAP_RESERVED_COLOR_WHITE;
+  
+  return fit * static_cast<double>(SCALE_MAX - 1);
+}
+
 const Apto::String& DoublePropMapMode::GetScaleLabel() const
 {  
   if (m_rescale_rate_max != 0) return m_prop_desc_rescale;
@@ -240,6 +282,7 @@ public:
   Apto::String GetProperty(const Apto::String&) const { return ""; }
   
   void Update(cPopulation& pop);
+  void UpdateCells(cPopulation& pop, const Apto::Array<int>& changed_cells);
   
   
   // DiscreteScale Interface
@@ -247,6 +290,11 @@ public:
   int GetNumLabeledEntries() const { return m_scale_labels.GetSize(); }
   DiscreteScale::Entry GetEntry(int index) const { return m_scale_labels[index]; }
   bool IsCategorical() const { return true; }
+  
+private:
+  void recolorAll(cPopulation& pop);
+  int colorOf(cPopulation& pop, int cell_id);
+  void clearUnusedLabels();
 };
 
 ClassificationMapMode::ClassificationMapMode(cWorld* world, const Apto::String& role_id, const Apto::String& role_desc)
@@ -271,28 +319,55 @@ ClassificationMapMode::ClassificationMapMode(cWorld* world, const Apto::String&
 void ClassificationMapMode::Update(cPopulation& pop)
 {
   m_info->Update();
+  recolorAll(pop);
+}
+
+void ClassificationMapMode::UpdateCells(cPopulation& pop, const Apto::Array<int>& changed_cells)
+{
+  // Reassigned group colors affect cells that did not change themselves, so fall back to a full pass
+  if (m_info->Update() || m_color_grid.GetSize() != pop.GetSize()) {
+    recolorAll(pop);
+    return;
+  }
+  
+  for (int i = 0; i < changed_cells.GetSize(); i++) {
+    const int cell_id = changed_cells[i];
+    m_color_count[m_color_grid[cell_id] + 4]--;
+    m_color_grid[cell_id] = colorOf(pop, cell_id);
+    m_color_count[m_color_grid[cell_id] + 4]++;
+  }
+  clearUnusedLabels();
+}
+
+void ClassificationMapMode::recolorAll(cPopulation& pop)
+{
   m_color_grid.Resize(pop.GetSize());
   m_color_count.SetAll(0);            // reset all color counts
   for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) {
-      m_color_grid[i] = -4;
-      m_color_count[0]++;
-    } else {
-      Systematics::GroupPtr bg = org->SystematicsGroup(m_role_id);
-      if (bg) {
-        Avida::Viewer::ClassificationInfo::MapColorPtr mapcolor = bg->GetData<Avida::Viewer::ClassificationInfo::MapColor>();
-        if (mapcolor) {
-          m_color_grid[i] = mapcolor->color;
-          m_color_count[mapcolor->color + 4]++;
-          m_scale_labels[mapcolor->color + 4].label = bg->Properties().Get("name").StringValue();
-          continue;
-        }
-      }
-      m_color_grid[i] = -1;
-      m_color_count[3]++;
+    m_color_grid[i] = colorOf(pop, i);
+    m_color_count[m_color_grid[i] + 4]++;
+  }
+  clearUnusedLabels();
+}
+
+int ClassificationMapMode::colorOf(cPopulation& pop, int cell_id)
+{
+  cOrganism* org = pop.GetCell(cell_id).GetOrganism();
+  if (org == NULL) return -4;
+  
+  Systematics::GroupPtr bg = org->SystematicsGroup(m_role_id);
+  if (bg) {
+    Avida::Viewer::ClassificationInfo::MapColorPtr mapcolor = bg->GetData<Avida::Viewer::ClassificationInfo::MapColor>();
+    if (mapcolor) {
+      m_scale_labels[mapcolor->color + 4].label = bg->Properties().Get("name").StringValue();
+      return mapcolor->color;
     }
   }
+  return -1;
+}
+
+void ClassificationMapMode::clearUnusedLabels()
+{
   for (int i = 0; i < m_color_count.GetSize(); i++) if (m_color_count[i] == 0) m_scale_labels[i].label = "-";
 }
 
@@ -332,6 +407,7 @@ public:
   Apto::String GetProperty(const Apto::String& property) const;
   
   void Update(cPopulation& pop);
+  void UpdateCells(cPopulation& pop, const Apto::Array<int>& changed_cells);
   
   
   // DiscreteScale Interface
@@ -341,6 +417,7 @@ public:
   
   
 private:
+  void updateCellActions(cAvidaContext& ctx, cPopulation& pop, int cell_id);
   void updateTagStates();
 };
 
@@ -409,31 +486,47 @@ void EnvActionMapMode::Update(cPopulation& pop)
   m_action_grid.Resize(pop.GetSize());
   m_raw_action_counts.Resize(pop.GetSize());
   for (int i = 0; i < m_raw_action_counts.GetSize(); i++) m_raw_action_counts[i].Resize(m_action_ids.GetSize());
-  m_action_counts.SetAll(0);            // reset all color counts
   
-  for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) {
-      m_raw_action_counts[i].SetAll(0);
-    } else {
-      for (int task_id = 0; task_id < m_action_ids.GetSize(); task_id++) {
-//        if (org->GetPhenotype().GetLastTaskCount()[task_id] > 0) m_raw_action_counts[i][task_id] = 1;
-//        else if (org->GetPhenotype().GetCurTaskCount()[task_id] > 0) m_raw_action_counts[i][task_id] = 2;
-        Systematics::GroupPtr genotype = org->SystematicsGroup("genotype");
-        Systematics::GenomeTestMetricsPtr metrics(Systematics::GenomeTestMetrics::GetMetrics(m_world, ctx, genotype));
-        const Apto::Array<int>& task_counts = metrics->GetTaskCounts();
-        if (task_counts[task_id] > 0) m_raw_action_counts[i][task_id] = 1;
-        else m_raw_action_counts[i][task_id] = 0;
-      }
-    }
+  for (int i = 0; i < pop.GetSize(); i++) updateCellActions(ctx, pop, i);
+  
+  updateTagStates();
+}
+
+void EnvActionMapMode::UpdateCells(cPopulation& pop, const Apto::Array<int>& changed_cells)
+{
+  if (m_raw_action_counts.GetSize() != pop.GetSize()) {
+    Update(pop);
+    return;
   }
   
+  cAvidaContext ctx(&m_world->GetDriver(), m_world->GetRandom());
+  for (int i = 0; i < changed_cells.GetSize(); i++) updateCellActions(ctx, pop, changed_cells[i]);
+  
   updateTagStates();
 }
 
+void EnvActionMapMode::updateCellActions(cAvidaContext& ctx, cPopulation& pop, int cell_id)
+{
+  cOrganism* org = pop.GetCell(cell_id).GetOrganism();
+  if (org == NULL) {
+    m_raw_action_counts[cell_id].SetAll(0);
+    return;
+  }
+  
+//  if (org->GetPhenotype().GetLastTaskCount()[task_id] > 0) m_raw_action_counts[cell_id][task_id] = 1;
+//  else if (org->GetPhenotype().GetCurTaskCount()[task_id] > 0) m_raw_action_counts[cell_id][task_id] = 2;
+  Systematics::GroupPtr genotype = org->SystematicsGroup("genotype");
+  Systematics::GenomeTestMetricsPtr metrics(Systematics::GenomeTestMetrics::GetMetrics(m_world, ctx, genotype));
+  const Apto::Array<int>& task_counts = metrics->GetTaskCounts();
+  for (int task_id = 0; task_id < m_action_ids.GetSize(); task_id++) {
+    m_raw_action_counts[cell_id][task_id] = (task_counts[task_id] > 0) ? 1 : 0;
+  }
+}
+
 
 void EnvActionMapMode::updateTagStates()
 {
+  m_action_counts.SetAll(0);            // reset all color counts
   if (m_num_enabled == 0) {
     m_action_grid.SetAll(-4);
     return;
@@ -458,9 +551,11 @@ void EnvActionMapMode::updateTagStates()
 
 
 Avida::Viewer::Map::Map(cWorld* world)
-  : m_width(world->GetPopulation().GetWorldX())
+  : m_world(world)
+  , m_width(world->GetPopulation().GetWorldX())
   , m_height(world->GetPopulation().GetWorldY())
   , m_num_viewer_colors(-1)
+  , m_idle_pop(NULL)
   , m_color_mode(0)
   , m_symbol_mode(-1)
   , m_tag_mode(4)
@@ -473,6 +568,13 @@ Avida::Viewer::Map::Map(cWorld* world)
   m_view_modes[2] = new DoublePropMapMode(world, "last_metabolic_rate", "Metabolic Rate");
   m_view_modes[3] = new ClassificationMapMode(world, "clade", "Ancestor Organism");
   m_view_modes[4] = new EnvActionMapMode(world);
+  
+  // Every mode starts out needing a full update; afterwards bound modes only revisit the cells that changed
+  m_mode_stale.Resize(m_view_modes.GetSize());
+  m_mode_stale.SetAll(true);
+  world->GetPopulation().SetCellChangeTracking(true);
+  
+  for (int i = 0; i < m_view_modes.GetSize(); i++) if (isBound(i)) publishMode(i);
 
   
 //  AddViewMode("Genome Length",  &cViewer_Map::SetColors_Length,   VIEW_COLOR, COLORS_SCALE);
@@ -494,37 +596,110 @@ Avida::Viewer::Map::Map(cWorld* world)
 
 Avida::Viewer::Map::~Map()
 {
+  m_world->GetPopulation().SetCellChangeTracking(false);
   for (int i = 0; i < m_view_modes.GetSize(); i++) delete m_view_modes[i];
 }
 
 bool Avida::Viewer::Map::SetModeProperty(int idx, const Apto::String& property, const Apto::String& value)
 {
-  m_rw_lock.WriteLock();
+  m_update_mutex.Lock();
   bool rval = m_view_modes[idx]->SetProperty(property, value);
-  m_rw_lock.WriteUnlock();
+  if (rval && isBound(idx)) {
+    m_rw_lock.WriteLock();
+    publishMode(idx);
+    m_rw_lock.WriteUnlock();
+  }
+  m_update_mutex.Unlock();
   return rval;
 }
 
 void Avida::Viewer::Map::UpdateMaps(cPopulation& pop)
 {
-  m_rw_lock.WriteLock();
+  m_update_mutex.Lock();
+  
+  // Recompute outside of the snapshot lock so that the UI is never blocked on mode updates
+  const Apto::Array<int>& changed_cells = pop.GetChangedCells();
+  for (int i = 0; i < m_view_modes.GetSize(); i++) {
+    if (!isBound(i)) {
+      m_mode_stale[i] = true;
+    } else if (m_mode_stale[i]) {
+      m_view_modes[i]->Update(pop);
+      m_mode_stale[i] = false;
+    } else {
+      m_view_modes[i]->UpdateCells(pop, changed_cells);
+    }
+  }
+  pop.ClearChangedCells();
   
+  m_rw_lock.WriteLock();
   m_width = pop.GetWorldX();
   m_height = pop.GetWorldY();
-  
-  for (int i = 0; i < m_view_modes.GetSize(); i++) m_view_modes[i]->Update(pop);
-  
+  for (int i = 0; i < m_view_modes.GetSize(); i++) if (isBound(i)) publishMode(i);
   m_rw_lock.WriteUnlock();
+  
+  m_update_mutex.Unlock();
+}
+
+
+void Avida::Viewer::Map::BeginIdle(cPopulation& pop)
+{
+  m_update_mutex.Lock();
+  m_idle_pop = &pop;
+  m_update_mutex.Unlock();
+}
+
+void Avida::Viewer::Map::EndIdle()
+{
+  m_update_mutex.Lock();
+  m_idle_pop = NULL;
+  m_update_mutex.Unlock();
 }
 
 
 void Avida::Viewer::Map::SetMode(int mode)
 {
+  m_update_mutex.Lock();
+  
   int type = m_view_modes[mode]->GetSupportedTypes();
   if (type == MAP_GRID_VIEW_COLOR) m_color_mode = mode;
   else if (type == MAP_GRID_VIEW_SYMBOLS) m_symbol_mode = mode;
   else if (type == MAP_GRID_VIEW_TAGS) m_tag_mode = mode;
   else assert(false);
+  
+  // While the driver is paused the population is stable, so a newly bound mode can be brought current right away.
+  // Otherwise it is refreshed in full on the next update.
+  if (m_mode_stale[mode] && m_idle_pop) {
+    m_view_modes[mode]->Update(*m_idle_pop);
+    m_mode_stale[mode] = false;
+  }
+  
+  m_rw_lock.WriteLock();
+  publishMode(mode);
+  m_rw_lock.WriteUnlock();
+  
+  m_update_mutex.Unlock();
+}
+
+
+void Avida::Viewer::Map::publishMode(int mode)
+{
+  if (mode == m_color_mode) m_colors.Capture(*m_view_modes[mode]);
+  if (mode == m_symbol_mode) m_symbols.Capture(*m_view_modes[mode]);
+  if (mode == m_tag_mode) m_tags.Capture(*m_view_modes[mode]);
+}
+
+
+void Avida::Viewer::Map::Snapshot::Capture(const MapMode& mode)
+{
+  grid = mode.GetGridValues();
+  counts = mode.GetValueCounts();
+  label = mode.GetScaleLabel();
+  
+  const DiscreteScale& scale = mode.GetScale();
+  range = scale.GetScaleRange();
+  categorical = scale.IsCategorical();
+  entries.Resize(scale.GetNumLabeledEntries());
+  for (int i = 0; i < entries.GetSize(); i++) entries[i] = scale.GetEntry(i);
 }
 
 
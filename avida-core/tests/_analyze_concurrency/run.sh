@@ -0,0 +1,36 @@
+#!/bin/sh
+# Shared driver for the analyze concurrency tests (analyze_*_concurrency).
+#
+# usage: run.sh <avida> <thread setting> <serial value> <threaded value>
+#
+# Copies in the config files shared by the tests (a test's own config files take precedence), then runs the test's
+# analyze.cfg twice from the same seed: with the thread setting at the serial value, writing under data/serial, and at
+# the threaded value, writing under data/threaded.  analyze.cfg reads the output directory from ANALYZE_OPTION_1.
+# data/compare.txt is then "same" if every file under data/serial matches its counterpart under data/threaded,
+# ignoring comment lines (which carry time stamps), and "differ" otherwise.  A test with its own check.sh also has it
+# run on data/serial, with its output written to data/check.txt.
+
+app="$1"
+setting="$2"
+shared=$(dirname "$0")
+
+for f in "$shared"/*.cfg; do
+  [ -f "$(basename "$f")" ] || cp "$f" . || exit 1
+done
+
+"$app" -a -set RANDOM_SEED 100 -set "$setting" "$3" -set ANALYZE_OPTION_1 serial || exit 1
+"$app" -a -set RANDOM_SEED 100 -set "$setting" "$4" -set ANALYZE_OPTION_1 threaded || exit 1
+
+result=same
+[ -d data/serial ] || result=differ
+for f in $(cd data/serial 2>/dev/null && find . -type f | sort); do
+  [ -f "data/threaded/$f" ] || { result=differ; continue; }
+  grep -v '^#' "data/serial/$f" > compare-a.tmp
+  grep -v '^#' "data/threaded/$f" > compare-b.tmp
+  cmp -s compare-a.tmp compare-b.tmp || result=differ
+done
+rm -f compare-a.tmp compare-b.tmp
+echo $result > data/compare.txt
+
+[ -f check.sh ] && { sh check.sh data/serial > data/check.txt || exit 1; }
+exit 0
@@ -0,0 +1,40 @@
+#!/bin/sh
+# Runs a variant of another consistency test against that test's recorded output, so that the variant needs no copy
+# of either.
+#
+# usage: run.sh <reference test dir> <avida> [avida arguments...]
+#
+# Copies in the reference test's config (the variant's own config files take precedence), runs avida with the given
+# arguments, then compares every file under the reference test's expected directory with this run's output the way
+# the test runner does: ignoring leading white space, blank lines and comment lines (and .gitignore files).  compare.txt is then "same", or
+# "differ" followed by the files that did not match.
+
+ref="$1"
+app="$2"
+shift 2
+
+(cd "$ref/config" && find . -type f) | while read f; do
+  [ -f "$f" ] || { mkdir -p "$(dirname "$f")" && cp "$ref/config/$f" "$f"; } || exit 1
+done || exit 1
+
+"$app" "$@" || exit 1
+
+strip() { sed -e 's/^[ 	]*//' -e '/^#/d' -e '/^$/d' "$1"; }
+
+: > compare-files.tmp
+for f in $(cd "$ref/expected" && find . -type f ! -name .gitignore | sort); do
+  if [ -f "$f" ]; then
+    strip "$ref/expected/$f" > compare-a.tmp
+    strip "$f" > compare-b.tmp
+    cmp -s compare-a.tmp compare-b.tmp || echo "$f" >> compare-files.tmp
+  else
+    echo "$f" >> compare-files.tmp
+  fi
+done
+
+if [ -s compare-files.tmp ]; then
+  { echo differ; cat compare-files.tmp; } > compare.txt
+else
+  echo same > compare.txt
+fi
+rm -f compare-a.tmp compare-b.tmp compare-files.tmp
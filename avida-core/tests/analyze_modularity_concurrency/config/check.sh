@@ -0,0 +1,164 @@
+#!/bin/sh
+# Checks the modularity statistics written under the given output directory against values worked out here from the
+# knockouts that MAP_TASKS printed for each genotype (phenotype/tasksites.<name>.dat).  reference.dat is functional
+# modularity from CALC_FUNCTIONAL_MODULARITY's own knockouts, reference_cached.dat the same statistics from the task
+# sites MAP_TASKS kept, and analyze_modularity.dat is ANALYZE_MODULARITY over the nine tasks.  Prints "match", or
+# each value that differs.
+#
+# usage: check.sh <output directory>
+
+awk -v dir="$1" '
+function fail(what, got, want)
+{
+  print what ": " got " (expected " want ")"
+  bad = 1
+}
+
+function check(what, got, want,   d)
+{
+  if (want == "nan") {
+    if (got !~ /nan/) fail(what, got, want)
+    return
+  }
+  d = got - want
+  if (d < 0) d = -d
+  if (d > 0.0001 * (want < 0 ? -want : want) + 0.0001) fail(what, got, want)
+}
+
+# Reads the base genotype and its knockouts from the MAP_TASKS output: "-1 <batch> <id> <fitness> <tasks...>" for the
+# base, then "<line> <symbol> <inst> <fitness> <tasks...>" for each site.
+function load(name,   f, line, n, fld, t)
+{
+  f = dir "/phenotype/tasksites." name ".dat"
+  len = 0
+  while ((getline line < f) > 0) {
+    n = split(line, fld, " ")
+    if (n != 4 + NUM_TASKS || line ~ /^#/) continue
+    if (fld[1] == -1) {
+      base_fit = fld[4] + 0
+      for (t = 0; t < NUM_TASKS; t++) base[t] = fld[5 + t] + 0
+    } else {
+      ko_fit[len] = fld[4] + 0
+      for (t = 0; t < NUM_TASKS; t++) ko[len, t] = fld[5 + t] + 0
+      len++
+    }
+  }
+  close(f)
+  if (len == 0) fail(name, "no knockouts", f)
+}
+
+# Functional modularity as CALC_FUNCTIONAL_MODULARITY defines it: a site belongs to a task if its knockout still
+# reproduces but no longer does a task the base genotype does.
+function functional(name, fld, label,   t, i, does, n, first, last, pos, total_task, total_inst, total_all, cnt, inv, k)
+{
+  load(name)
+  check(label " " name " length", fld[2], len)
+
+  does = 0
+  for (t = 0; t < NUM_TASKS; t++) if (base[t] > 0) does = 1
+  if (!(base_fit > 0 && does)) {
+    for (k = 3; k <= NUM_FIELDS; k++) check(label " " name " field " k, fld[k], 0)
+    return
+  }
+
+  for (i = 0; i < len; i++) cnt[i] = 0
+  total_task = total_inst = total_all = 0
+  for (t = 0; t < NUM_TASKS; t++) {
+    n = 0; pos = 0; first = -1; last = -1
+    for (i = 0; i < len; i++) {
+      if (ko_fit[i] > 0 && base[t] > 0 && ko[i, t] == 0) {
+        n++; pos += i; cnt[i]++
+        if (first < 0) first = i
+        last = i
+      }
+    }
+    total_all += n
+    if (n) total_task++
+    check(label " " name " sites_per_task." t, fld[8 + t], n)
+    check(label " " name " task_length." t, fld[21 + t], n ? last - first + 1 : 0)
+    check(label " " name " ave_task_position." t, fld[30 + t], n ? pos / n : "nan")
+  }
+  for (k = 0; k < 4; k++) inv[k] = 0
+  for (i = 0; i < len; i++) {
+    if (cnt[i] < 4) inv[cnt[i]]++
+    if (cnt[i]) total_inst++
+  }
+  for (k = 0; k < 4; k++) check(label " " name " sites_inv_x_tasks." k, fld[17 + k], inv[k])
+
+  check(label " " name " tasks_done", fld[3], total_task)
+  check(label " " name " insts_tasks", fld[4], total_inst)
+  check(label " " name " tasks_prop", fld[5], total_inst / len)
+  check(label " " name " ave_tasks_per_site", fld[6], total_inst ? total_all / total_inst : 0)
+  check(label " " name " ave_sites_per_task", fld[7], total_task ? total_all / total_task : 0)
+}
+
+# Physical modularity as ANALYZE_MODULARITY defines it: a site belongs to a task if its knockout still reproduces but
+# does the task fewer times; PM is one less the mean circular distance between a task'"'"'s sites over the length.
+function physical(name, fld,   t, i, j, n, sites, dist, pairs, d, traits, site_count, ave_dist, undefined)
+{
+  load(name)
+  traits = site_count = ave_dist = 0
+  undefined = 0
+  for (t = 0; t < NUM_TASKS; t++) {
+    n = 0
+    for (i = 0; i < len; i++) if (ko_fit[i] != 0 && ko[i, t] < base[t]) sites[n++] = i
+    if (n == 0) continue
+    traits++
+    site_count += n
+    dist = pairs = 0
+    for (i = 0; i < n; i++) {
+      for (j = i + 1; j < n; j++) {
+        d = sites[j] - sites[i]
+        if (2 * d > len) d = len - d
+        dist += d
+        pairs++
+      }
+    }
+    if (pairs) ave_dist += dist / pairs
+    else undefined = 1
+  }
+  check("analyze_modularity " name " trait_count", fld[2], traits)
+  check("analyze_modularity " name " length", fld[4], len)
+  check("analyze_modularity " name " ave_sites", fld[3], traits ? site_count / traits : "nan")
+  check("analyze_modularity " name " ave_dist", fld[5], undefined ? "nan" : ave_dist)
+  check("analyze_modularity " name " PM", fld[1], (undefined || !traits) ? "nan" : 1 - ave_dist / (len * traits))
+}
+
+function rows(f, out,   line, n)
+{
+  n = 0
+  while ((getline line < f) > 0) {
+    if (line ~ /^#/ || line ~ /^[ \t]*$/) continue
+    out[n++] = line
+  }
+  close(f)
+  return n
+}
+
+BEGIN {
+  NUM_TASKS = 9
+  NUM_FIELDS = 38
+  bad = 0
+
+  n = rows(dir "/reference.dat", ref)
+  if (n == 0) fail("reference.dat", "no genotypes", "3")
+  for (r = 0; r < n; r++) {
+    if (split(ref[r], fld, " ") != NUM_FIELDS) fail("reference.dat row " r, "wrong column count", NUM_FIELDS)
+    names[r] = fld[1]
+    functional(fld[1], fld, "reference")
+  }
+
+  if (rows(dir "/reference_cached.dat", cached) != n) fail("reference_cached.dat", "wrong row count", n)
+  for (r = 0; r < n; r++) {
+    if (split(cached[r], fld, " ") != NUM_FIELDS) fail("reference_cached.dat row " r, "wrong column count", NUM_FIELDS)
+    functional(fld[1], fld, "reference_cached")
+  }
+
+  if (rows(dir "/analyze_modularity.dat", am) != n) fail("analyze_modularity.dat", "wrong row count", n)
+  for (r = 0; r < n; r++) {
+    if (split(am[r], fld, " ") != 5) fail("analyze_modularity.dat row " r, "wrong column count", 5)
+    physical(names[r], fld)
+  }
+
+  if (!bad) print "match"
+}'